@@ -0,0 +1,91 @@
+#include "allocation_counter.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+	std::atomic<std::size_t> allocation_count{0};
+
+	void* counted(std::size_t const size) {
+		allocation_count.fetch_add(1, std::memory_order_relaxed);
+		if (auto* p = std::malloc(size == 0 ? 1 : size)) {
+			return p;
+		}
+		throw std::bad_alloc();
+	}
+
+	void* counted(std::size_t const size, std::align_val_t const alignment) {
+		allocation_count.fetch_add(1, std::memory_order_relaxed);
+		auto const align = static_cast<std::size_t>(alignment);
+		//aligned_alloc wants a multiple of the alignment.
+		if (auto* p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+			return p;
+		}
+		throw std::bad_alloc();
+	}
+} // namespace
+
+void* operator new(std::size_t const size) {
+	return counted(size);
+}
+
+void* operator new[](std::size_t const size) {
+	return counted(size);
+}
+
+void* operator new(std::size_t const size, std::align_val_t const alignment) {
+	return counted(size, alignment);
+}
+
+void* operator new[](std::size_t const size, std::align_val_t const alignment) {
+	return counted(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+namespace comp6771::benchmarks {
+	std::size_t allocations() noexcept {
+		return allocation_count.load(std::memory_order_relaxed);
+	}
+
+	void dimension_sizes(benchmark::internal::Benchmark* b) {
+		b->RangeMultiplier(10)->Range(2, 10'000'000);
+	}
+
+	void record(benchmark::State& state, std::size_t const allocations_before, std::size_t const bytes_per_iteration) {
+		state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes_per_iteration));
+		state.counters["allocations"] = benchmark::Counter(static_cast<double>(allocations() - allocations_before),
+		                                                   benchmark::Counter::kAvgIterations);
+	}
+} // namespace comp6771::benchmarks
@@ -0,0 +1,21 @@
+#ifndef COMP6771_BENCHMARK_ALLOCATION_COUNTER_HPP
+#define COMP6771_BENCHMARK_ALLOCATION_COUNTER_HPP
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+// Shared by the Google Benchmark suites. Linking this library replaces the global operator new, so
+// every allocation in the process is counted, whether it comes through a memory resource, a
+// std::vector or a std::list.
+namespace comp6771::benchmarks {
+	// Calls to any global operator new so far, on every thread.
+	std::size_t allocations() noexcept;
+
+	// Dimension counts every size-dependent benchmark runs at: 2, 10, 100, ... 10^7.
+	void dimension_sizes(benchmark::internal::Benchmark* b);
+
+	// Call once the timing loop ends. Reports `bytes_per_iteration` as bytes per second, and the
+	// allocations made since `allocations_before` per iteration.
+	void record(benchmark::State& state, std::size_t allocations_before, std::size_t bytes_per_iteration);
+} // namespace comp6771::benchmarks
+#endif // COMP6771_BENCHMARK_ALLOCATION_COUNTER_HPP
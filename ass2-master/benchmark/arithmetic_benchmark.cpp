@@ -0,0 +1,294 @@
+// Operators, dot, euclidean_norm and unit. Binary operators build expression templates, so each is
+// measured as it is normally used: assigned into a euclidean_vector.
+#include "allocation_counter.hpp"
+#include "comp6771/euclidean_vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace {
+	using comp6771::benchmarks::allocations;
+	using comp6771::benchmarks::dimension_sizes;
+	using comp6771::benchmarks::record;
+
+	comp6771::euclidean_vector make_vector(benchmark::State const& state, double const offset = 0.0) {
+		auto magnitudes = std::vector<double>(static_cast<std::size_t>(state.range(0)));
+		for (std::size_t i = 0; i < magnitudes.size(); ++i) {
+			magnitudes[i] = std::sin(static_cast<double>(i) + offset) + 2.0;
+		}
+		return comp6771::euclidean_vector(std::move(magnitudes));
+	}
+
+	//`streams` whole vectors read or written per iteration.
+	std::size_t bytes(benchmark::State const& state, std::size_t const streams) {
+		return streams * static_cast<std::size_t>(state.range(0)) * sizeof(double);
+	}
+
+	void subscript(benchmark::State& state) {
+		auto const v = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto sum = 0.0;
+			for (auto i = 0; i < v.dimensions(); ++i) {
+				sum += v[i];
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		record(state, before, bytes(state, 1));
+	}
+	BENCHMARK(subscript)->Apply(dimension_sizes);
+
+	void at(benchmark::State& state) {
+		auto const v = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto sum = 0.0;
+			for (auto i = 0; i < v.dimensions(); ++i) {
+				sum += v.at(i);
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		record(state, before, bytes(state, 1));
+	}
+	BENCHMARK(at)->Apply(dimension_sizes);
+
+	void unary_plus(benchmark::State& state) {
+		auto const v = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto r = +v;
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(unary_plus)->Apply(dimension_sizes);
+
+	void negate(benchmark::State& state) {
+		auto const v = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto r = -v;
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(negate)->Apply(dimension_sizes);
+
+	void compound_add(benchmark::State& state) {
+		auto a = make_vector(state);
+		auto const b = make_vector(state, 1.0);
+		auto const before = allocations();
+		for (auto _ : state) {
+			a += b;
+			benchmark::DoNotOptimize(a);
+		}
+		record(state, before, bytes(state, 3));
+	}
+	BENCHMARK(compound_add)->Apply(dimension_sizes);
+
+	void compound_subtract(benchmark::State& state) {
+		auto a = make_vector(state);
+		auto const b = make_vector(state, 1.0);
+		auto const before = allocations();
+		for (auto _ : state) {
+			a -= b;
+			benchmark::DoNotOptimize(a);
+		}
+		record(state, before, bytes(state, 3));
+	}
+	BENCHMARK(compound_subtract)->Apply(dimension_sizes);
+
+	//Alternates the factor so the magnitudes neither overflow nor underflow.
+	void compound_multiply(benchmark::State& state) {
+		auto a = make_vector(state);
+		auto factor = 2.0;
+		auto const before = allocations();
+		for (auto _ : state) {
+			a *= factor;
+			factor = 1.0 / factor;
+			benchmark::DoNotOptimize(a);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(compound_multiply)->Apply(dimension_sizes);
+
+	void compound_divide(benchmark::State& state) {
+		auto a = make_vector(state);
+		auto divisor = 2.0;
+		auto const before = allocations();
+		for (auto _ : state) {
+			a /= divisor;
+			divisor = 1.0 / divisor;
+			benchmark::DoNotOptimize(a);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(compound_divide)->Apply(dimension_sizes);
+
+	void add(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const b = make_vector(state, 1.0);
+		auto const before = allocations();
+		for (auto _ : state) {
+			comp6771::euclidean_vector r = a + b;
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 3));
+	}
+	BENCHMARK(add)->Apply(dimension_sizes);
+
+	void subtract(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const b = make_vector(state, 1.0);
+		auto const before = allocations();
+		for (auto _ : state) {
+			comp6771::euclidean_vector r = a - b;
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 3));
+	}
+	BENCHMARK(subtract)->Apply(dimension_sizes);
+
+	void multiply(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			comp6771::euclidean_vector r = a * 3.0;
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(multiply)->Apply(dimension_sizes);
+
+	void divide(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			comp6771::euclidean_vector r = a / 3.0;
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(divide)->Apply(dimension_sizes);
+
+	//Three operands fused into one pass and one allocation.
+	void fused_expression(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const b = make_vector(state, 1.0);
+		auto const c = make_vector(state, 2.0);
+		auto const before = allocations();
+		for (auto _ : state) {
+			comp6771::euclidean_vector r = a + b - c * 2.0;
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 4));
+	}
+	BENCHMARK(fused_expression)->Apply(dimension_sizes);
+
+	//Equal vectors, so every magnitude is compared.
+	void equal(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const b = a;
+		auto const before = allocations();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(a == b);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(equal)->Apply(dimension_sizes);
+
+	void not_equal(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const b = a;
+		auto const before = allocations();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(a != b);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(not_equal)->Apply(dimension_sizes);
+
+	void dot(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const b = make_vector(state, 1.0);
+		auto const before = allocations();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(a, b));
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(dot)->Apply(dimension_sizes);
+
+	//dot(v, v) with its result already cached.
+	void dot_self_cached(benchmark::State& state) {
+		auto const v = make_vector(state);
+		benchmark::DoNotOptimize(comp6771::dot(v, v));
+		auto const before = allocations();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(v, v));
+		}
+		record(state, before, 0);
+	}
+	BENCHMARK(dot_self_cached)->Apply(dimension_sizes);
+
+	//A write through operator[] before each call empties the cache.
+	void euclidean_norm_cold(benchmark::State& state) {
+		auto v = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			v[0] = 2.0;
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+		record(state, before, bytes(state, 1));
+	}
+	BENCHMARK(euclidean_norm_cold)->Apply(dimension_sizes);
+
+	void euclidean_norm_cached(benchmark::State& state) {
+		auto const v = make_vector(state);
+		benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		auto const before = allocations();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+		record(state, before, 0);
+	}
+	BENCHMARK(euclidean_norm_cached)->Apply(dimension_sizes);
+
+	void unit(benchmark::State& state) {
+		auto const v = make_vector(state);
+		benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto r = comp6771::unit(v);
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(unit)->Apply(dimension_sizes);
+
+	void squared_distance(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const b = make_vector(state, 1.0);
+		auto const before = allocations();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::squared_distance(a, b));
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(squared_distance)->Apply(dimension_sizes);
+
+	//What squared_distance replaces.
+	void squared_norm_of_difference(benchmark::State& state) {
+		auto const a = make_vector(state);
+		auto const b = make_vector(state, 1.0);
+		auto const before = allocations();
+		for (auto _ : state) {
+			comp6771::euclidean_vector d = a - b;
+			benchmark::DoNotOptimize(comp6771::dot(d, d));
+		}
+		record(state, before, bytes(state, 4));
+	}
+	BENCHMARK(squared_norm_of_difference)->Apply(dimension_sizes);
+} // namespace
@@ -0,0 +1,166 @@
+// Constructors, copies and moves. Vectors up to COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY
+// dimensions should show no allocations at all.
+#include "allocation_counter.hpp"
+#include "comp6771/euclidean_vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace {
+	using comp6771::benchmarks::allocations;
+	using comp6771::benchmarks::dimension_sizes;
+	using comp6771::benchmarks::record;
+
+	std::vector<double> magnitudes(std::size_t const n) {
+		auto result = std::vector<double>(n);
+		std::iota(result.begin(), result.end(), 1.0);
+		return result;
+	}
+
+	std::size_t bytes(benchmark::State const& state) {
+		return static_cast<std::size_t>(state.range(0)) * sizeof(double);
+	}
+
+	void default_constructor(benchmark::State& state) {
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector();
+			benchmark::DoNotOptimize(v);
+		}
+		record(state, before, sizeof(double));
+	}
+	BENCHMARK(default_constructor);
+
+	void size_constructor(benchmark::State& state) {
+		auto const n = static_cast<int>(state.range(0));
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector(n);
+			benchmark::DoNotOptimize(v);
+		}
+		record(state, before, bytes(state));
+	}
+	BENCHMARK(size_constructor)->Apply(dimension_sizes);
+
+	void size_value_constructor(benchmark::State& state) {
+		auto const n = static_cast<int>(state.range(0));
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector(n, 3.0);
+			benchmark::DoNotOptimize(v);
+		}
+		record(state, before, bytes(state));
+	}
+	BENCHMARK(size_value_constructor)->Apply(dimension_sizes);
+
+	void iterator_constructor(benchmark::State& state) {
+		auto const source = magnitudes(static_cast<std::size_t>(state.range(0)));
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector(source.cbegin(), source.cend());
+			benchmark::DoNotOptimize(v);
+		}
+		record(state, before, 2 * bytes(state));
+	}
+	BENCHMARK(iterator_constructor)->Apply(dimension_sizes);
+
+	void range_constructor(benchmark::State& state) {
+		auto const source = magnitudes(static_cast<std::size_t>(state.range(0)));
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector(std::span<double const>(source));
+			benchmark::DoNotOptimize(v);
+		}
+		record(state, before, 2 * bytes(state));
+	}
+	BENCHMARK(range_constructor)->Apply(dimension_sizes);
+
+	//Includes copying the std::vector that is then adopted, which the copy_std_vector baseline times
+	//on its own.
+	void std_vector_move_constructor(benchmark::State& state) {
+		auto const source = magnitudes(static_cast<std::size_t>(state.range(0)));
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector(std::vector<double>(source));
+			benchmark::DoNotOptimize(v);
+		}
+		record(state, before, 2 * bytes(state));
+	}
+	BENCHMARK(std_vector_move_constructor)->Apply(dimension_sizes);
+
+	void copy_std_vector(benchmark::State& state) {
+		auto const source = magnitudes(static_cast<std::size_t>(state.range(0)));
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = std::vector<double>(source);
+			benchmark::DoNotOptimize(v);
+		}
+		record(state, before, 2 * bytes(state));
+	}
+	BENCHMARK(copy_std_vector)->Apply(dimension_sizes);
+
+	void initializer_list_constructor(benchmark::State& state) {
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+			benchmark::DoNotOptimize(v);
+		}
+		record(state, before, 8 * sizeof(double));
+	}
+	BENCHMARK(initializer_list_constructor);
+
+	void copy_constructor(benchmark::State& state) {
+		auto const source = comp6771::euclidean_vector(std::span<double const>(magnitudes(static_cast<std::size_t>(state.range(0)))));
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = source;
+			benchmark::DoNotOptimize(v);
+		}
+		record(state, before, 2 * bytes(state));
+	}
+	BENCHMARK(copy_constructor)->Apply(dimension_sizes);
+
+	//Moves there and back, so each iteration starts from the same state: one move constructor and
+	//one move assignment.
+	void move_constructor(benchmark::State& state) {
+		auto source = comp6771::euclidean_vector(std::span<double const>(magnitudes(static_cast<std::size_t>(state.range(0)))));
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto v = std::move(source);
+			benchmark::DoNotOptimize(v);
+			source = std::move(v);
+		}
+		record(state, before, 0);
+	}
+	BENCHMARK(move_constructor)->Apply(dimension_sizes);
+
+	void copy_assignment(benchmark::State& state) {
+		auto const n = static_cast<std::size_t>(state.range(0));
+		auto const source = comp6771::euclidean_vector(std::span<double const>(magnitudes(n)));
+		auto target = comp6771::euclidean_vector(static_cast<int>(n));
+		auto const before = allocations();
+		for (auto _ : state) {
+			target = source;
+			benchmark::DoNotOptimize(target);
+		}
+		record(state, before, 2 * bytes(state));
+	}
+	BENCHMARK(copy_assignment)->Apply(dimension_sizes);
+
+	void move_assignment(benchmark::State& state) {
+		auto const n = static_cast<std::size_t>(state.range(0));
+		auto a = comp6771::euclidean_vector(std::span<double const>(magnitudes(n)));
+		auto b = comp6771::euclidean_vector(static_cast<int>(n));
+		auto const before = allocations();
+		for (auto _ : state) {
+			b = std::move(a);
+			a = std::move(b);
+			benchmark::DoNotOptimize(a);
+		}
+		record(state, before, 0);
+	}
+	BENCHMARK(move_assignment)->Apply(dimension_sizes);
+} // namespace
@@ -0,0 +1,89 @@
+// Conversions to the standard containers and to another precision, and formatted output.
+#include "allocation_counter.hpp"
+#include "comp6771/euclidean_vector.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstddef>
+#include <list>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace {
+	using comp6771::benchmarks::allocations;
+	using comp6771::benchmarks::dimension_sizes;
+	using comp6771::benchmarks::record;
+
+	comp6771::euclidean_vector make_vector(benchmark::State const& state) {
+		auto magnitudes = std::vector<double>(static_cast<std::size_t>(state.range(0)));
+		for (std::size_t i = 0; i < magnitudes.size(); ++i) {
+			magnitudes[i] = std::sin(static_cast<double>(i)) * 1000.0;
+		}
+		return comp6771::euclidean_vector(std::move(magnitudes));
+	}
+
+	std::size_t bytes(benchmark::State const& state, std::size_t const streams) {
+		return streams * static_cast<std::size_t>(state.range(0)) * sizeof(double);
+	}
+
+	void to_std_vector(benchmark::State& state) {
+		auto const v = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto r = static_cast<std::vector<double>>(v);
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(to_std_vector)->Apply(dimension_sizes);
+
+	//The rvalue conversion hands over a heap buffer; each iteration copies v first so there is one to
+	//hand over, which the copy_constructor benchmark times on its own.
+	void to_std_vector_from_rvalue(benchmark::State& state) {
+		auto const v = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto r = static_cast<std::vector<double>>(comp6771::euclidean_vector(v));
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(to_std_vector_from_rvalue)->Apply(dimension_sizes);
+
+	void to_std_list(benchmark::State& state) {
+		auto const v = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto r = static_cast<std::list<double>>(v);
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 2));
+	}
+	BENCHMARK(to_std_list)->Apply(dimension_sizes);
+
+	void to_float(benchmark::State& state) {
+		auto const v = make_vector(state);
+		auto const before = allocations();
+		for (auto _ : state) {
+			auto r = comp6771::basic_euclidean_vector<float>(v);
+			benchmark::DoNotOptimize(r);
+		}
+		record(state, before, bytes(state, 1) + static_cast<std::size_t>(state.range(0)) * sizeof(float));
+	}
+	BENCHMARK(to_float)->Apply(dimension_sizes);
+
+	//Bytes are the characters written.
+	void output(benchmark::State& state) {
+		auto const v = make_vector(state);
+		auto os = std::ostringstream();
+		auto written = std::size_t{0};
+		auto const before = allocations();
+		for (auto _ : state) {
+			os.str({});
+			os << v;
+			written = static_cast<std::size_t>(os.tellp());
+		}
+		record(state, before, written);
+	}
+	BENCHMARK(output)->Apply(dimension_sizes);
+} // namespace
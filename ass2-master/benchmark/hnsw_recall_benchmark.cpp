@@ -0,0 +1,92 @@
+// Measures how much of the exact top k an hnsw_index finds, and how fast, as ef_search grows.
+//
+//     hnsw_recall_benchmark [vectors=100000] [dimensions=64] [queries=1000] [k=10] [threads=0]
+//
+// The dataset is synthetic: vectors drawn around a few hundred gaussian clusters, which is closer
+// to real embeddings than uniform noise. knn_index provides the ground truth.
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include "comp6771/hnsw_index.hpp"
+#include "comp6771/knn_index.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+	using clock_type = std::chrono::steady_clock;
+
+	double seconds_since(clock_type::time_point const start) {
+		return std::chrono::duration<double>(clock_type::now() - start).count();
+	}
+
+	comp6771::euclidean_vector_batch clustered(int const count, int const dimensions, std::mt19937_64& engine) {
+		auto const clusters = std::max(count / 400, 1);
+		auto centre = std::normal_distribution<double>(0.0, 1.0);
+		auto spread = std::normal_distribution<double>(0.0, 0.35);
+		auto pick = std::uniform_int_distribution<int>(0, clusters - 1);
+		auto centres = std::vector<double>(static_cast<std::size_t>(clusters * dimensions));
+		for (auto& c : centres) {
+			c = centre(engine);
+		}
+		auto batch = comp6771::euclidean_vector_batch(count, dimensions);
+		for (auto r = 0; r < count; ++r) {
+			auto const* c = centres.data() + static_cast<std::size_t>(pick(engine) * dimensions);
+			auto const row = batch[r];
+			for (auto d = 0; d < dimensions; ++d) {
+				row[d] = c[d] + spread(engine);
+			}
+		}
+		return batch;
+	}
+
+	int argument(int const argc, char** argv, int const i, int const fallback) {
+		return argc > i ? std::atoi(argv[i]) : fallback;
+	}
+} // namespace
+
+int main(int argc, char** argv) {
+	auto const count = argument(argc, argv, 1, 100'000);
+	auto const dimensions = argument(argc, argv, 2, 64);
+	auto const query_count = argument(argc, argv, 3, 1000);
+	auto const k = argument(argc, argv, 4, 10);
+	comp6771::parallel::set_thread_count(static_cast<unsigned>(argument(argc, argv, 5, 0)));
+
+	auto engine = std::mt19937_64(6771);
+	auto const data = clustered(count, dimensions, engine);
+	auto const queries = clustered(query_count, dimensions, engine);
+
+	auto start = clock_type::now();
+	auto const exact = comp6771::knn_index(data);
+	auto const truth = exact.search_batch(queries, k);
+	std::printf("exact: %d queries in %.3f s (%u threads)\n", query_count, seconds_since(start),
+	            comp6771::parallel::thread_count());
+
+	start = clock_type::now();
+	auto index = comp6771::hnsw_index(dimensions);
+	for (auto r = 0; r < count; ++r) {
+		index.insert(comp6771::const_euclidean_vector_view(std::span<double const>(data[r].data(),
+		                                                   static_cast<std::size_t>(dimensions))));
+	}
+	std::printf("hnsw: built %d vectors in %.3f s (m %d, ef_construction %d)\n", count, seconds_since(start),
+	            index.parameters().m, index.parameters().ef_construction);
+
+	std::printf("%10s %10s %12s\n", "ef_search", "recall", "queries/s");
+	for (auto const ef : {16, 32, 64, 128, 256, 512}) {
+		index.set_ef_search(ef);
+		auto hits = 0L;
+		start = clock_type::now();
+		for (auto q = 0; q < query_count; ++q) {
+			auto const found = index.search(comp6771::const_euclidean_vector_view(
+				std::span<double const>(queries[q].data(), static_cast<std::size_t>(dimensions))), k);
+			for (auto const& expected : truth[static_cast<std::size_t>(q)]) {
+				hits += std::any_of(found.begin(), found.end(), [&](auto const& n) { return n.index == expected.index; });
+			}
+		}
+		auto const elapsed = seconds_since(start);
+		std::printf("%10d %10.4f %12.0f\n", ef, static_cast<double>(hits) / (static_cast<double>(query_count) * k),
+		            query_count / elapsed);
+	}
+}
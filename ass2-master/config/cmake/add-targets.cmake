@@ -47,11 +47,14 @@ endfunction()
 
 # Builds an executable that can be run as a more reliable benchmark.
 # Accepts the same parameters as `cxx_executable`.
-# Depends on Google Benchmark being imported.
+# Depends on Google Benchmark being imported. Adds -fno-inline when
+# COMP6771_EUCLIDEAN_VECTOR_BENCHMARK_NO_INLINE is On.
 function(cxx_benchmark)
    cxx_executable(${ARGN})
 
    PROJECT_TEMPLATE_EXTRACT_ADD_TARGET_ARGS(${ARGN})
-   target_compile_options("${add_target_args_TARGET}" PRIVATE -fno-inline)
+   if(COMP6771_EUCLIDEAN_VECTOR_BENCHMARK_NO_INLINE)
+      target_compile_options("${add_target_args_TARGET}" PRIVATE -fno-inline)
+   endif()
    target_link_libraries("${add_target_args_TARGET}" PRIVATE benchmark::benchmark benchmark::benchmark_main)
 endfunction()
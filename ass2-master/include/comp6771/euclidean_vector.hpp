@@ -1,146 +1,815 @@
 #ifndef COMP6771_EUCLIDEAN_VECTOR_HPP
 #define COMP6771_EUCLIDEAN_VECTOR_HPP
 
+#include "comp6771/euclidean_vector_format.hpp"
+#include "comp6771/euclidean_vector_metrics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
+#include <memory_resource>
 #include <stdexcept>
 #include <cmath>
 #include <vector>
 #include <list>
+#include <limits>
+#include <optional>
+#include <span>
 #include <string>
 #include <iostream>
-#include <experimental/iterator>
+#include <charconv>
 #include <cstdint>
+#include <cstring>
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include <functional>
+#include <type_traits>
+#include <utility>
 
 namespace comp6771 {
 	class euclidean_vector_error : public std::runtime_error {
 	public:
 		explicit euclidean_vector_error(std::string const& what)
-		: std::runtime_error(what) {}
+		: std::runtime_error(what) {
+			COMP6771_EUCLIDEAN_VECTOR_COUNT(errors, 1);
+		}
 	};
 
-	class euclidean_vector {
+	namespace detail {
+		//The error every operation on two vectors, or a vector and a batch, raises when their
+		//dimensions differ. Takes any mix of integer types so callers needn't cast.
+		template<std::integral L, std::integral R>
+		void check_dimensions(L const lhs, R const rhs) {
+			if (std::cmp_not_equal(lhs, rhs)) {
+				throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(lhs) +") and RHS(" +
+				std::to_string(rhs) + ") do not match");
+			}
+		}
+
+		//For cosine, which ignores scale: only a vector with no direction at all, or one whose norm
+		//isn't finite, is rejected. unit() keeps its stricter tolerance.
+		template<std::floating_point N>
+		void check_direction(N const norm) {
+			if (not (norm > 0) or not std::isfinite(norm)) {
+				throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a unit vector");
+			}
+		}
+	} // namespace detail
+
+	//Vectors with at most this many dimensions keep their magnitudes inside the object rather than
+	//on the heap. The value changes the class layout, so every translation unit must agree on it; set
+	//it through the COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY CMake cache variable.
+#ifndef COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY
+#define COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY 4
+#endif
+
+	namespace detail {
+		//Reductions over T may accumulate in any floating-point type at least as precise as T.
+		template<typename Accumulator, typename T>
+		concept accumulator_for = std::floating_point<Accumulator>
+		                      and std::numeric_limits<Accumulator>::digits >= std::numeric_limits<T>::digits;
+	} // namespace detail
+
+	//Magnitudes are stored as T, which is float, double or long double. dot and euclidean_norm sum
+	//in Accumulator, so float storage can keep double sums; the cached norm is kept in it too.
+	template<typename T, typename Accumulator = T>
+	class basic_euclidean_vector;
+
+	using euclidean_vector = basic_euclidean_vector<double>;
+
+	class euclidean_vector_view;
+	class const_euclidean_vector_view;
+
+	namespace detail {
+		//Lets the expression layer read a vector's buffer without widening the public interface.
+		struct vector_access {
+			template<typename T, typename A>
+			static T const* data(basic_euclidean_vector<T, A> const& v) noexcept;
+			template<typename T, typename A>
+			static std::size_t size(basic_euclidean_vector<T, A> const& v) noexcept;
+			//|v|^2 from the cached self-dot or norm, whichever is present; computes and caches nothing.
+			template<typename T, typename A>
+			static std::optional<A> cached_squared_norm(basic_euclidean_vector<T, A> const& v) noexcept;
+		};
+
+		//Frees a heap buffer through the memory resource that allocated it. An adopted buffer belongs
+		//to a std::vector<T> held on new_delete_resource rather than the vector's own resource, so it
+		//can move to a vector on any resource and outlive the one it was adopted on.
+		template<typename T>
+		struct basic_buffer_deleter {
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+			std::size_t size = 0;
+			std::size_t alignment = alignof(T);
+			std::vector<T>* adopted = nullptr;
+
+			void operator()(T* p) const noexcept {
+				if (adopted != nullptr) {
+					std::pmr::polymorphic_allocator<>(resource).delete_object(adopted);
+				} else {
+					resource->deallocate(p, size * sizeof(T), alignment);
+				}
+			}
+		};
+
+		using buffer_deleter = basic_buffer_deleter<double>;
+
+		template<typename R>
+		concept arithmetic_range = std::ranges::input_range<R> and std::is_arithmetic_v<std::ranges::range_value_t<R>>;
+
+		//A lazily computed result that const readers on several threads may fill in at once. The
+		//value lives in one lock-free atomic, with NaN meaning "not computed", so a reader sees
+		//either nothing or a complete result and a NaN result is simply never cached. Relaxed
+		//ordering suffices because nothing else is published through it.
+		template<std::floating_point T>
+		class cached_value {
+		public:
+			cached_value() noexcept = default;
+			cached_value(cached_value const& other) noexcept : value_{other.value_.load(std::memory_order_relaxed)} {}
+
+			cached_value& operator=(cached_value const& other) noexcept {
+				value_.store(other.value_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				return *this;
+			}
+
+			std::optional<T> load() const noexcept {
+				auto const value = value_.load(std::memory_order_relaxed);
+				return std::isnan(value) ? std::nullopt : std::optional<T>(value);
+			}
+
+			void store(T const value) noexcept { value_.store(value, std::memory_order_relaxed); }
+			void reset() noexcept { store(empty); }
+
+			//Takes other's value, leaving it empty.
+			void take(cached_value& other) noexcept {
+				store(other.value_.exchange(empty, std::memory_order_relaxed));
+			}
+
+		private:
+			static constexpr T empty = std::numeric_limits<T>::quiet_NaN();
+			std::atomic<T> value_ = empty;
+		};
+
+		//Types too wide for a lock-free atomic, such as an x87 long double, sit behind a spin lock
+		//instead. It is only ever held for a copy.
+		template<std::floating_point T>
+		requires (not std::atomic<T>::is_always_lock_free)
+		class cached_value<T> {
+		public:
+			cached_value() noexcept = default;
+			cached_value(cached_value const& other) noexcept : value_{other.Read()} {}
+
+			cached_value& operator=(cached_value const& other) noexcept {
+				store(other.Read());
+				return *this;
+			}
+
+			std::optional<T> load() const noexcept {
+				auto const value = Read();
+				return std::isnan(value) ? std::nullopt : std::optional<T>(value);
+			}
+
+			void store(T const value) noexcept {
+				Lock();
+				value_ = value;
+				lock_.clear(std::memory_order_release);
+			}
+
+			void reset() noexcept { store(empty); }
+
+			void take(cached_value& other) noexcept {
+				other.Lock();
+				auto const value = std::exchange(other.value_, empty);
+				other.lock_.clear(std::memory_order_release);
+				store(value);
+			}
+
+		private:
+			void Lock() const noexcept {
+				while (lock_.test_and_set(std::memory_order_acquire)) {
+				}
+			}
+
+			T Read() const noexcept {
+				Lock();
+				auto const value = value_;
+				lock_.clear(std::memory_order_release);
+				return value;
+			}
+
+			static constexpr T empty = std::numeric_limits<T>::quiet_NaN();
+			mutable std::atomic_flag lock_;
+			T value_ = empty;
+		};
+
+		template<typename T>
+		struct is_euclidean_vector : std::false_type {};
+
+		template<typename T, typename A>
+		struct is_euclidean_vector<basic_euclidean_vector<T, A>> : std::true_type {};
+
+		//Every lazy arithmetic node derives from this tag.
+		struct expression_base {};
+
+		template<typename T>
+		concept vector_node = std::derived_from<std::remove_cvref_t<T>, expression_base>;
+
+		template<typename T>
+		concept vector_view = std::same_as<std::remove_cvref_t<T>, euclidean_vector_view>
+		                   or std::same_as<std::remove_cvref_t<T>, const_euclidean_vector_view>;
+
+		template<typename T>
+		concept vector_operand = vector_node<T> or vector_view<T> or is_euclidean_vector<std::remove_cvref_t<T>>::value;
+
+		//Leaf for an lvalue vector, which outlives the expression, or for a view, whose magnitudes
+		//belong to someone else anyway.
+		template<typename T>
+		class vector_ref {
+		public:
+			using value_type = T;
+
+			template<typename A>
+			explicit vector_ref(basic_euclidean_vector<T, A> const& v) noexcept
+			: data_{vector_access::data(v)}, size_{vector_access::size(v)} {}
+			vector_ref(T const* data, std::size_t const size) noexcept : data_{data}, size_{size} {}
+
+			std::size_t size() const noexcept { return size_; }
+			T operator[](std::size_t i) const noexcept { return data_[i]; }
+
+		private:
+			T const* data_;
+			std::size_t size_;
+		};
+
+		//Leaf for an rvalue vector. The node takes ownership (a move, not a copy) so
+		//`auto e = euclidean_vector{1, 2} + b;` does not dangle.
+		template<typename V>
+		class vector_value {
+		public:
+			using value_type = typename V::value_type;
+
+			explicit vector_value(V&& v) noexcept : value_{std::move(v)} {}
+
+			std::size_t size() const noexcept { return vector_access::size(value_); }
+			value_type operator[](std::size_t i) const noexcept { return vector_access::data(value_)[i]; }
+
+		private:
+			V value_;
+		};
+
+		//Leaf for a named expression, which like a named vector outlives the expression using it.
+		template<typename E>
+		class node_ref {
+		public:
+			using value_type = typename E::value_type;
+
+			explicit node_ref(E const& expr) noexcept : expr_{&expr} {}
+
+			std::size_t size() const noexcept { return expr_->size(); }
+			value_type operator[](std::size_t i) const { return (*expr_)[i]; }
+
+		private:
+			E const* expr_;
+		};
+
+		template<typename L, typename R, typename Op>
+		class binary_node : public expression_base {
+		public:
+			using value_type = typename L::value_type;
+
+			binary_node(L lhs, R rhs) : lhs_{std::move(lhs)}, rhs_{std::move(rhs)} {
+				check_dimensions(lhs_.size(), rhs_.size());
+			}
+
+			std::size_t size() const noexcept { return lhs_.size(); }
+			value_type operator[](std::size_t i) const { return Op{}(lhs_[i], rhs_[i]); }
+
+		private:
+			L lhs_;
+			R rhs_;
+		};
+
+		template<typename E, typename Op>
+		class scalar_node : public expression_base {
+		public:
+			using value_type = typename E::value_type;
+
+			scalar_node(E expr, value_type const scalar) : expr_{std::move(expr)}, scalar_{scalar} {}
+
+			std::size_t size() const noexcept { return expr_.size(); }
+			value_type operator[](std::size_t i) const { return Op{}(expr_[i], scalar_); }
+
+		private:
+			E expr_;
+			value_type scalar_;
+		};
+
+		template<vector_operand T>
+		auto make_operand(T&& t) {
+			if constexpr (vector_node<T> and std::is_lvalue_reference_v<T>) {
+				return node_ref<std::remove_cvref_t<T>>(t);
+			} else if constexpr (vector_node<T>) {
+				return std::remove_cvref_t<T>(std::move(t));
+			} else if constexpr (vector_view<T>) {
+				return vector_ref<double>(t.data(), static_cast<std::size_t>(t.dimensions()));
+			} else if constexpr (std::is_lvalue_reference_v<T>) {
+				return vector_ref<typename std::remove_cvref_t<T>::value_type>(t);
+			} else if constexpr (std::is_const_v<std::remove_reference_t<T>>) {
+				//A const rvalue can't be moved from, and dies with the full expression, so keep a copy.
+				return vector_value<std::remove_cvref_t<T>>(std::remove_cvref_t<T>(t));
+			} else {
+				return vector_value<std::remove_cvref_t<T>>(std::move(t));
+			}
+		}
+
+		template<typename T>
+		using operand_t = decltype(make_operand(std::declval<T>()));
+
+		//The magnitude type of any operand. Expressions never mix precisions implicitly.
+		template<typename T>
+		using value_t = typename operand_t<T>::value_type;
+
+		template<typename L, typename R>
+		concept same_precision = std::same_as<value_t<L>, value_t<R>>;
+
+		template<typename Op, vector_operand L, vector_operand R>
+		requires same_precision<L, R>
+		auto make_binary(L&& lhs, R&& rhs) {
+			return binary_node<operand_t<L>, operand_t<R>, Op>(make_operand(std::forward<L>(lhs)),
+			                                                   make_operand(std::forward<R>(rhs)));
+		}
+
+		//A non-const rvalue vector, whose buffer an operator may take over for its result.
+		template<typename T>
+		concept expiring_vector = is_euclidean_vector<T>::value;
+
+		template<typename Op, vector_operand E>
+		auto make_scalar(E&& expr, value_t<E> const scalar) {
+			return scalar_node<operand_t<E>, Op>(make_operand(std::forward<E>(expr)), scalar);
+		}
+	} // namespace detail
+
+	//Heap buffers come from a std::pmr::memory_resource, which follows the std::pmr container rules:
+	//  * every constructor takes an optional allocator, defaulting to std::pmr::get_default_resource();
+	//  * copy construction does not propagate the source's resource, move construction does;
+	//  * assignment never changes the target's resource. A move assignment between different
+	//    resources copies the magnitudes, so unlike move construction it may throw.
+	//Arithmetic results are new vectors and so use the default resource, unless they are assigned
+	//into an existing vector or constructed with an explicit allocator.
+	//A vector built from a std::vector<T>&& adopts that vector's buffer rather than allocating.
+	//Such a buffer isn't tied to any resource, so it can always be moved into another vector, and
+	//std::move(v).to_vector() hands it back without a copy.
+	//
+	//The members are compiled once, in euclidean_vector.cpp, for each T of float, double and long
+	//double and each Accumulator at least as precise.
+	template<typename T, typename Accumulator>
+	class basic_euclidean_vector {
+		static_assert(std::floating_point<T>, "magnitudes must be float, double or long double");
+		static_assert(detail::accumulator_for<Accumulator, T>, "the accumulator can't be less precise than T");
+
 	public:
+		using value_type = T;
+		using accumulator_type = Accumulator;
+		using allocator_type = std::pmr::polymorphic_allocator<T>;
+
 		//Constructors
-		euclidean_vector();
-		explicit euclidean_vector(int const &size);
-		euclidean_vector(int const &size, double const &num);
-		euclidean_vector(std::vector<double>::const_iterator const begin, std::vector<double>::const_iterator const end);
-		euclidean_vector(std::initializer_list<double> l);
-		euclidean_vector(euclidean_vector const&ev);
-		euclidean_vector(euclidean_vector &&Orig) noexcept;
-
-		euclidean_vector& operator=(euclidean_vector const& ev);
-		euclidean_vector& operator=(euclidean_vector &&Orig) noexcept;
-		double operator[](int i) const;
-		double& operator[](int i);
-		euclidean_vector operator+(void) const;
-		euclidean_vector operator-(void) const;
-		euclidean_vector operator+=(euclidean_vector const& b);
-		euclidean_vector operator-=(euclidean_vector const& b) ;
-		euclidean_vector operator*=(double const& b);
-		euclidean_vector operator/=(double const& b);
-		explicit operator std::vector<double>() const;
-		explicit operator std::list<double>() const;
-
-		double at(int i) const;
-		double& at(int i);
+		basic_euclidean_vector();
+		explicit basic_euclidean_vector(allocator_type const& alloc);
+		explicit basic_euclidean_vector(int const &size, allocator_type const& alloc = {});
+		basic_euclidean_vector(int const &size, T const &num, allocator_type const& alloc = {});
+		basic_euclidean_vector(typename std::vector<T>::const_iterator const begin,
+		                       typename std::vector<T>::const_iterator const end, allocator_type const& alloc = {});
+		basic_euclidean_vector(std::initializer_list<T> l, allocator_type const& alloc = {});
+		//Takes v's buffer; `alloc` only supplies the small holder for it. Vectors short enough to be
+		//stored inline are copied. Either way v is left empty.
+		explicit basic_euclidean_vector(std::vector<T>&& v, allocator_type const& alloc = {});
+
+		//Any range or iterator pair of arithmetic values. Contiguous ranges of T are copied with one
+		//memcpy, and single-pass ranges are gathered into a buffer that is then adopted.
+		template<detail::arithmetic_range R>
+		explicit basic_euclidean_vector(R&& range, allocator_type const& alloc = {})
+		: dimensions_{0}, alloc_{alloc} {
+			using range_value = std::ranges::range_value_t<R>;
+			if constexpr (std::ranges::contiguous_range<R> and std::ranges::sized_range<R>
+			              and std::same_as<range_value, T>) {
+				Allocate(std::ranges::size(range));
+				if (dimensions_ != 0) {
+					std::memcpy(data_, std::ranges::data(range), sizeof(T)*dimensions_);
+				}
+			} else if constexpr (std::ranges::forward_range<R> or std::ranges::sized_range<R>) {
+				Allocate(static_cast<std::size_t>(std::ranges::distance(range)));
+				std::ranges::transform(range, data_, [](range_value const x) { return static_cast<T>(x); });
+			} else {
+				auto magnitudes = std::vector<T>();
+				for (auto&& x : range) {
+					magnitudes.push_back(static_cast<T>(x));
+				}
+				Adopt(std::move(magnitudes));
+			}
+		}
+
+		template<std::input_iterator I, std::sentinel_for<I> S>
+		requires std::is_arithmetic_v<std::iter_value_t<I>>
+		basic_euclidean_vector(I begin, S end, allocator_type const& alloc = {})
+		: basic_euclidean_vector(std::ranges::subrange(std::move(begin), std::move(end)), alloc) {}
+
+		basic_euclidean_vector(basic_euclidean_vector const&ev);
+		basic_euclidean_vector(basic_euclidean_vector const&ev, allocator_type const& alloc);
+		basic_euclidean_vector(basic_euclidean_vector &&Orig) noexcept;
+		basic_euclidean_vector(basic_euclidean_vector &&Orig, allocator_type const& alloc);
+
+		//Changing precision, or just the accumulator, is always spelled out.
+		template<typename U, typename B>
+		requires (not std::same_as<basic_euclidean_vector<U, B>, basic_euclidean_vector>)
+		explicit basic_euclidean_vector(basic_euclidean_vector<U, B> const& other, allocator_type const& alloc = {})
+		: dimensions_{0}, alloc_{alloc} {
+			auto const* magnitudes = detail::vector_access::data(other);
+			Allocate(detail::vector_access::size(other));
+			COMP6771_EUCLIDEAN_VECTOR_COUNT(copies, 1);
+			COMP6771_EUCLIDEAN_VECTOR_COUNT(copied_bytes, sizeof(U) * dimensions_);
+			std::transform(magnitudes, magnitudes + dimensions_, data_, [](U const x) { return static_cast<T>(x); });
+		}
+
+		//Evaluates a lazy expression such as `a + b - 2.0 * c` in a single pass over one new buffer.
+		template<detail::vector_node E>
+		explicit(not std::same_as<typename E::value_type, T>)
+		basic_euclidean_vector(E const& expr, allocator_type const& alloc = {})
+		: dimensions_{0}, alloc_{alloc} {
+			Allocate(expr.size());
+			for (std::size_t i = 0; i < dimensions_; ++i) {
+				data_[i] = static_cast<T>(expr[i]);
+			}
+		}
+
+		basic_euclidean_vector& operator=(basic_euclidean_vector const& ev);
+		basic_euclidean_vector& operator=(basic_euclidean_vector &&Orig);
+
+		//Nodes only read index i when producing element i, so the result can be written straight
+		//into our own buffer even when *this appears in the expression.
+		template<detail::vector_node E>
+		requires std::same_as<typename E::value_type, T>
+		basic_euclidean_vector& operator=(E const& expr) {
+			if (expr.size() != dimensions_) {
+				//Evaluate before letting go of our old buffer, which expr may still read.
+				*this = basic_euclidean_vector(expr, alloc_);
+			} else {
+				for (std::size_t i = 0; i < dimensions_; ++i) {
+					data_[i] = expr[i];
+				}
+			}
+			AdjustMutables();
+			return *this;
+		}
+
+		T operator[](int i) const;
+		T& operator[](int i);
+		basic_euclidean_vector operator+(void) const&;
+		basic_euclidean_vector operator+(void) &&;
+		basic_euclidean_vector operator-(void) const&;
+		basic_euclidean_vector operator-(void) &&;
+		basic_euclidean_vector& operator+=(basic_euclidean_vector const& b);
+		basic_euclidean_vector& operator-=(basic_euclidean_vector const& b) ;
+		basic_euclidean_vector& operator+=(const_euclidean_vector_view b) requires std::same_as<T, double>;
+		basic_euclidean_vector& operator-=(const_euclidean_vector_view b) requires std::same_as<T, double>;
+		basic_euclidean_vector& operator*=(T const& b);
+		basic_euclidean_vector& operator/=(T const& b);
+
+		//`a += b - c` evaluates the right-hand side straight into our buffer.
+		template<detail::vector_node E>
+		requires std::same_as<typename E::value_type, T>
+		basic_euclidean_vector& operator+=(E const& expr) {
+			return *this = detail::make_binary<std::plus<>>(*this, expr);
+		}
+
+		template<detail::vector_node E>
+		requires std::same_as<typename E::value_type, T>
+		basic_euclidean_vector& operator-=(E const& expr) {
+			return *this = detail::make_binary<std::minus<>>(*this, expr);
+		}
+
+		explicit operator std::vector<T>() const&;
+		explicit operator std::vector<T>() &&;
+		explicit operator std::list<T>() const;
+
+		//The rvalue overload returns an adopted buffer as is and otherwise copies; either way *this
+		//is left with 0 dimensions.
+		std::vector<T> to_vector() const&;
+		std::vector<T> to_vector() &&;
+
+		T at(int i) const;
+		T& at(int i);
 		int dimensions() const;
 
-		friend bool operator==(euclidean_vector const& a, euclidean_vector const& b) {
+		//Bounds-checked like at(). Unlike a write through operator[] or at(), it can keep a cached
+		//norm up to date; see maintain_norm.
+		void set(int i, T value);
+
+		//While enabled, a cached norm and self-dot survive set(), *= and /= and are adjusted in O(1)
+		//rather than recomputed on the next read. Every norm_refresh_interval adjustments the cache is
+		//dropped so rounding can't accumulate. Off by default; copies inherit the setting, but
+		//assignment leaves the target's unchanged.
+		void maintain_norm(bool const enable) noexcept { maintain_norm_ = enable; }
+		bool maintains_norm() const noexcept { return maintain_norm_; }
+		static constexpr std::uint32_t norm_refresh_interval = 1024;
+		allocator_type get_allocator() const noexcept { return alloc_; }
+
+		friend bool operator==(basic_euclidean_vector const& a, basic_euclidean_vector const& b) {
 			if (a.dimensions_ != b.dimensions_) {
 				return false;
 			}
-			auto EpFactor = [] (double const& x, double const& y, double const& Epsilon = 0.0001) {
+			auto EpFactor = [] (T const& x, T const& y, T const& Epsilon = T(0.0001)) {
 				return (std::abs(x-y) < Epsilon);
 			};
-			return std::equal(a.magnitude_.get(), a.magnitude_.get()+a.dimensions_
-					,b.magnitude_.get(), b.magnitude_.get()+b.dimensions_, EpFactor);
+			return std::equal(a.data_, a.data_+a.dimensions_
+					,b.data_, b.data_+b.dimensions_, EpFactor);
 		}
 
-		friend bool operator!=(euclidean_vector const& a, euclidean_vector const& b) {
+		friend bool operator!=(basic_euclidean_vector const& a, basic_euclidean_vector const& b) {
 			return !(a==b);
 		}
 
-		friend euclidean_vector operator+(euclidean_vector const& a, euclidean_vector const& b) {
-			//NEED to add exception
-			/*Given: X = a.dimensions(), Y = b.dimensions()
-      When: X != Y
-      Throw: "Dimensions of LHS(X) and RHS(Y) do not match"
-	  */
-	  		if (a.dimensions_ != b.dimensions_) {
-				throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(a.dimensions_) +") and RHS(" +
-				std::to_string(b.dimensions_) + ") do not match");
+		//Bracketed text through to_chars, honouring the stream's precision and floatfield.
+		friend std::ostream& operator<<(std::ostream& os, basic_euclidean_vector const& a) {
+			return write_text(os, std::span<T const>(a.data_, a.dimensions_));
+		}
+
+		//Reads what operator<< writes; sets failbit and leaves `a` alone on malformed input.
+		friend std::istream& operator>>(std::istream& is, basic_euclidean_vector& a) {
+			std::istream::sentry const sentry(is);
+			if (not sentry) {
+				return is;
+			}
+			if (is.peek() != '[') {
+				is.setstate(std::ios_base::failbit);
+				return is;
+			}
+			auto text = std::string();
+			std::getline(is, text, ']');
+			if (is.eof()) {
+				is.setstate(std::ios_base::failbit);
+				return is;
 			}
-			auto tmp = euclidean_vector(a);
-			tmp += b;
-			return tmp;
+			text.push_back(']');
+			if (from_chars(text.data(), text.data() + text.size(), a).ec != std::errc{}) {
+				is.setstate(std::ios_base::failbit);
+			}
+			return is;
 		}
-		friend euclidean_vector operator-(euclidean_vector const& a, euclidean_vector const& b) {
-			//NEED to add exception
-			if (a.dimensions_ != b.dimensions_) {
-				throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(a.dimensions_) +") and RHS(" +
-				std::to_string(b.dimensions_) + ") do not match");
+
+		~basic_euclidean_vector() = default;
+
+		template<typename U, typename B>
+		friend B euclidean_norm(basic_euclidean_vector<U, B> const& v);
+		template<typename U, typename B>
+		friend B dot(basic_euclidean_vector<U, B> const& x, basic_euclidean_vector<U, B> const& y);
+		template<typename U, typename B>
+		friend basic_euclidean_vector<U, B> unit(basic_euclidean_vector<U, B> const& v);
+		template<typename U, typename B>
+		friend B cosine_similarity(basic_euclidean_vector<U, B> const& x, basic_euclidean_vector<U, B> const& y);
+		friend struct detail::vector_access;
+
+
+	private:
+		//Forgets the cached norm and dot product after a write. Two relaxed stores, so it stays cheap
+		//on the operator[] and at() paths.
+		void AdjustMutables() noexcept {
+			COMP6771_EUCLIDEAN_VECTOR_COUNT(cache_invalidations, norm_.load() or dot_.load());
+			norm_.reset();
+			dot_.reset();
+			updates_ = 0;
+		}
+
+		//Incremental cache updates for maintain_norm; both fall back to AdjustMutables.
+		void AdjustNorm(Accumulator const removed, Accumulator const added) noexcept;
+		void ScaleNorm(Accumulator const factor) noexcept;
+		bool KeepCache() noexcept;
+
+		//Points data_ at inline_ for small vectors and at a buffer from alloc_ otherwise.
+		void Allocate(std::size_t const size) {
+			if (size <= inline_capacity) {
+				magnitude_.reset();
+				data_ = inline_.data();
+			} else {
+				auto alloc = alloc_;
+				magnitude_ = buffer(alloc.allocate(size), deleter{alloc.resource(), size});
+				COMP6771_EUCLIDEAN_VECTOR_COUNT(allocations, 1);
+				COMP6771_EUCLIDEAN_VECTOR_COUNT(allocated_bytes, sizeof(T) * size);
+				data_ = magnitude_.get();
 			}
-			auto tmp = euclidean_vector(a);
-			tmp -= b;
-			return tmp;
+			dimensions_ = size;
 		}
 
-		friend euclidean_vector operator*(euclidean_vector const& a, double const& b) {
+		void StealFrom(basic_euclidean_vector &Orig) noexcept;
+		void Adopt(std::vector<T>&& v);
 
-			auto tmp = euclidean_vector(a);
-			tmp *= b;
-			return tmp;
+		//True when our buffer came from alloc_ and so can't be handed to a vector using another resource.
+		//Adopted buffers never come from alloc_.
+		bool OwnsResourceBuffer() const noexcept {
+			return magnitude_ != nullptr and magnitude_.get_deleter().adopted == nullptr;
 		}
 
-		friend euclidean_vector operator*(double const& b, euclidean_vector const& a) {
+		static constexpr std::size_t inline_capacity = COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY;
 
-			auto tmp = euclidean_vector(a);
-			tmp *= b;
-			return tmp;
+		std::size_t dimensions_;
+		//Filled in by euclidean_norm and dot(v, v), which may run concurrently on a const vector.
+		mutable detail::cached_value<Accumulator> norm_;
+		mutable detail::cached_value<Accumulator> dot_;
+		//Only touched through non-const paths, so they need not be atomic.
+		bool maintain_norm_ = false;
+		std::uint32_t updates_ = 0;
+		allocator_type alloc_;
+		using deleter = detail::basic_buffer_deleter<T>;
+		using buffer = std::unique_ptr<T[], deleter>;
+		buffer magnitude_;
+		std::array<T, inline_capacity> inline_;
+		T* data_ = inline_.data();
+	};
+
+	template<typename T, typename A>
+	A euclidean_norm(basic_euclidean_vector<T, A> const& v);
+	template<typename T, typename A>
+	A dot(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y);
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A> unit(basic_euclidean_vector<T, A> const& v);
+
+	//Each one pass over x and y, with no x - y built and nothing allocated; euclidean_norm(x - y)
+	//builds and norms a temporary. cosine_similarity reuses either vector's cached norm, and throws as
+	//unit does when either norm is zero.
+	template<typename T, typename A>
+	A squared_distance(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y);
+	template<typename T, typename A>
+	A euclidean_distance(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y);
+	template<typename T, typename A>
+	A cosine_similarity(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y);
+	template<typename T, typename A>
+	A manhattan_distance(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y);
+	template<typename T, typename A>
+	A chebyshev_distance(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y);
+
+	//The euclidean_vector_format.hpp conversions for one vector. On failure `v` is unchanged.
+	template<typename T, typename A>
+	std::to_chars_result to_chars(char* first, char* last, basic_euclidean_vector<T, A> const& v,
+	                              text_format const& format = {}) {
+		return to_chars(first, last, std::span<T const>(detail::vector_access::data(v), detail::vector_access::size(v)),
+		                format);
+	}
+
+	template<typename T, typename A>
+	std::from_chars_result from_chars(char const* first, char const* last, basic_euclidean_vector<T, A>& v,
+	                                  text_layout layout = text_layout::bracketed) {
+		auto magnitudes = std::vector<T>();
+		auto const result = from_chars(first, last, magnitudes, layout);
+		if (result.ec == std::errc{}) {
+			v = basic_euclidean_vector<T, A>(std::move(magnitudes), v.get_allocator());
+		}
+		return result;
+	}
+
+	namespace detail {
+		template<typename T, typename A>
+		T const* vector_access::data(basic_euclidean_vector<T, A> const& v) noexcept {
+			return v.data_;
+		}
+
+		template<typename T, typename A>
+		std::size_t vector_access::size(basic_euclidean_vector<T, A> const& v) noexcept {
+			return v.dimensions_;
+		}
+
+		template<typename T, typename A>
+		std::optional<A> vector_access::cached_squared_norm(basic_euclidean_vector<T, A> const& v) noexcept {
+			if (auto const dot = v.dot_.load()) {
+				return dot;
+			}
+			if (auto const norm = v.norm_.load()) {
+				return *norm * *norm;
+			}
+			return std::nullopt;
+		}
+
+		//Binary arithmetic builds nodes instead of temporaries; dimension checks still happen here,
+		//when the operator is called, exactly as they did for the eager operators.
+		//When an operand is an expiring vector the whole expression is instead evaluated into its
+		//buffer, so `euclidean_vector(a) + b + c` allocates only for the copy.
+		template<typename Op, vector_operand L, vector_operand R>
+		requires same_precision<L, R>
+		auto apply_binary(L&& a, R&& b) {
+			if constexpr (expiring_vector<L>) {
+				a = make_binary<Op>(a, std::forward<R>(b));
+				return L(std::move(a));
+			} else if constexpr (expiring_vector<R>) {
+				b = make_binary<Op>(std::forward<L>(a), b);
+				return R(std::move(b));
+			} else {
+				return make_binary<Op>(std::forward<L>(a), std::forward<R>(b));
+			}
+		}
+
+		template<vector_operand L, vector_operand R>
+		auto operator+(L&& a, R&& b) -> decltype(apply_binary<std::plus<>>(std::forward<L>(a), std::forward<R>(b))) {
+			return apply_binary<std::plus<>>(std::forward<L>(a), std::forward<R>(b));
+		}
+
+		template<vector_operand L, vector_operand R>
+		auto operator-(L&& a, R&& b) -> decltype(apply_binary<std::minus<>>(std::forward<L>(a), std::forward<R>(b))) {
+			return apply_binary<std::minus<>>(std::forward<L>(a), std::forward<R>(b));
 		}
 
-		friend euclidean_vector operator/(euclidean_vector const& a, double const& b) {
+		template<vector_operand E>
+		auto operator*(E&& a, value_t<E> const& b) {
+			if constexpr (expiring_vector<E>) {
+				a *= b;
+				return E(std::move(a));
+			} else {
+				return make_scalar<std::multiplies<>>(std::forward<E>(a), b);
+			}
+		}
+
+		template<vector_operand E>
+		auto operator*(value_t<E> const& b, E&& a) {
+			return std::forward<E>(a) * b;
+		}
 
-			//NEED to add exception
+		template<vector_operand E>
+		auto operator/(E&& a, value_t<E> const& b) {
 			if (std::abs(b-0) < 0.0001) {
 				throw euclidean_vector_error("Invalid vector division by 0");
 			}
-			auto tmp = euclidean_vector(a);
-			tmp /= b;
-			return tmp;
+			if constexpr (expiring_vector<E>) {
+				a /= b;
+				return E(std::move(a));
+			} else {
+				return make_scalar<std::divides<>>(std::forward<E>(a), b);
+			}
+		}
+
+		//Unary operators on vectors themselves stay members; these cover `-(a + b)` and friends.
+		template<vector_node E>
+		auto operator+(E&& a) {
+			return std::remove_cvref_t<E>(std::forward<E>(a));
+		}
+
+		template<vector_node E>
+		auto operator-(E&& a) {
+			return make_scalar<std::multiplies<>>(std::forward<E>(a), -1);
 		}
 
-		friend std::ostream& operator<<(std::ostream& os, euclidean_vector const& a) {
-			os << "[";
-			std::copy(a.magnitude_.get(), a.magnitude_.get()+a.dimensions_,
-					std::experimental::make_ostream_joiner(os, " "));
-			os << "]";
-			return os;
+		template<vector_operand L, vector_operand R>
+		requires ((vector_node<L> or vector_node<R>) and same_precision<L, R>)
+		bool operator==(L const& a, R const& b) {
+			auto const x = make_operand(a);
+			auto const y = make_operand(b);
+			if (x.size() != y.size()) {
+				return false;
+			}
+			for (std::size_t i = 0; i < x.size(); ++i) {
+				if (not (std::abs(x[i]-y[i]) < 0.0001)) {
+					return false;
+				}
+			}
+			return true;
 		}
 
-		~euclidean_vector() = default;
+		template<vector_node E>
+		std::ostream& operator<<(std::ostream& os, E const& expr) {
+			return os << basic_euclidean_vector<typename E::value_type>(expr);
+		}
 
-		friend double euclidean_norm(euclidean_vector const& v);
-		friend double dot(euclidean_vector const& x, euclidean_vector const& y);
-		friend euclidean_vector unit(euclidean_vector const& v);
+		//The free functions read an expression's elements directly, so `dot(a + b, c)` never
+		//materialises a + b.
+		template<vector_operand L, vector_operand R>
+		requires ((vector_node<L> or vector_node<R>) and same_precision<L, R>)
+		value_t<L> dot(L const& a, R const& b) {
+			auto const x = make_operand(a);
+			auto const y = make_operand(b);
+			check_dimensions(x.size(), y.size());
+			auto sum = value_t<L>{0};
+			for (std::size_t i = 0; i < x.size(); ++i) {
+				sum += x[i] * y[i];
+			}
+			return sum;
+		}
 
+		template<vector_node E>
+		typename E::value_type euclidean_norm(E const& expr) {
+			return std::sqrt(detail::dot(expr, expr));
+		}
 
-	private:
-		void AdjustMutables(bool const State, double const norm, double const dot) {
-			State_ = State;
-			norm_ = norm;
-			dot_ = dot;
+		template<vector_node E>
+		auto unit(E const& expr) {
+			return comp6771::unit(basic_euclidean_vector<typename E::value_type>(expr));
 		}
+	} // namespace detail
 
-		std::size_t dimensions_;
-		mutable bool State_;
-		mutable double norm_;
-		mutable double dot_;
-		std::unique_ptr<double[]> magnitude_;
-	};
-	double euclidean_norm(euclidean_vector const& v);
-	double dot(euclidean_vector const& x, euclidean_vector const& y);
-	euclidean_vector unit(euclidean_vector const& v);
+	using detail::operator+;
+	using detail::operator-;
+	using detail::operator*;
+	using detail::operator/;
+	using detail::operator==;
+	using detail::operator<<;
+	using detail::dot;
+	using detail::euclidean_norm;
+	using detail::unit;
 } // namespace comp6771
 #endif // COMP6771_EUCLIDEAN_VECTOR_HPP
@@ -0,0 +1,144 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace comp6771 {
+	enum class batch_layout { row_major, column_major };
+
+	//A read-only or writable window onto one row of a euclidean_vector_batch. Rows of a
+	//column-major batch are strided, so this is not simply a span.
+	template<typename T>
+	class basic_row_view {
+	public:
+		basic_row_view(T* data, std::size_t const size, std::size_t const stride) noexcept
+		: data_{data}, size_{size}, stride_{stride} {}
+
+		//A writable view converts to a read-only one.
+		template<typename U>
+		requires (std::is_const_v<T> and std::is_same_v<U const, T>)
+		basic_row_view(basic_row_view<U> const& other) noexcept
+		: data_{other.data()}, size_{static_cast<std::size_t>(other.dimensions())}, stride_{other.stride()} {}
+
+		T& operator[](int i) const noexcept { return data_[static_cast<std::size_t>(i) * stride_]; }
+
+		T& at(int i) const {
+			if (i < 0 or static_cast<std::size_t>(i) >= size_) {
+				throw euclidean_vector_error("Index " + std::to_string(i) +" is not valid for this euclidean_vector object");
+			}
+			return (*this)[i];
+		}
+
+		int dimensions() const noexcept { return static_cast<int>(size_); }
+		T* data() const noexcept { return data_; }
+		std::size_t stride() const noexcept { return stride_; }
+		bool contiguous() const noexcept { return stride_ == 1 or size_ <= 1; }
+
+		explicit operator euclidean_vector() const {
+			auto result = euclidean_vector(dimensions());
+			for (auto i = 0; i < dimensions(); ++i) {
+				result[i] = (*this)[i];
+			}
+			return result;
+		}
+
+	private:
+		T* data_;
+		std::size_t size_;
+		std::size_t stride_;
+	};
+
+	using row_view = basic_row_view<double>;
+	using const_row_view = basic_row_view<double const>;
+
+	//Many same-dimension vectors in one 64-byte aligned buffer. Each row (or, column-major, each
+	//column) is padded with zeros to a whole number of cache lines, so every row starts aligned and
+	//kernels may read up to stride() doubles of it.
+	class euclidean_vector_batch {
+	public:
+		using allocator_type = std::pmr::polymorphic_allocator<double>;
+
+		static constexpr std::size_t alignment = 64;
+
+		euclidean_vector_batch(int const rows, int const dimensions, batch_layout const layout = batch_layout::row_major,
+		                       allocator_type const& alloc = {});
+		//Copies `vectors` in; they must all have the same number of dimensions.
+		explicit euclidean_vector_batch(std::span<euclidean_vector const> vectors,
+		                                batch_layout const layout = batch_layout::row_major,
+		                                allocator_type const& alloc = {});
+
+		euclidean_vector_batch(euclidean_vector_batch const& other);
+		euclidean_vector_batch(euclidean_vector_batch&& other) noexcept;
+		euclidean_vector_batch& operator=(euclidean_vector_batch const& other);
+		euclidean_vector_batch& operator=(euclidean_vector_batch&& other);
+		~euclidean_vector_batch() = default;
+
+		int rows() const noexcept { return static_cast<int>(rows_); }
+		int dimensions() const noexcept { return static_cast<int>(dimensions_); }
+		batch_layout layout() const noexcept { return layout_; }
+		allocator_type get_allocator() const noexcept { return alloc_; }
+
+		//Distance in doubles between consecutive rows (row-major) or columns (column-major).
+		std::size_t leading_dimension() const noexcept { return leading_; }
+
+		double* data() noexcept { return data_.get(); }
+		double const* data() const noexcept { return data_.get(); }
+
+		row_view operator[](int row) noexcept;
+		const_row_view operator[](int row) const noexcept;
+		row_view row(int row);
+		const_row_view row(int row) const;
+
+		void set_row(int row, euclidean_vector const& v);
+
+		euclidean_vector_batch& operator+=(euclidean_vector_batch const& b);
+		euclidean_vector_batch& operator-=(euclidean_vector_batch const& b);
+		//Adds or subtracts `v` from every row.
+		euclidean_vector_batch& operator+=(euclidean_vector const& v);
+		euclidean_vector_batch& operator-=(euclidean_vector const& v);
+		euclidean_vector_batch& operator*=(double const& b);
+		euclidean_vector_batch& operator/=(double const& b);
+
+		friend bool operator==(euclidean_vector_batch const& a, euclidean_vector_batch const& b);
+
+	private:
+		void CheckRow(int row) const;
+		std::size_t Offset(std::size_t row, std::size_t dimension) const noexcept {
+			return layout_ == batch_layout::row_major ? row * leading_ + dimension : dimension * leading_ + row;
+		}
+		std::size_t Stride() const noexcept {
+			return layout_ == batch_layout::row_major ? 1 : leading_;
+		}
+		std::size_t BufferSize() const noexcept {
+			return leading_ * (layout_ == batch_layout::row_major ? rows_ : dimensions_);
+		}
+
+		std::size_t rows_;
+		std::size_t dimensions_;
+		batch_layout layout_;
+		std::size_t leading_;
+		allocator_type alloc_;
+		std::unique_ptr<double[], detail::buffer_deleter> data_;
+	};
+
+	//Row-by-row results, in row order.
+	std::vector<double> dot(euclidean_vector_batch const& x, euclidean_vector const& y);
+	std::vector<double> dot(euclidean_vector_batch const& x, euclidean_vector_batch const& y);
+	std::vector<double> euclidean_norm(euclidean_vector_batch const& v);
+	//Throws if any row has no unit vector.
+	euclidean_vector_batch unit(euclidean_vector_batch const& v);
+
+	namespace detail {
+		//`vectors` itself if it is already row-major, otherwise a row-major copy with the same
+		//allocator. For the indexes that walk whole rows.
+		euclidean_vector_batch row_major(euclidean_vector_batch vectors);
+	} // namespace detail
+} // namespace comp6771
+#endif // COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
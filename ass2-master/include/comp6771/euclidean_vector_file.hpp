@@ -0,0 +1,97 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_FILE_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_FILE_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+//A binary file of same-dimension vectors that can be mapped and used in place:
+//
+//    vector_file_header                 64 bytes, little-endian
+//    zero padding                       up to payload_offset
+//    count records of stride doubles    each holds dimensions magnitudes, then zeros
+//
+//stride is dimensions rounded up to a multiple of alignment / 8, so with the payload aligned too
+//every record starts on an alignment boundary of the mapping.
+namespace comp6771 {
+	enum class vector_file_dtype : std::uint32_t { float64 = 1 };
+
+	struct vector_file_header {
+		static constexpr std::uint64_t expected_magic = 0x4345'5631'3737'3643; //"C6771VEC", read little-endian
+		//2 since the checksum folds its high bits back in; version 1 files are not read.
+		static constexpr std::uint32_t current_version = 2;
+
+		std::uint64_t magic;
+		std::uint32_t version;
+		vector_file_dtype dtype;
+		std::uint64_t count;
+		std::uint64_t dimensions;
+		std::uint64_t alignment;      //In bytes; a power of two between 8 and 4096.
+		std::uint64_t payload_offset; //From the start of the file.
+		std::uint64_t checksum;       //vector_file_checksum of all count * stride doubles.
+		std::uint64_t reserved;
+	};
+	static_assert(sizeof(vector_file_header) == 64);
+
+	//FNV-1a over the payload taken as 64-bit words rather than bytes, which is eight times fewer
+	//steps. A multiply only carries a change upwards, so whole-word FNV-1a would lose sign bits off
+	//the top and let sign flips in pairs of magnitudes cancel; each step folds the high half back
+	//into the low half so that every bit keeps mixing into the steps after it.
+	std::uint64_t vector_file_checksum(std::span<double const> payload,
+	                                   std::uint64_t seed = 0xcbf2'9ce4'8422'2325) noexcept;
+
+	//Throws euclidean_vector_error if the vectors' dimensions differ or alignment is not valid, and
+	//std::system_error if the file can't be written.
+	void write_vector_file(std::filesystem::path const& path, std::span<euclidean_vector const> vectors,
+	                       std::size_t alignment = 64);
+	void write_vector_file(std::filesystem::path const& path, euclidean_vector_batch const& vectors,
+	                       std::size_t alignment = 64);
+
+	//A read-only, shared mapping of a vector file. Opening reads only the header, so it costs the
+	//same for any file size; pages are faulted in as records are touched and are shared with every
+	//other process mapping the same file.
+	class mapped_vector_file {
+	public:
+		//Throws euclidean_vector_error for a malformed header and std::system_error if the file
+		//can't be opened or mapped. The checksum is not checked; see verify().
+		explicit mapped_vector_file(std::filesystem::path const& path);
+
+		mapped_vector_file(mapped_vector_file const&) = delete;
+		mapped_vector_file& operator=(mapped_vector_file const&) = delete;
+		mapped_vector_file(mapped_vector_file&& other) noexcept;
+		mapped_vector_file& operator=(mapped_vector_file&& other) noexcept;
+		~mapped_vector_file();
+
+		int size() const noexcept { return static_cast<int>(header_.count); }
+		int dimensions() const noexcept { return static_cast<int>(header_.dimensions); }
+		std::size_t stride() const noexcept { return stride_; }
+		vector_file_header const& header() const noexcept { return header_; }
+
+		//A view of a record pointing straight into the mapping, so it works with dot, the norms and
+		//distances, == and << without a copy. It must not outlive the mapping.
+		const_euclidean_vector_view operator[](int i) const noexcept;
+		const_euclidean_vector_view record(int i) const;
+
+		//Owning copies, for when a record must outlive the mapping or be modified.
+		euclidean_vector load(int i, euclidean_vector::allocator_type const& alloc = {}) const;
+		euclidean_vector_batch load_batch(batch_layout layout = batch_layout::row_major,
+		                                  euclidean_vector_batch::allocator_type const& alloc = {}) const;
+
+		//Reads the whole payload and compares it with the header's checksum.
+		bool verify() const noexcept;
+
+	private:
+		void Unmap() noexcept;
+
+		void* mapping_ = nullptr;
+		std::size_t length_ = 0;
+		vector_file_header header_{};
+		double const* payload_ = nullptr;
+		std::size_t stride_ = 0;
+	};
+} // namespace comp6771
+#endif // COMP6771_EUCLIDEAN_VECTOR_FILE_HPP
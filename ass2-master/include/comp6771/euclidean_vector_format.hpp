@@ -0,0 +1,59 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_FORMAT_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_FORMAT_HPP
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <vector>
+
+//Locale-independent text for magnitudes, written into and read from caller buffers with
+//std::to_chars and std::from_chars. Nothing here allocates except to grow the output of
+//from_chars, and errors are reported through the returned errc, as the std functions do.
+namespace comp6771 {
+	enum class text_layout {
+		bracketed,  //"[1 2.5 -3]", as operator<< prints.
+		whitespace, //"1 2.5 -3", one vector per line.
+		csv,        //"1,2.5,-3", one vector per line.
+	};
+
+	struct text_format {
+		text_layout layout = text_layout::bracketed;
+		std::chars_format notation = std::chars_format::general;
+		//With no precision each magnitude is the shortest text that reads back to the same double.
+		std::optional<int> precision = std::nullopt;
+	};
+
+	//Enough chars for to_chars to write any `dimensions` magnitudes of type T in `format`.
+	template<std::floating_point T = double>
+	std::size_t max_chars(std::size_t dimensions, text_format const& format = {}) noexcept;
+
+	//Each of these comes in one overload per magnitude type: float, double and long double.
+
+	//Returns {last, std::errc::value_too_large} if the text does not fit. No terminator or newline
+	//is written.
+	std::to_chars_result to_chars(char* first, char* last, std::span<float const> magnitudes,
+	                              text_format const& format = {});
+	std::to_chars_result to_chars(char* first, char* last, std::span<double const> magnitudes,
+	                              text_format const& format = {});
+	std::to_chars_result to_chars(char* first, char* last, std::span<long double const> magnitudes,
+	                              text_format const& format = {});
+
+	//Appends the magnitudes of one vector to `magnitudes`. Bracketed text may span lines and the
+	//result points past the ']'; the line layouts stop at the end of the line, which is not
+	//consumed. On failure `magnitudes` is left as it was and the result points at the bad text.
+	std::from_chars_result from_chars(char const* first, char const* last, std::vector<float>& magnitudes,
+	                                  text_layout layout = text_layout::bracketed);
+	std::from_chars_result from_chars(char const* first, char const* last, std::vector<double>& magnitudes,
+	                                  text_layout layout = text_layout::bracketed);
+	std::from_chars_result from_chars(char const* first, char const* last, std::vector<long double>& magnitudes,
+	                                  text_layout layout = text_layout::bracketed);
+
+	//Bracketed text as operator<< writes it, honouring the stream's precision and floatfield.
+	std::ostream& write_text(std::ostream& os, std::span<float const> magnitudes);
+	std::ostream& write_text(std::ostream& os, std::span<double const> magnitudes);
+	std::ostream& write_text(std::ostream& os, std::span<long double const> magnitudes);
+} // namespace comp6771
+#endif // COMP6771_EUCLIDEAN_VECTOR_FORMAT_HPP
@@ -0,0 +1,53 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_KERNELS_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_KERNELS_HPP
+
+#include <cstddef>
+#include <string_view>
+
+// Hand-vectorised loops behind dot, euclidean_norm, the distances and the compound operators. One
+// binary carries every implementation; the widest one the host supports is chosen the first time it is needed.
+namespace comp6771::kernels {
+	enum class isa { scalar, sse2, avx2, avx512 };
+
+	//The shape of one dot_tile: the block of results kept in registers by the pairwise products.
+	inline constexpr std::size_t tile_rows = 4;
+	inline constexpr std::size_t tile_columns = 8;
+
+	//x.y, x.x and y.y, as gathered by one pass over both vectors.
+	struct fused_dot {
+		double xy;
+		double xx;
+		double yy;
+	};
+
+	struct kernel_table {
+		isa level;
+		double (*dot)(double const* x, double const* y, std::size_t n);
+		double (*squared_norm)(double const* x, std::size_t n);
+		//|x - y|^2 in one pass, without forming x - y.
+		double (*squared_distance)(double const* x, double const* y, std::size_t n);
+		//sum |x_i - y_i| and max |x_i - y_i|, likewise.
+		double (*manhattan_distance)(double const* x, double const* y, std::size_t n);
+		double (*chebyshev_distance)(double const* x, double const* y, std::size_t n);
+		fused_dot (*dot_and_squared_norms)(double const* x, double const* y, std::size_t n);
+		//Adds a[s] . b[s] over k steps to the tile_rows by tile_columns row-major block c, where step s
+		//of a holds tile_rows values and step s of b holds tile_columns: a packed panel of each side.
+		void (*dot_tile)(double const* a, double const* b, std::size_t k, double* c);
+		void (*add)(double* x, double const* y, std::size_t n);
+		void (*subtract)(double* x, double const* y, std::size_t n);
+		void (*multiply)(double* x, double b, std::size_t n);
+		void (*divide)(double* x, double b, std::size_t n);
+	};
+
+	// Whether this build has an implementation for `level` and the host can run it.
+	bool supported(isa level) noexcept;
+
+	// The table for `level`. Throws std::invalid_argument if `level` is not supported.
+	kernel_table const& table(isa level);
+
+	// The table picked by CPUID for this host.
+	kernel_table const& active() noexcept;
+
+	std::string_view name(isa level) noexcept;
+} // namespace comp6771::kernels
+#endif // COMP6771_EUCLIDEAN_VECTOR_KERNELS_HPP
@@ -0,0 +1,138 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_METRICS_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+// Counters for what euclidean_vector does behind its interface: heap allocations, copies and moves,
+// and how often the cached norm and self-dot are used or thrown away. Off by default.
+//
+// Counting is compiled in by the COMP6771_EUCLIDEAN_VECTOR_METRICS CMake option. Without it every
+// COMP6771_EUCLIDEAN_VECTOR_COUNT expands to nothing, its arguments are never evaluated, and the
+// functions below read zeros. Every translation unit should agree on the setting, like
+// COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY, or code compiled without it goes uncounted.
+//
+// Each thread counts into its own block with plain relaxed stores, so counting never contends.
+#ifndef COMP6771_EUCLIDEAN_VECTOR_METRICS
+#define COMP6771_EUCLIDEAN_VECTOR_METRICS 0
+#endif
+
+namespace comp6771::metrics {
+	inline constexpr bool enabled = COMP6771_EUCLIDEAN_VECTOR_METRICS != 0;
+
+	enum class counter : std::size_t {
+		// Magnitude buffers taken from a memory resource, and their size. Inline storage and adopted
+		// std::vector buffers allocate nothing.
+		allocations,
+		allocated_bytes,
+		// Copy construction and assignment, including conversions between precisions.
+		copies,
+		// Move construction and assignment. A move between memory resources copies, and counts as one.
+		moves,
+		// Magnitudes copied out of one vector into another or into a std::vector or std::list,
+		// including inline magnitudes that a move has to copy.
+		copied_bytes,
+		// Reads of the cached norm by euclidean_norm and cosine_similarity.
+		norm_cache_hits,
+		norm_cache_misses,
+		// dot(v, v) on a vector and itself.
+		dot_cache_hits,
+		dot_cache_misses,
+		// Writes that discarded a cached norm or self-dot. Writes to a vector with nothing cached, and
+		// maintain_norm adjustments, are not counted.
+		cache_invalidations,
+		// euclidean_vector_errors constructed, which is to say thrown.
+		errors,
+	};
+
+	inline constexpr std::size_t counter_count = static_cast<std::size_t>(counter::errors) + 1;
+
+	// The counter's name in write_prometheus output, without the prefix or `_total`.
+	std::string_view name(counter c) noexcept;
+
+	// A copy of a set of counters. Subtract an earlier snapshot to count what happened in between.
+	struct snapshot {
+		std::array<std::uint64_t, counter_count> values{};
+
+		std::uint64_t operator[](counter const c) const noexcept { return values[static_cast<std::size_t>(c)]; }
+
+		// Cached reads that hit, out of all cached reads; 0 when there were none.
+		double norm_hit_rate() const noexcept;
+		double dot_hit_rate() const noexcept;
+
+		friend snapshot operator-(snapshot lhs, snapshot const& rhs) noexcept {
+			for (std::size_t i = 0; i < counter_count; ++i) {
+				lhs.values[i] -= rhs.values[i];
+			}
+			return lhs;
+		}
+
+		friend bool operator==(snapshot const&, snapshot const&) = default;
+	};
+
+	// The calling thread's counters.
+	snapshot this_thread() noexcept;
+	void reset_this_thread() noexcept;
+
+	// Every thread's counters added up, including threads that have since exited. There is no
+	// matching reset, since other threads' counters are theirs to write; diff two snapshots instead.
+	snapshot all_threads();
+
+	// Prometheus text exposition format: a HELP line, a TYPE line and one sample per counter, each
+	// named <prefix>_<name>_total.
+	void write_prometheus(std::ostream& os, snapshot const& counters,
+	                      std::string_view prefix = "comp6771_euclidean_vector");
+
+	namespace detail {
+		struct registry;
+
+		// One thread's counters. Only the owning thread writes them, so an increment is a relaxed load
+		// and store rather than a locked read-modify-write; all_threads reads them from elsewhere.
+		// Links itself into the list all_threads reads on construction, which allocates nothing, and
+		// folds its totals in on exit.
+		class thread_counters {
+		public:
+			thread_counters() noexcept;
+			thread_counters(thread_counters const&) = delete;
+			thread_counters& operator=(thread_counters const&) = delete;
+			~thread_counters();
+
+			void add(counter const c, std::uint64_t const n) noexcept {
+				auto& value = values_[static_cast<std::size_t>(c)];
+				value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+			}
+
+			snapshot read() const noexcept;
+			void reset() noexcept;
+
+			// The next thread's counters in the registry's list.
+			thread_counters const* next() const noexcept { return next_; }
+
+		private:
+			// Adds our counts to the registry's retired totals. The caller holds its mutex.
+			void Retire(registry& shared) const noexcept;
+
+			std::array<std::atomic<std::uint64_t>, counter_count> values_{};
+			thread_counters* previous_ = nullptr;
+			thread_counters* next_ = nullptr;
+		};
+
+		inline thread_counters& local() noexcept {
+			thread_local auto counters = thread_counters();
+			return counters;
+		}
+	} // namespace detail
+} // namespace comp6771::metrics
+
+#if COMP6771_EUCLIDEAN_VECTOR_METRICS
+#define COMP6771_EUCLIDEAN_VECTOR_COUNT(name, n) \
+	::comp6771::metrics::detail::local().add(::comp6771::metrics::counter::name, static_cast<std::uint64_t>(n))
+#else
+#define COMP6771_EUCLIDEAN_VECTOR_COUNT(name, n) static_cast<void>(0)
+#endif
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_METRICS_HPP
@@ -0,0 +1,40 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_PAIRWISE_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_PAIRWISE_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include <span>
+
+// All-pairs products and distances between two sets of vectors, computed as a GEMM is rather than as
+// x.rows() * y.rows() separate dot calls.
+//
+// Both sides are packed into panels of kernels::tile_rows and kernels::tile_columns vectors, stored
+// dimension by dimension. The dimensions are then taken in blocks small enough that one panel of y
+// stays in L1 and a row block's panels of x stay in L2, while kernels::dot_tile keeps a whole tile of
+// results in registers. Blocks of the result are shared between threads with parallel::run when
+// parallel::set_thread_count has enabled the pool; each result is computed by one thread in a
+// fixed order, so results do not depend on the thread count.
+//
+// Each result is an x.rows() by y.rows() row-major batch: row i holds x[i] against every y[j].
+namespace comp6771 {
+	euclidean_vector_batch pairwise_dot(euclidean_vector_batch const& x, euclidean_vector_batch const& y,
+	                                    euclidean_vector_batch::allocator_type const& alloc = {});
+	euclidean_vector_batch pairwise_dot(std::span<euclidean_vector const> x, std::span<euclidean_vector const> y,
+	                                    euclidean_vector_batch::allocator_type const& alloc = {});
+
+	//|x[i]|^2 + |y[j]|^2 - 2 x[i].y[j], clamped at zero. The identity loses precision for points far
+	//closer together than they are to the origin; centre such data first. The span overloads reuse
+	//a norm or self-dot already cached on a vector, and leave the vectors' caches as they were.
+	euclidean_vector_batch pairwise_squared_distance(euclidean_vector_batch const& x, euclidean_vector_batch const& y,
+	                                                 euclidean_vector_batch::allocator_type const& alloc = {});
+	euclidean_vector_batch pairwise_squared_distance(std::span<euclidean_vector const> x,
+	                                                 std::span<euclidean_vector const> y,
+	                                                 euclidean_vector_batch::allocator_type const& alloc = {});
+
+	//The square roots of pairwise_squared_distance.
+	euclidean_vector_batch pairwise_distance(euclidean_vector_batch const& x, euclidean_vector_batch const& y,
+	                                         euclidean_vector_batch::allocator_type const& alloc = {});
+	euclidean_vector_batch pairwise_distance(std::span<euclidean_vector const> x, std::span<euclidean_vector const> y,
+	                                         euclidean_vector_batch::allocator_type const& alloc = {});
+} // namespace comp6771
+#endif // COMP6771_EUCLIDEAN_VECTOR_PAIRWISE_HPP
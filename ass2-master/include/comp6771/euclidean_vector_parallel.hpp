@@ -0,0 +1,39 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_PARALLEL_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_PARALLEL_HPP
+
+#include <cstddef>
+#include <functional>
+
+// Splits the kernels over a process-wide thread pool for very large vectors. Off by default.
+//
+// Anything longer than block_size is reduced as fixed block_size chunks whose partial sums are
+// added in block order, whether or not threads are enabled. Threads only change who computes each
+// block, so dot and euclidean_norm are bit-identical for any thread count.
+namespace comp6771::parallel {
+	inline constexpr std::size_t block_size = std::size_t{1} << 16;
+
+	// Worker threads to use, including the caller. 0 means std::thread::hardware_concurrency();
+	// 1 (the default) turns parallel execution off.
+	void set_thread_count(unsigned count);
+	unsigned thread_count() noexcept;
+
+	// Vectors shorter than this never use the pool. Defaults to 2^20 dimensions.
+	void set_threshold(std::size_t dimensions) noexcept;
+	std::size_t threshold() noexcept;
+
+	// Calls job(0) ... job(count - 1), spread over the pool when one is enabled, and returns once all
+	// have finished. Ignores threshold(): the caller decides the work is worth splitting. If a job
+	// throws, the jobs not yet started are skipped and the first exception is rethrown here once the
+	// others have finished. A job may call run, directly or through dot and friends on long vectors;
+	// the nested jobs then run one after another on the thread that called it.
+	void run(std::size_t count, std::function<void(std::size_t)> const& job);
+
+	// Same contracts as the kernel_table entries of the same name.
+	double dot(double const* x, double const* y, std::size_t n);
+	double squared_norm(double const* x, std::size_t n);
+	void add(double* x, double const* y, std::size_t n);
+	void subtract(double* x, double const* y, std::size_t n);
+	void multiply(double* x, double b, std::size_t n);
+	void divide(double* x, double b, std::size_t n);
+} // namespace comp6771::parallel
+#endif // COMP6771_EUCLIDEAN_VECTOR_PARALLEL_HPP
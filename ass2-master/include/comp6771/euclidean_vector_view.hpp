@@ -0,0 +1,106 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <string>
+
+namespace comp6771 {
+	//Non-owning windows onto magnitudes that live somewhere else: a std::vector, a network buffer,
+	//a mapped_vector_file record. Like std::span they are cheap to copy and never keep their
+	//magnitudes alive. They take part in arithmetic like any euclidean_vector, so `a + view`
+	//evaluates into a new, owning euclidean_vector.
+	//
+	//A writable view can't be taken of a euclidean_vector, since writes through it would bypass
+	//the vector's cached norm.
+	class const_euclidean_vector_view {
+	public:
+		const_euclidean_vector_view() noexcept = default;
+		explicit const_euclidean_vector_view(std::span<double const> magnitudes) noexcept : magnitudes_{magnitudes} {}
+		const_euclidean_vector_view(euclidean_vector const& v) noexcept
+		: magnitudes_{detail::vector_access::data(v), detail::vector_access::size(v)} {}
+
+		double operator[](int i) const noexcept {
+			assert(i >= 0 and static_cast<std::size_t>(i) < magnitudes_.size());
+			return magnitudes_[static_cast<std::size_t>(i)];
+		}
+
+		double at(int i) const;
+		int dimensions() const noexcept { return static_cast<int>(magnitudes_.size()); }
+		double const* data() const noexcept { return magnitudes_.data(); }
+		std::span<double const> magnitudes() const noexcept { return magnitudes_; }
+
+		explicit operator euclidean_vector() const;
+
+	private:
+		std::span<double const> magnitudes_;
+	};
+
+	//Compound assignment writes straight into the viewed magnitudes. A view is shallow-const like
+	//std::span: a const view still writes through.
+	class euclidean_vector_view {
+	public:
+		euclidean_vector_view() noexcept = default;
+		explicit euclidean_vector_view(std::span<double> magnitudes) noexcept : magnitudes_{magnitudes} {}
+
+		operator const_euclidean_vector_view() const noexcept { return const_euclidean_vector_view(magnitudes_); }
+
+		double& operator[](int i) const noexcept {
+			assert(i >= 0 and static_cast<std::size_t>(i) < magnitudes_.size());
+			return magnitudes_[static_cast<std::size_t>(i)];
+		}
+
+		double& at(int i) const;
+		int dimensions() const noexcept { return static_cast<int>(magnitudes_.size()); }
+		double* data() const noexcept { return magnitudes_.data(); }
+		std::span<double> magnitudes() const noexcept { return magnitudes_; }
+
+		explicit operator euclidean_vector() const;
+
+		euclidean_vector_view const& operator+=(const_euclidean_vector_view b) const;
+		euclidean_vector_view const& operator-=(const_euclidean_vector_view b) const;
+		euclidean_vector_view const& operator*=(double const& b) const;
+		euclidean_vector_view const& operator/=(double const& b) const;
+
+		//As for euclidean_vector, nodes only read index i when producing element i, so the result
+		//can be written in place even when the expression reads this view.
+		template<detail::vector_node E>
+		euclidean_vector_view const& operator+=(E const& expr) const {
+			return Assign(detail::make_binary<std::plus<>>(*this, expr));
+		}
+
+		template<detail::vector_node E>
+		euclidean_vector_view const& operator-=(E const& expr) const {
+			return Assign(detail::make_binary<std::minus<>>(*this, expr));
+		}
+
+	private:
+		template<typename E>
+		euclidean_vector_view const& Assign(E const& expr) const {
+			for (std::size_t i = 0; i < magnitudes_.size(); ++i) {
+				magnitudes_[i] = expr[i];
+			}
+			return *this;
+		}
+
+		std::span<double> magnitudes_;
+	};
+
+	//Any mix of views and euclidean_vectors; a view's norm is not cached, as it can't see writes to
+	//the magnitudes it watches.
+	double dot(const_euclidean_vector_view x, const_euclidean_vector_view y);
+	double euclidean_norm(const_euclidean_vector_view v);
+	//As for euclidean_vector, less the norm cache.
+	double squared_distance(const_euclidean_vector_view x, const_euclidean_vector_view y);
+	double euclidean_distance(const_euclidean_vector_view x, const_euclidean_vector_view y);
+	double cosine_similarity(const_euclidean_vector_view x, const_euclidean_vector_view y);
+	double manhattan_distance(const_euclidean_vector_view x, const_euclidean_vector_view y);
+	double chebyshev_distance(const_euclidean_vector_view x, const_euclidean_vector_view y);
+
+	bool operator==(const_euclidean_vector_view a, const_euclidean_vector_view b);
+	std::ostream& operator<<(std::ostream& os, const_euclidean_vector_view v);
+} // namespace comp6771
+#endif // COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
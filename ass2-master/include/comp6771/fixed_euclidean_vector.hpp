@@ -0,0 +1,210 @@
+#ifndef COMP6771_FIXED_EUCLIDEAN_VECTOR_HPP
+#define COMP6771_FIXED_EUCLIDEAN_VECTOR_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace comp6771 {
+	namespace detail {
+		//std::sqrt is not constexpr until C++26, so constant evaluation uses Newton's method.
+		constexpr double constexpr_sqrt(double const x) {
+			if (not std::is_constant_evaluated()) {
+				return std::sqrt(x);
+			}
+			if (x == 0.0 or x == std::numeric_limits<double>::infinity()) {
+				return x;
+			}
+			if (x < 0.0 or x != x) {
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+			auto current = x < 1.0 ? 1.0 : x;
+			auto previous = 0.0;
+			while (current != previous) {
+				previous = current;
+				current = 0.5 * (current + x / current);
+				if (current >= previous) {
+					//Newton's method approaches the root from above; stop once it can't improve.
+					return previous;
+				}
+			}
+			return current;
+		}
+
+		//Loops over [0, N) as a fold expression, i.e. fully unrolled, for the small sizes geometry
+		//code uses, and as an ordinary loop beyond that.
+		inline constexpr std::size_t unroll_limit = 16;
+
+		template<std::size_t N, typename F>
+		constexpr void static_for(F&& f) {
+			if constexpr (N <= unroll_limit) {
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					(f(I), ...);
+				}(std::make_index_sequence<N>{});
+			} else {
+				for (std::size_t i = 0; i < N; ++i) {
+					f(i);
+				}
+			}
+		}
+	} // namespace detail
+
+	//A euclidean_vector whose dimension count is part of its type. Magnitudes live in a std::array,
+	//everything is constexpr, and mixing dimensions is a compile error rather than a
+	//euclidean_vector_error.
+	template<std::size_t N>
+	class fixed_euclidean_vector {
+	public:
+		constexpr fixed_euclidean_vector() noexcept = default;
+
+		template<typename... T>
+		requires (sizeof...(T) == N and (std::convertible_to<T, double> and ...))
+		constexpr fixed_euclidean_vector(T const... magnitudes) noexcept
+		: magnitude_{static_cast<double>(magnitudes)...} {}
+
+		constexpr explicit fixed_euclidean_vector(std::array<double, N> const& magnitudes) noexcept
+		: magnitude_{magnitudes} {}
+
+		//The only conversion whose dimensions can't be checked at compile time.
+		explicit fixed_euclidean_vector(euclidean_vector const& v) {
+			detail::check_dimensions(N, detail::vector_access::size(v));
+			auto const* data = detail::vector_access::data(v);
+			detail::static_for<N>([&](std::size_t i) { magnitude_[i] = data[i]; });
+		}
+
+		explicit operator euclidean_vector() const {
+			auto result = euclidean_vector(static_cast<int>(N));
+			for (std::size_t i = 0; i < N; ++i) {
+				result[static_cast<int>(i)] = magnitude_[i];
+			}
+			return result;
+		}
+
+		constexpr double operator[](std::size_t i) const { return magnitude_[i]; }
+		constexpr double& operator[](std::size_t i) { return magnitude_[i]; }
+
+		constexpr double at(int i) const {
+			if (i < 0 or static_cast<std::size_t>(i) >= N) {
+				throw euclidean_vector_error("Index " + std::to_string(i) +" is not valid for this euclidean_vector object");
+			}
+			return magnitude_[static_cast<std::size_t>(i)];
+		}
+
+		constexpr double& at(int i) {
+			if (i < 0 or static_cast<std::size_t>(i) >= N) {
+				throw euclidean_vector_error("Index " + std::to_string(i) +" is not valid for this euclidean_vector object");
+			}
+			return magnitude_[static_cast<std::size_t>(i)];
+		}
+
+		static constexpr int dimensions() noexcept { return static_cast<int>(N); }
+
+		constexpr std::array<double, N> const& magnitudes() const noexcept { return magnitude_; }
+
+		constexpr fixed_euclidean_vector operator+() const noexcept { return *this; }
+
+		constexpr fixed_euclidean_vector operator-() const noexcept {
+			auto tmp = *this;
+			tmp *= -1;
+			return tmp;
+		}
+
+		constexpr fixed_euclidean_vector& operator+=(fixed_euclidean_vector const& b) noexcept {
+			detail::static_for<N>([&](std::size_t i) { magnitude_[i] += b.magnitude_[i]; });
+			return *this;
+		}
+
+		constexpr fixed_euclidean_vector& operator-=(fixed_euclidean_vector const& b) noexcept {
+			detail::static_for<N>([&](std::size_t i) { magnitude_[i] -= b.magnitude_[i]; });
+			return *this;
+		}
+
+		constexpr fixed_euclidean_vector& operator*=(double const b) noexcept {
+			detail::static_for<N>([&](std::size_t i) { magnitude_[i] *= b; });
+			return *this;
+		}
+
+		constexpr fixed_euclidean_vector& operator/=(double const b) {
+			if ((b < 0 ? -b : b) < 0.0001) {
+				throw euclidean_vector_error("Invalid vector division by 0");
+			}
+			detail::static_for<N>([&](std::size_t i) { magnitude_[i] /= b; });
+			return *this;
+		}
+
+		friend constexpr bool operator==(fixed_euclidean_vector const& a, fixed_euclidean_vector const& b) noexcept {
+			auto equal = true;
+			detail::static_for<N>([&](std::size_t i) {
+				auto const d = a.magnitude_[i] - b.magnitude_[i];
+				equal = equal and (d < 0 ? -d : d) < 0.0001;
+			});
+			return equal;
+		}
+
+		friend constexpr fixed_euclidean_vector operator+(fixed_euclidean_vector a, fixed_euclidean_vector const& b) noexcept {
+			return a += b;
+		}
+
+		friend constexpr fixed_euclidean_vector operator-(fixed_euclidean_vector a, fixed_euclidean_vector const& b) noexcept {
+			return a -= b;
+		}
+
+		friend constexpr fixed_euclidean_vector operator*(fixed_euclidean_vector a, double const b) noexcept {
+			return a *= b;
+		}
+
+		friend constexpr fixed_euclidean_vector operator*(double const b, fixed_euclidean_vector a) noexcept {
+			return a *= b;
+		}
+
+		friend constexpr fixed_euclidean_vector operator/(fixed_euclidean_vector a, double const b) {
+			return a /= b;
+		}
+
+		friend std::ostream& operator<<(std::ostream& os, fixed_euclidean_vector const& a) {
+			os << "[";
+			for (std::size_t i = 0; i < N; ++i) {
+				os << (i == 0 ? "" : " ") << a.magnitude_[i];
+			}
+			os << "]";
+			return os;
+		}
+
+	private:
+		std::array<double, N> magnitude_{};
+	};
+
+	template<typename... T>
+	fixed_euclidean_vector(T...) -> fixed_euclidean_vector<sizeof...(T)>;
+
+	template<std::size_t N>
+	constexpr double dot(fixed_euclidean_vector<N> const& x, fixed_euclidean_vector<N> const& y) noexcept {
+		//Same left-to-right summation order as the dynamic scalar kernel.
+		auto r = 0.0;
+		detail::static_for<N>([&](std::size_t i) { r += x[i] * y[i]; });
+		return r;
+	}
+
+	template<std::size_t N>
+	constexpr double euclidean_norm(fixed_euclidean_vector<N> const& v) noexcept {
+		return detail::constexpr_sqrt(comp6771::dot(v, v));
+	}
+
+	template<std::size_t N>
+	requires (N > 0)
+	constexpr fixed_euclidean_vector<N> unit(fixed_euclidean_vector<N> const& v) {
+		auto const d = comp6771::euclidean_norm(v);
+		if (d < 0.0001) {
+			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a unit vector");
+		}
+		return v / d;
+	}
+} // namespace comp6771
+#endif // COMP6771_FIXED_EUCLIDEAN_VECTOR_HPP
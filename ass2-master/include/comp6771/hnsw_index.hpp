@@ -0,0 +1,112 @@
+#ifndef COMP6771_HNSW_INDEX_HPP
+#define COMP6771_HNSW_INDEX_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include "comp6771/knn_index.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory_resource>
+#include <random>
+#include <shared_mutex>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	struct hnsw_parameters {
+		//Links per node on the upper layers; layer 0 keeps up to 2 * m.
+		int m = 16;
+		//Candidates kept while finding an inserted vector's neighbours.
+		int ef_construction = 200;
+		//Candidates kept while searching; raised to k when k is larger.
+		int ef_search = 64;
+		//Seeds the level each vector is inserted at, so builds are reproducible.
+		std::uint64_t seed = 6771;
+	};
+
+	//Approximate nearest-neighbour search over a hierarchical navigable small world graph
+	//(Malkov & Yashunin, 2018). Each vector joins layer 0 and, with geometrically falling
+	//probability, the layers above; a search descends greedily from the top layer and then runs a
+	//beam of ef_search candidates over layer 0.
+	//Scores mean what they do for knn_index, so its results serve as ground truth for recall.
+	//Vectors are stored row by row in one buffer, cosine ones normalised on insert.
+	//
+	//Searches may run concurrently with each other and with insert(); an insert waits for running
+	//searches and blocks new ones until it has linked its vector in.
+	class hnsw_index {
+	public:
+		using allocator_type = std::pmr::polymorphic_allocator<>;
+
+		explicit hnsw_index(int dimensions, distance_metric metric = distance_metric::l2,
+		                    hnsw_parameters const& parameters = {}, allocator_type const& alloc = {});
+
+		hnsw_index(hnsw_index const&) = delete;
+		hnsw_index& operator=(hnsw_index const&) = delete;
+		hnsw_index(hnsw_index&& other) noexcept;
+		//Keeps this index's memory resource, like the std::pmr containers it holds; when other's
+		//differs its contents are copied, which may throw.
+		hnsw_index& operator=(hnsw_index&& other);
+		~hnsw_index() = default;
+
+		//Adds `v` and returns its index, which is size() before the call.
+		int insert(const_euclidean_vector_view v);
+		void insert(std::span<euclidean_vector const> vectors);
+
+		//Up to k approximate nearest neighbours of `query`, best first.
+		std::vector<neighbour> search(const_euclidean_vector_view query, int k) const;
+
+		int size() const;
+		int dimensions() const noexcept { return dimensions_; }
+		distance_metric metric() const noexcept { return metric_; }
+		hnsw_parameters const& parameters() const noexcept { return parameters_; }
+		void set_ef_search(int ef);
+
+		//The vector stored for index i; normalised for a cosine index.
+		const_euclidean_vector_view operator[](int i) const noexcept;
+
+		//Writes the vectors, graph and parameters. load() gives back an index that searches exactly
+		//as this one does. Throws std::system_error on I/O failure.
+		void save(std::filesystem::path const& path) const;
+		static hnsw_index load(std::filesystem::path const& path, allocator_type const& alloc = {});
+
+	private:
+		struct candidate {
+			double distance;
+			int index;
+		};
+
+		double Distance(double const* query, int index) const noexcept;
+		double const* Vector(int index) const noexcept;
+		//Links of `index` on `layer`: a count followed by up to MaxLinks(layer) indices.
+		int* Links(int index, int layer) noexcept;
+		int const* Links(int index, int layer) const noexcept;
+		std::size_t MaxLinks(int layer) const noexcept;
+
+		int GreedyClosest(double const* query, int entry, int layer) const;
+		std::vector<candidate> SearchLayer(double const* query, std::vector<candidate> entries, std::size_t ef,
+		                                   int layer) const;
+		//Keeps at most `count` of `candidates` that are closer to the query than to each other.
+		std::vector<candidate> SelectNeighbours(std::vector<candidate> candidates, std::size_t count) const;
+		void Connect(int index, int layer, std::vector<candidate> const& neighbours);
+		int RandomLevel();
+
+		int dimensions_;
+		distance_metric metric_;
+		hnsw_parameters parameters_;
+		double level_factor_;
+		std::mt19937_64 engine_;
+
+		std::pmr::vector<double> vectors_;
+		std::pmr::vector<int> levels_;
+		//Layer 0 links for every node, at a fixed stride of 1 + 2m ints.
+		std::pmr::vector<int> base_links_;
+		//Layers 1 ... level for every node with a level above 0, each 1 + m ints.
+		std::pmr::vector<std::pmr::vector<int>> upper_links_;
+		int entry_point_ = -1;
+		int max_level_ = -1;
+
+		mutable std::shared_mutex mutex_;
+	};
+} // namespace comp6771
+#endif // COMP6771_HNSW_INDEX_HPP
@@ -0,0 +1,63 @@
+#ifndef COMP6771_KMEANS_HPP
+#define COMP6771_KMEANS_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	enum class kmeans_init {
+		//Each further centroid drawn with probability proportional to its squared distance from the
+		//nearest one already chosen (Arthur & Vassilvitskii, 2007).
+		kmeans_plus_plus,
+		//k distinct points drawn uniformly.
+		random,
+	};
+
+	enum class kmeans_algorithm {
+		//Every point against every centroid, every iteration.
+		lloyd,
+		//Lloyd's result with one upper and one lower bound per point, skipping most distance
+		//computations once clusters settle (Hamerly, 2010). The default: O(n) extra memory.
+		hamerly,
+		//Lloyd's result with a lower bound per point and centroid (Elkan, 2003). Prunes more than
+		//hamerly for large k, at the price of n * k bounds.
+		elkan,
+		//Centroids nudged towards random samples of batch_size points with per-centroid learning rates
+		//(Sculley, 2010). Much cheaper per iteration, for an approximate result.
+		mini_batch,
+	};
+
+	struct kmeans_parameters {
+		kmeans_init init = kmeans_init::kmeans_plus_plus;
+		kmeans_algorithm algorithm = kmeans_algorithm::hamerly;
+		int max_iterations = 100;
+		//Converged once no centroid moves further than this in an iteration.
+		double tolerance = 1e-4;
+		//Points sampled per mini_batch iteration.
+		int batch_size = 1024;
+		//Seeds initialisation and sampling, so runs are reproducible.
+		std::uint64_t seed = 6771;
+	};
+
+	struct kmeans_result {
+		std::vector<euclidean_vector> centroids;
+		//The closest centroid to each point, by index into centroids.
+		std::vector<int> assignments;
+		//The sum of squared distances from each point to its centroid.
+		double inertia;
+		int iterations;
+		bool converged;
+	};
+
+	//Clusters `points` into k groups. Assignment steps, and the final assignment every algorithm ends
+	//with, share the points between threads when parallel::set_thread_count has enabled the pool.
+	//Points are split into fixed-size chunks and centroids summed in point order, so the result depends
+	//on the seed but never on the thread count. A centroid left with no points stays where it was.
+	//Throws unless 1 <= k <= the number of points.
+	kmeans_result kmeans(std::span<euclidean_vector const> points, int k, kmeans_parameters const& parameters = {});
+	kmeans_result kmeans(euclidean_vector_batch const& points, int k, kmeans_parameters const& parameters = {});
+} // namespace comp6771
+#endif // COMP6771_KMEANS_HPP
@@ -0,0 +1,63 @@
+#ifndef COMP6771_KNN_INDEX_HPP
+#define COMP6771_KNN_INDEX_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	//What a search ranks by, and what neighbour::score holds:
+	//  * l2: the squared euclidean distance, smallest first;
+	//  * inner_product: the dot product, largest first;
+	//  * cosine: the cosine similarity, largest first.
+	enum class distance_metric { l2, inner_product, cosine };
+
+	struct neighbour {
+		int index;
+		double score;
+
+		friend bool operator==(neighbour const&, neighbour const&) = default;
+	};
+
+	//Exact k-nearest-neighbour search by scanning every vector, meant both for small collections and
+	//as the ground truth approximate indexes are measured against.
+	//The vectors are held in one row-major euclidean_vector_batch, and each score is a single fused
+	//kernel call with no temporaries. When parallel::set_thread_count has enabled the thread pool, a
+	//search splits the rows between threads, each keeping its own bounded heap, and merges them.
+	//Equal scores are ordered by index, so results never depend on the thread count.
+	class knn_index {
+	public:
+		using allocator_type = euclidean_vector_batch::allocator_type;
+
+		//A column-major batch is copied into row-major order.
+		explicit knn_index(euclidean_vector_batch vectors, distance_metric metric = distance_metric::l2);
+		explicit knn_index(std::span<euclidean_vector const> vectors, distance_metric metric = distance_metric::l2,
+		                   allocator_type const& alloc = {});
+
+		int size() const noexcept { return vectors_.rows(); }
+		int dimensions() const noexcept { return vectors_.dimensions(); }
+		distance_metric metric() const noexcept { return metric_; }
+		euclidean_vector_batch const& vectors() const noexcept { return vectors_; }
+
+		//The min(k, size()) best vectors for `query`, best first.
+		std::vector<neighbour> search(const_euclidean_vector_view query, int k) const;
+		//search() for every row of `queries`, in row order. Queries are shared between threads
+		//rather than each query's rows.
+		std::vector<std::vector<neighbour>> search_batch(euclidean_vector_batch const& queries, int k) const;
+
+	private:
+		//Scores rows [first, last) against `query` into a heap of at most k entries.
+		void Scan(double const* query, double query_norm, int first, int last, std::size_t k,
+		          std::vector<neighbour>& heap) const;
+		double QueryNorm(double const* query) const;
+		std::vector<neighbour> Search(double const* query, double query_norm, std::size_t k, bool split) const;
+
+		euclidean_vector_batch vectors_;
+		distance_metric metric_;
+		//Row norms, for cosine only.
+		std::vector<double> norms_;
+	};
+} // namespace comp6771
+#endif // COMP6771_KNN_INDEX_HPP
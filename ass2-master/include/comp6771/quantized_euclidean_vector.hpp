@@ -0,0 +1,124 @@
+#ifndef COMP6771_QUANTIZED_EUCLIDEAN_VECTOR_HPP
+#define COMP6771_QUANTIZED_EUCLIDEAN_VECTOR_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace comp6771 {
+	//How the [scale, offset] pair is chosen from the magnitudes being quantized.
+	//  * min_max maps the smallest magnitude to the lowest code and the largest to the highest.
+	//  * symmetric maps [-m, m] onto the codes, m being the largest absolute magnitude. With int8
+	//    codes this keeps 0.0 exact and the offset 0, at the cost of code -128.
+	enum class calibration { min_max, symmetric };
+
+	//Whether every row of a batch gets its own range, or the whole batch shares one.
+	enum class calibration_scope { per_vector, per_batch };
+
+	//A lossy, read-only copy of a euclidean_vector holding one 8-bit code per magnitude, so it needs
+	//an eighth of the memory. Magnitude i reads back as scale() * codes()[i] + offset().
+	//dot and squared_distance run on the integer codes, then correct for scale and offset; use them
+	//to score candidates and re-rank the best with the exact euclidean_vector.
+	template<typename Code>
+	class basic_quantized_euclidean_vector {
+		static_assert(std::is_same_v<Code, std::int8_t> or std::is_same_v<Code, std::uint8_t>,
+		              "codes must be std::int8_t or std::uint8_t");
+
+	public:
+		using code_type = Code;
+		using allocator_type = std::pmr::polymorphic_allocator<Code>;
+
+		explicit basic_quantized_euclidean_vector(euclidean_vector const& v, calibration mode = calibration::min_max,
+		                                          allocator_type const& alloc = {});
+		explicit basic_quantized_euclidean_vector(const_row_view v, calibration mode = calibration::min_max,
+		                                          allocator_type const& alloc = {});
+		//Uses the given range rather than calibrating; magnitudes outside it are clamped, and
+		//max_error() grows to match.
+		basic_quantized_euclidean_vector(euclidean_vector const& v, double scale, double offset,
+		                                 allocator_type const& alloc = {});
+		basic_quantized_euclidean_vector(const_row_view v, double scale, double offset, allocator_type const& alloc = {});
+
+		basic_quantized_euclidean_vector(basic_quantized_euclidean_vector const& other) = default;
+		basic_quantized_euclidean_vector(basic_quantized_euclidean_vector&& other) noexcept = default;
+		basic_quantized_euclidean_vector& operator=(basic_quantized_euclidean_vector const& other) = default;
+		basic_quantized_euclidean_vector& operator=(basic_quantized_euclidean_vector&& other) = default;
+		~basic_quantized_euclidean_vector() = default;
+
+		//Dequantizes.
+		explicit operator euclidean_vector() const;
+
+		double operator[](int i) const noexcept {
+			return scale_ * codes_[static_cast<std::size_t>(i)] + offset_;
+		}
+		double at(int i) const;
+
+		int dimensions() const noexcept { return static_cast<int>(codes_.size()); }
+		double scale() const noexcept { return scale_; }
+		double offset() const noexcept { return offset_; }
+		std::span<Code const> codes() const noexcept { return codes_; }
+		allocator_type get_allocator() const noexcept { return codes_.get_allocator(); }
+
+		//The largest |v[i] - (*this)[i]| over the magnitudes this was built from. At most scale() / 2
+		//unless magnitudes were clamped.
+		double max_error() const noexcept { return max_error_; }
+
+		template<typename C>
+		friend double dot(basic_quantized_euclidean_vector<C> const& x, basic_quantized_euclidean_vector<C> const& y);
+		template<typename C>
+		friend double squared_distance(basic_quantized_euclidean_vector<C> const& x,
+		                               basic_quantized_euclidean_vector<C> const& y);
+		template<typename C>
+		friend double dot_error_bound(basic_quantized_euclidean_vector<C> const& x,
+		                              basic_quantized_euclidean_vector<C> const& y);
+
+	private:
+		void Quantize(double const* magnitudes, std::size_t stride);
+
+		double scale_;
+		double offset_;
+		double max_error_ = 0.0;
+		//Sums over the codes and over the dequantized magnitudes, fixed at construction, that let
+		//dot and squared_distance correct an integer result for scale and offset.
+		std::int64_t code_sum_ = 0;
+		std::int64_t code_squares_ = 0;
+		double l1_norm_ = 0.0;
+		std::pmr::vector<Code> codes_;
+	};
+
+	using quantized_euclidean_vector = basic_quantized_euclidean_vector<std::int8_t>;
+	using uint8_quantized_euclidean_vector = basic_quantized_euclidean_vector<std::uint8_t>;
+
+	//Quantizes every row, in row order. per_batch calibrates once over the whole batch, which
+	//also lets squared_distance between its rows stay in integers throughout.
+	template<typename Code = std::int8_t>
+	std::vector<basic_quantized_euclidean_vector<Code>>
+	quantize(euclidean_vector_batch const& batch, calibration mode = calibration::min_max,
+	         calibration_scope scope = calibration_scope::per_vector);
+
+	//The dot product of the dequantized vectors.
+	template<typename Code>
+	double dot(basic_quantized_euclidean_vector<Code> const& x, basic_quantized_euclidean_vector<Code> const& y);
+
+	//The squared euclidean distance between the dequantized vectors. Exact in integers when both
+	//share a scale and offset; otherwise expanded as |x|^2 + |y|^2 - 2 x.y.
+	template<typename Code>
+	double squared_distance(basic_quantized_euclidean_vector<Code> const& x,
+	                        basic_quantized_euclidean_vector<Code> const& y);
+
+	//Bounds |dot(x, y) - dot(a, b)|, where a and b are the vectors x and y were built from, by
+	//max_error() of each side. Floating-point rounding in either dot is not included.
+	template<typename Code>
+	double dot_error_bound(basic_quantized_euclidean_vector<Code> const& x,
+	                       basic_quantized_euclidean_vector<Code> const& y);
+
+	//The same for squared_distance, given the distance it returned.
+	template<typename Code>
+	double squared_distance_error_bound(basic_quantized_euclidean_vector<Code> const& x,
+	                                    basic_quantized_euclidean_vector<Code> const& y, double squared_distance);
+} // namespace comp6771
+#endif // COMP6771_QUANTIZED_EUCLIDEAN_VECTOR_HPP
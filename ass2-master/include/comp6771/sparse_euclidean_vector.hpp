@@ -0,0 +1,106 @@
+#ifndef COMP6771_SPARSE_EUCLIDEAN_VECTOR_HPP
+#define COMP6771_SPARSE_EUCLIDEAN_VECTOR_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	//A euclidean_vector that stores only its nonzero magnitudes, as index/value pairs sorted by
+	//index in two parallel arrays. Storage and the cost of every operation grow with nonzeros(),
+	//not dimensions(). Memory resources follow the same rules as euclidean_vector.
+	class sparse_euclidean_vector {
+	public:
+		using allocator_type = std::pmr::polymorphic_allocator<double>;
+
+		explicit sparse_euclidean_vector(int const dimensions, allocator_type const& alloc = {});
+		//Entries may come in any order; a repeated index keeps its last value.
+		sparse_euclidean_vector(int const dimensions, std::initializer_list<std::pair<int, double>> entries,
+		                        allocator_type const& alloc = {});
+		//Keeps the magnitudes of `v` that are not exactly zero.
+		explicit sparse_euclidean_vector(euclidean_vector const& v, allocator_type const& alloc = {});
+
+		sparse_euclidean_vector(sparse_euclidean_vector const& other) = default;
+		sparse_euclidean_vector(sparse_euclidean_vector const& other, allocator_type const& alloc);
+		sparse_euclidean_vector(sparse_euclidean_vector&& other) noexcept = default;
+		sparse_euclidean_vector& operator=(sparse_euclidean_vector const& other) = default;
+		sparse_euclidean_vector& operator=(sparse_euclidean_vector&& other) = default;
+		~sparse_euclidean_vector() = default;
+
+		explicit operator euclidean_vector() const;
+
+		//O(log nonzeros()). Absent dimensions read as 0.
+		double operator[](int i) const;
+		double at(int i) const;
+		//Inserts, overwrites or, for 0, erases the entry for i.
+		void set(int i, double value);
+
+		int dimensions() const noexcept { return dimensions_; }
+		int nonzeros() const noexcept { return static_cast<int>(indices_.size()); }
+		std::span<int const> indices() const noexcept { return indices_; }
+		std::span<double const> values() const noexcept { return values_; }
+		allocator_type get_allocator() const noexcept { return values_.get_allocator(); }
+
+		sparse_euclidean_vector operator+() const;
+		sparse_euclidean_vector operator-() const;
+		sparse_euclidean_vector& operator+=(sparse_euclidean_vector const& b);
+		sparse_euclidean_vector& operator-=(sparse_euclidean_vector const& b);
+		sparse_euclidean_vector& operator*=(double const& b);
+		sparse_euclidean_vector& operator/=(double const& b);
+
+		friend bool operator==(sparse_euclidean_vector const& a, sparse_euclidean_vector const& b);
+
+		friend sparse_euclidean_vector operator+(sparse_euclidean_vector a, sparse_euclidean_vector const& b) {
+			return std::move(a += b);
+		}
+
+		friend sparse_euclidean_vector operator-(sparse_euclidean_vector a, sparse_euclidean_vector const& b) {
+			return std::move(a -= b);
+		}
+
+		friend sparse_euclidean_vector operator*(sparse_euclidean_vector a, double const b) {
+			return std::move(a *= b);
+		}
+
+		friend sparse_euclidean_vector operator*(double const b, sparse_euclidean_vector a) {
+			return std::move(a *= b);
+		}
+
+		friend sparse_euclidean_vector operator/(sparse_euclidean_vector a, double const b) {
+			return std::move(a /= b);
+		}
+
+		//Same format as euclidean_vector, zeros included, so only sensible for small vectors.
+		friend std::ostream& operator<<(std::ostream& os, sparse_euclidean_vector const& a);
+
+	private:
+		void CheckIndex(int i) const;
+		//Combines b into *this entry by entry; sign is +1 or -1.
+		void Merge(sparse_euclidean_vector const& b, double sign);
+
+		int dimensions_;
+		std::pmr::vector<int> indices_;
+		std::pmr::vector<double> values_;
+	};
+
+	double dot(sparse_euclidean_vector const& x, sparse_euclidean_vector const& y);
+	double dot(sparse_euclidean_vector const& x, euclidean_vector const& y);
+	double dot(euclidean_vector const& x, sparse_euclidean_vector const& y);
+	double euclidean_norm(sparse_euclidean_vector const& v);
+	sparse_euclidean_vector unit(sparse_euclidean_vector const& v);
+
+	//Mixed arithmetic produces a dense result, touching only the sparse operand's nonzeros after
+	//the copy.
+	euclidean_vector& operator+=(euclidean_vector& a, sparse_euclidean_vector const& b);
+	euclidean_vector& operator-=(euclidean_vector& a, sparse_euclidean_vector const& b);
+	euclidean_vector operator+(euclidean_vector a, sparse_euclidean_vector const& b);
+	euclidean_vector operator+(sparse_euclidean_vector const& a, euclidean_vector b);
+	euclidean_vector operator-(euclidean_vector a, sparse_euclidean_vector const& b);
+	euclidean_vector operator-(sparse_euclidean_vector const& a, euclidean_vector const& b);
+} // namespace comp6771
+#endif // COMP6771_SPARSE_EUCLIDEAN_VECTOR_HPP
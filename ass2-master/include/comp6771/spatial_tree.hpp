@@ -0,0 +1,128 @@
+#ifndef COMP6771_SPATIAL_TREE_HPP
+#define COMP6771_SPATIAL_TREE_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include "comp6771/knn_index.hpp"
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	class kd_tree;
+	class ball_tree;
+
+	namespace detail {
+		//What kd_tree and ball_tree share: bulk construction by median splits, and the queries.
+		//Tree supplies the node bounds.
+		//
+		//Construction splits each node at the median of its widest dimension until at most
+		//leaf_size points remain. Nodes are stored depth first in one array, so a left child
+		//directly follows its parent. Points are then copied in leaf order, so every subtree's
+		//points are contiguous and a leaf is scanned with straight kernel calls.
+		//Queries read through views and kernels only; they allocate nothing but their results.
+		template<typename Tree>
+		class basic_spatial_tree {
+		public:
+			using allocator_type = std::pmr::polymorphic_allocator<>;
+
+			static constexpr int default_leaf_size = 16;
+
+			int size() const noexcept { return static_cast<int>(indices_.size()); }
+			int dimensions() const noexcept { return dimensions_; }
+
+			//The closest point; throws if the tree is empty. Scores are squared euclidean distances,
+			//as for a knn_index using distance_metric::l2, and ties go to the lower index.
+			neighbour nearest(const_euclidean_vector_view query) const;
+			//The min(k, size()) closest points, closest first.
+			std::vector<neighbour> knn(const_euclidean_vector_view query, int k) const;
+			//Every point within `radius` of `query`, closest first.
+			std::vector<neighbour> radius(const_euclidean_vector_view query, double radius) const;
+			//Indices, ascending, of the points p with lower[d] <= p[d] <= upper[d] in every dimension.
+			std::vector<int> box(const_euclidean_vector_view lower, const_euclidean_vector_view upper) const;
+
+		protected:
+			struct node {
+				int begin;
+				int end;
+				//Index of the right child, or -1 for a leaf. The left child is the next node.
+				int right;
+			};
+
+			//Three answers to "how does a node sit against the query box".
+			enum class overlap { none, partial, all };
+
+			//`points` is row-major, count rows of `dimensions`, in the caller's index order.
+			basic_spatial_tree(std::pmr::vector<double> points, int dimensions, int leaf_size);
+
+			double const* Point(int position) const noexcept {
+				return points_.data() + static_cast<std::size_t>(position) * static_cast<std::size_t>(dimensions_);
+			}
+
+			int dimensions_;
+			std::pmr::vector<double> points_;
+			//The caller's index of each stored point.
+			std::pmr::vector<int> indices_;
+			std::pmr::vector<node> nodes_;
+
+		private:
+			int Build(std::vector<int>& order, int begin, int end, int leaf_size,
+		          std::pmr::vector<double> const& unordered);
+			void Knn(int index, double const* query, std::size_t k, std::vector<neighbour>& heap) const;
+			void Radius(int index, double const* query, double squared_radius, std::vector<neighbour>& found) const;
+			void Box(int index, double const* lower, double const* upper, std::vector<int>& found) const;
+			Tree const& Derived() const noexcept { return static_cast<Tree const&>(*this); }
+		};
+	} // namespace detail
+
+	//For low-dimensional points: each node keeps the tight axis-aligned box around its points, which
+	//both prunes searches and answers box queries for whole subtrees at once.
+	class kd_tree : public detail::basic_spatial_tree<kd_tree> {
+	public:
+		explicit kd_tree(std::span<euclidean_vector const> points, int leaf_size = default_leaf_size,
+		                 allocator_type const& alloc = {});
+		explicit kd_tree(euclidean_vector_batch const& points, int leaf_size = default_leaf_size,
+		                 allocator_type const& alloc = {});
+
+	private:
+		friend class detail::basic_spatial_tree<kd_tree>;
+
+		static constexpr auto name = "kd_tree";
+
+		void Bound();
+		double MinSquaredDistance(int index, double const* query) const noexcept;
+		overlap Overlap(int index, double const* lower, double const* upper) const noexcept;
+
+		//Per node, dimensions() values each.
+		std::pmr::vector<double> lower_;
+		std::pmr::vector<double> upper_;
+	};
+
+	//Each node keeps the smallest ball around its points centred on their mean. Looser than a box
+	//per axis, but the bound does not weaken as dimensions are added, so it holds up better towards
+	//16 dimensions and on clustered data.
+	class ball_tree : public detail::basic_spatial_tree<ball_tree> {
+	public:
+		explicit ball_tree(std::span<euclidean_vector const> points, int leaf_size = default_leaf_size,
+		                   allocator_type const& alloc = {});
+		explicit ball_tree(euclidean_vector_batch const& points, int leaf_size = default_leaf_size,
+		                   allocator_type const& alloc = {});
+
+	private:
+		friend class detail::basic_spatial_tree<ball_tree>;
+
+		static constexpr auto name = "ball_tree";
+
+		void Bound();
+		double MinSquaredDistance(int index, double const* query) const noexcept;
+		overlap Overlap(int index, double const* lower, double const* upper) const noexcept;
+
+		//Per node, dimensions() values each.
+		std::pmr::vector<double> centres_;
+		//Per node.
+		std::pmr::vector<double> radii_;
+	};
+} // namespace comp6771
+#endif // COMP6771_SPATIAL_TREE_HPP
@@ -4,6 +4,7 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 #include <numeric>
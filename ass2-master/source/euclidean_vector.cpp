@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 //
 #include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
 #include <iostream>
 #include <list>
 #include <algorithm>
@@ -9,6 +12,7 @@
 #include <iterator>
 #include <memory>
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 #include <numeric>
@@ -17,216 +21,647 @@
 #include <vector>
 #include <typeinfo>
 #include <cassert>
-#include <experimental/iterator>
+#include <charconv>
+#include <span>
+#include <istream>
+#include <ostream>
+#include <array>
+#include <concepts>
 
 
 namespace comp6771 {
-	euclidean_vector::euclidean_vector() : euclidean_vector(1,0.0) {}
+	namespace {
+		//The SIMD kernels and thread pool work in double. Other precisions take these scalar loops,
+		//which keep four partial sums in the accumulator type so the compiler can still vectorise.
+		template<typename A, typename T>
+		A dot_product(T const* x, T const* y, std::size_t const n) {
+			if constexpr (std::same_as<T, double> and std::same_as<A, double>) {
+				return parallel::dot(x, y, n);
+			} else {
+				auto sums = std::array<A, 4>{};
+				auto i = std::size_t{0};
+				for (; i + 4 <= n; i += 4) {
+					for (std::size_t j = 0; j < 4; ++j) {
+						sums[j] += static_cast<A>(x[i+j]) * static_cast<A>(y[i+j]);
+					}
+				}
+				for (; i < n; ++i) {
+					sums[0] += static_cast<A>(x[i]) * static_cast<A>(y[i]);
+				}
+				return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+			}
+		}
+
+		template<typename A, typename T>
+		A squared_norm(T const* x, std::size_t const n) {
+			if constexpr (std::same_as<T, double> and std::same_as<A, double>) {
+				return parallel::squared_norm(x, n);
+			} else {
+				return dot_product<A>(x, x, n);
+			}
+		}
+
+		//The fused distances. Like dot_product, these take the kernels for double and keep four
+		//partial results in the accumulator type otherwise. No thread pool: they are meant for the
+		//many short vectors inside a search, not one long one.
+		template<typename A, typename T>
+		A squared_difference(T const* x, T const* y, std::size_t const n) {
+			if constexpr (std::same_as<T, double> and std::same_as<A, double>) {
+				return kernels::active().squared_distance(x, y, n);
+			} else {
+				auto sums = std::array<A, 4>{};
+				auto i = std::size_t{0};
+				for (; i + 4 <= n; i += 4) {
+					for (std::size_t j = 0; j < 4; ++j) {
+						auto const d = static_cast<A>(x[i+j]) - static_cast<A>(y[i+j]);
+						sums[j] += d * d;
+					}
+				}
+				for (; i < n; ++i) {
+					auto const d = static_cast<A>(x[i]) - static_cast<A>(y[i]);
+					sums[0] += d * d;
+				}
+				return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+			}
+		}
+
+		template<typename A, typename T>
+		A absolute_difference(T const* x, T const* y, std::size_t const n) {
+			if constexpr (std::same_as<T, double> and std::same_as<A, double>) {
+				return kernels::active().manhattan_distance(x, y, n);
+			} else {
+				auto sums = std::array<A, 4>{};
+				auto i = std::size_t{0};
+				for (; i + 4 <= n; i += 4) {
+					for (std::size_t j = 0; j < 4; ++j) {
+						sums[j] += std::abs(static_cast<A>(x[i+j]) - static_cast<A>(y[i+j]));
+					}
+				}
+				for (; i < n; ++i) {
+					sums[0] += std::abs(static_cast<A>(x[i]) - static_cast<A>(y[i]));
+				}
+				return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+			}
+		}
+
+		template<typename A, typename T>
+		A largest_difference(T const* x, T const* y, std::size_t const n) {
+			if constexpr (std::same_as<T, double> and std::same_as<A, double>) {
+				return kernels::active().chebyshev_distance(x, y, n);
+			} else {
+				auto r = A(0);
+				for (std::size_t i = 0; i < n; ++i) {
+					r = std::max(r, std::abs(static_cast<A>(x[i]) - static_cast<A>(y[i])));
+				}
+				return r;
+			}
+		}
+
+		//x.y, x.x and y.y in one pass.
+		template<typename A, typename T>
+		std::array<A, 3> dot_and_squared_norms(T const* x, T const* y, std::size_t const n) {
+			if constexpr (std::same_as<T, double> and std::same_as<A, double>) {
+				auto const terms = kernels::active().dot_and_squared_norms(x, y, n);
+				return {terms.xy, terms.xx, terms.yy};
+			} else {
+				auto r = std::array<A, 3>{};
+				for (std::size_t i = 0; i < n; ++i) {
+					auto const a = static_cast<A>(x[i]);
+					auto const b = static_cast<A>(y[i]);
+					r[0] += a * b;
+					r[1] += a * a;
+					r[2] += b * b;
+				}
+				return r;
+			}
+		}
+
+		template<typename T>
+		void add(T* x, T const* y, std::size_t const n) {
+			if constexpr (std::same_as<T, double>) {
+				parallel::add(x, y, n);
+			} else {
+				for (std::size_t i = 0; i < n; ++i) {
+					x[i] += y[i];
+				}
+			}
+		}
+
+		template<typename T>
+		void subtract(T* x, T const* y, std::size_t const n) {
+			if constexpr (std::same_as<T, double>) {
+				parallel::subtract(x, y, n);
+			} else {
+				for (std::size_t i = 0; i < n; ++i) {
+					x[i] -= y[i];
+				}
+			}
+		}
+
+		template<typename T>
+		void multiply(T* x, T const b, std::size_t const n) {
+			if constexpr (std::same_as<T, double>) {
+				parallel::multiply(x, b, n);
+			} else {
+				for (std::size_t i = 0; i < n; ++i) {
+					x[i] *= b;
+				}
+			}
+		}
+
+		template<typename T>
+		void divide(T* x, T const b, std::size_t const n) {
+			if constexpr (std::same_as<T, double>) {
+				parallel::divide(x, b, n);
+			} else {
+				for (std::size_t i = 0; i < n; ++i) {
+					x[i] /= b;
+				}
+			}
+		}
+	} // namespace
 
-	euclidean_vector::euclidean_vector(int const &size) : euclidean_vector(size, 0.0){ }
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector() : basic_euclidean_vector(1, T(0.0)) {}
 
-	euclidean_vector::euclidean_vector(int const &size, double const &num) : dimensions_{std::size_t(size)}
-		,State_{false}, norm_{0.0}, dot_{-1.0} {
-		magnitude_ = std::make_unique<double[]>(dimensions_);
-		std::fill(magnitude_.get(), magnitude_.get()+dimensions_, num);
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(allocator_type const& alloc)
+	: basic_euclidean_vector(1, T(0.0), alloc) {}
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(int const &size, allocator_type const& alloc)
+	: basic_euclidean_vector(size, T(0.0), alloc){ }
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(int const &size, T const &num, allocator_type const& alloc)
+		: dimensions_{std::size_t(size)}, alloc_{alloc} {
+		Allocate(dimensions_);
+		std::fill(data_, data_+dimensions_, num);
 	}
 
-	euclidean_vector::euclidean_vector(std::vector<double>::const_iterator const begin, std::vector<double>::const_iterator const end)
-		: dimensions_{std::size_t(end-begin)}, State_{false}, norm_{0.0}, dot_{-1.0} {
-		magnitude_ = std::make_unique<double[]>(dimensions_);
-		std::copy(begin, end, magnitude_.get());
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(typename std::vector<T>::const_iterator const begin,
+		typename std::vector<T>::const_iterator const end, allocator_type const& alloc)
+		: dimensions_{std::size_t(end-begin)}, alloc_{alloc} {
+		Allocate(dimensions_);
+		std::copy(begin, end, data_);
 	}
 
-	euclidean_vector::euclidean_vector(std::initializer_list<double> l) : dimensions_{l.size()}
-		, State_{false}, norm_{0.0}, dot_{-1.0}{
-		magnitude_ = std::make_unique<double[]>(dimensions_);
-		std::copy(l.begin(), l.end(), magnitude_.get());
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(std::initializer_list<T> l, allocator_type const& alloc)
+		: dimensions_{l.size()}, alloc_{alloc} {
+		Allocate(dimensions_);
+		std::copy(l.begin(), l.end(), data_);
 	}
 
-	euclidean_vector::euclidean_vector(euclidean_vector const&ev) : dimensions_{ev.dimensions_}
-		, State_{ev.State_}, norm_{ev.norm_}, dot_{ev.dot_}{
-		magnitude_ = std::make_unique<double[]>(dimensions_);
-		std::memcpy(magnitude_.get(), ev.magnitude_.get(), sizeof(double)*dimensions_);
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(std::vector<T>&& v, allocator_type const& alloc)
+		: dimensions_{0}, alloc_{alloc} {
+		Adopt(std::move(v));
 	}
 
-	euclidean_vector::euclidean_vector(euclidean_vector &&Orig) noexcept
-		: dimensions_{std::exchange(Orig.dimensions_, 0.0)}
-		, State_{std::exchange(Orig.State_, false)}
-		, norm_{std::exchange(Orig.norm_, 0.0)}
-		, dot_{std::exchange(Orig.dot_, -1.0)}
-		, magnitude_{std::move(Orig.magnitude_)} {}
+	template<typename T, typename A>
+	void basic_euclidean_vector<T, A>::Adopt(std::vector<T>&& v) {
+		if (v.size() <= inline_capacity) {
+			Allocate(v.size());
+			std::memcpy(data_, v.data(), sizeof(T)*dimensions_);
+			v.clear();
+			return;
+		}
+		//Not on alloc_'s resource: the buffer may be moved to a vector that outlives it.
+		auto* const resource = std::pmr::new_delete_resource();
+		auto* held = std::pmr::polymorphic_allocator<>(resource).new_object<std::vector<T>>(std::move(v));
+		magnitude_ = buffer(held->data(), deleter{resource, held->size(), alignof(T), held});
+		data_ = magnitude_.get();
+		dimensions_ = held->size();
+	}
+
+	//Like std::pmr containers, a copy does not inherit the source's memory resource.
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(basic_euclidean_vector const&ev)
+	: basic_euclidean_vector(ev, allocator_type{}) {}
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(basic_euclidean_vector const&ev, allocator_type const& alloc)
+		: dimensions_{ev.dimensions_}, norm_{ev.norm_}, dot_{ev.dot_}, maintain_norm_{ev.maintain_norm_}
+		, updates_{ev.updates_}, alloc_{alloc} {
+		Allocate(dimensions_);
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(copies, 1);
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(copied_bytes, sizeof(T)*dimensions_);
+		std::memcpy(data_, ev.data_, sizeof(T)*dimensions_);
+	}
 
-	euclidean_vector& euclidean_vector::operator=(euclidean_vector const& ev) {
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(basic_euclidean_vector &&Orig) noexcept
+		: dimensions_{0}
+		, maintain_norm_{Orig.maintain_norm_}
+		, updates_{std::exchange(Orig.updates_, 0)}
+		, alloc_{Orig.alloc_} {
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(moves, 1);
+		norm_.take(Orig.norm_);
+		dot_.take(Orig.dot_);
+		StealFrom(Orig);
+	}
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::basic_euclidean_vector(basic_euclidean_vector &&Orig, allocator_type const& alloc)
+		: dimensions_{0}, maintain_norm_{Orig.maintain_norm_}, alloc_{alloc} {
+		*this = std::move(Orig);
+	}
+
+	//Takes Orig's heap buffer, or copies its inline magnitudes, and leaves it with 0 dimensions.
+	//A heap buffer may only be taken when both vectors share a memory resource, or it was adopted.
+	template<typename T, typename A>
+	void basic_euclidean_vector<T, A>::StealFrom(basic_euclidean_vector &Orig) noexcept {
+		assert(not Orig.OwnsResourceBuffer() or alloc_ == Orig.alloc_);
+		dimensions_ = std::exchange(Orig.dimensions_, 0);
+		magnitude_ = std::move(Orig.magnitude_);
+		if (magnitude_) {
+			data_ = magnitude_.get();
+		} else {
+			data_ = inline_.data();
+			COMP6771_EUCLIDEAN_VECTOR_COUNT(copied_bytes, sizeof(T)*dimensions_);
+			std::memcpy(data_, Orig.data_, sizeof(T)*dimensions_);
+		}
+		Orig.data_ = Orig.inline_.data();
+	}
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>& basic_euclidean_vector<T, A>::operator=(basic_euclidean_vector const& ev) {
 		if (this == &ev) {
 			return *this;
 		}
-		AdjustMutables(ev.State_, ev.norm_, ev.dot_);
-		magnitude_ = std::make_unique<double[]>(ev.dimensions_);
-		dimensions_ = ev.dimensions_;
-		std::memcpy(magnitude_.get(), ev.magnitude_.get(), sizeof(double)*dimensions_);
+		norm_ = ev.norm_;
+		dot_ = ev.dot_;
+		updates_ = ev.updates_;
+		if (dimensions_ != ev.dimensions_) {
+			Allocate(ev.dimensions_);
+		}
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(copies, 1);
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(copied_bytes, sizeof(T)*dimensions_);
+		std::memcpy(data_, ev.data_, sizeof(T)*dimensions_);
 		return *this;
 	}
 
-	euclidean_vector& euclidean_vector::operator=(euclidean_vector &&Orig) noexcept
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>& basic_euclidean_vector<T, A>::operator=(basic_euclidean_vector &&Orig)
 	{
-		if (this != &Orig) {
-			State_ = std::exchange(Orig.State_, false);
-			norm_ = std::exchange(Orig.norm_, 0.0);
-			magnitude_ = std::move(Orig.magnitude_);
-			dot_ = std::exchange(Orig.dot_, -1.0);
-			dimensions_= std::exchange(Orig.dimensions_, 0.0);
+		if (this == &Orig) {
+			return *this;
+		}
+		if (Orig.OwnsResourceBuffer() and alloc_ != Orig.alloc_) {
+			//Our resource stays ours, so Orig's buffer can't be adopted; copy out of it instead.
+			*this = static_cast<basic_euclidean_vector const&>(Orig);
+			Orig.magnitude_.reset();
+			Orig.data_ = Orig.inline_.data();
+			Orig.dimensions_ = 0;
+			Orig.AdjustMutables();
+			return *this;
 		}
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(moves, 1);
+		norm_.take(Orig.norm_);
+		dot_.take(Orig.dot_);
+		updates_ = std::exchange(Orig.updates_, 0);
+		StealFrom(Orig);
 		return *this;
 	}
 
-	double euclidean_vector::operator[](int i) const {
+	template<typename T, typename A>
+	T basic_euclidean_vector<T, A>::operator[](int i) const {
 		assert(size_t(i) >= 0 and size_t(i) < dimensions_);
-		return *(magnitude_.get()+i);
+		return *(data_+i);
 	}
 
-	double& euclidean_vector::operator[](int i) {
+	template<typename T, typename A>
+	T& basic_euclidean_vector<T, A>::operator[](int i) {
 		assert(size_t(i) >= 0 and size_t(i) < dimensions_);
-		AdjustMutables(false, 0.0, -1.0);
-		return *(magnitude_.get()+i);
+		AdjustMutables();
+		return *(data_+i);
 	}
 
-	euclidean_vector euclidean_vector::operator+(void) const{
-		euclidean_vector tmp = euclidean_vector(*this);
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A> basic_euclidean_vector<T, A>::operator+(void) const& {
+		basic_euclidean_vector tmp = basic_euclidean_vector(*this);
 		return tmp;
 	}
 
-	euclidean_vector euclidean_vector::operator-(void) const{
-		euclidean_vector tmp = euclidean_vector(*this); //Calling my Copy Constructor
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A> basic_euclidean_vector<T, A>::operator+(void) && {
+		return std::move(*this);
+	}
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A> basic_euclidean_vector<T, A>::operator-(void) const& {
+		basic_euclidean_vector tmp = basic_euclidean_vector(*this); //Calling my Copy Constructor
 		tmp *= -1;
 		return tmp;
 	}
 
-	euclidean_vector euclidean_vector::operator+=(euclidean_vector const& b) {
-		// NEED to add exception
-		if (dimensions_ != b.dimensions_) {
-			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(dimensions_) +") and RHS(" +
-			std::to_string(b.dimensions_) + ") do not match");
-		}
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A> basic_euclidean_vector<T, A>::operator-(void) && {
+		*this *= -1; //Negate in place and hand the buffer on
+		return std::move(*this);
+	}
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>& basic_euclidean_vector<T, A>::operator+=(basic_euclidean_vector const& b) {
+		detail::check_dimensions(dimensions_, b.dimensions_);
 
-		AdjustMutables(false, 0.0,-1.0);
-		std::transform(magnitude_.get(), magnitude_.get()+dimensions_,
-					b.magnitude_.get(), magnitude_.get(), std::plus<double>());
+		AdjustMutables();
+		add(data_, b.data_, dimensions_);
 		return *this;
 	}
 
-	euclidean_vector euclidean_vector::operator-=(euclidean_vector const& b) {
-		// NEED to add exception
-		if (dimensions_ != b.dimensions_) {
-			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(dimensions_) +") and RHS(" +
-			std::to_string(b.dimensions_) + ") do not match");
-		}
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>& basic_euclidean_vector<T, A>::operator-=(basic_euclidean_vector const& b) {
+		detail::check_dimensions(dimensions_, b.dimensions_);
+
+		AdjustMutables();
+		subtract(data_, b.data_, dimensions_);
+		return *this;
+	}
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>& basic_euclidean_vector<T, A>::operator+=(const_euclidean_vector_view const b)
+	requires std::same_as<T, double> {
+		detail::check_dimensions(dimensions_, b.magnitudes().size());
 
-		AdjustMutables(false, 0.0, -1.0);
-		std::transform(magnitude_.get(), magnitude_.get()+dimensions_,
-					b.magnitude_.get(), magnitude_.get(), std::minus<double>());
+		AdjustMutables();
+		parallel::add(data_, b.data(), dimensions_);
 		return *this;
 	}
 
-	euclidean_vector euclidean_vector::operator*=(double const& b) {
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>& basic_euclidean_vector<T, A>::operator-=(const_euclidean_vector_view const b)
+	requires std::same_as<T, double> {
+		detail::check_dimensions(dimensions_, b.magnitudes().size());
 
-		AdjustMutables(false, 0.0, -1.0);
-		std::transform(magnitude_.get(), magnitude_.get()+dimensions_,
-					magnitude_.get(),std::bind(std::multiplies<double>(), std::placeholders::_1, b));
+		AdjustMutables();
+		parallel::subtract(data_, b.data(), dimensions_);
 		return *this;
 	}
 
-	euclidean_vector euclidean_vector::operator/=(double const& b) {
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>& basic_euclidean_vector<T, A>::operator*=(T const& b) {
+
+		ScaleNorm(static_cast<A>(b));
+		multiply(data_, b, dimensions_);
+		return *this;
+	}
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>& basic_euclidean_vector<T, A>::operator/=(T const& b) {
 		//NEED to add exception
 		if (std::abs(b-0) < 0.0001) {
 			throw euclidean_vector_error("Invalid vector division by 0");
 		}
 
-		AdjustMutables(false, 0.0, -1.0);
-		std::transform(magnitude_.get(), magnitude_.get()+dimensions_,
-					magnitude_.get(),std::bind(std::divides<double>(), std::placeholders::_1, b));
+		ScaleNorm(A(1.0) / static_cast<A>(b));
+		divide(data_, b, dimensions_);
 		return *this;
 	}
 
-	euclidean_vector::operator std::vector<double>() const{
-		auto a = std::vector<double>();
-		std::copy(magnitude_.get(), magnitude_.get()+dimensions_, std::back_inserter(a));
-		return a;
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::operator std::vector<T>() const& {
+		return to_vector();
+	}
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::operator std::vector<T>() && {
+		return std::move(*this).to_vector();
 	}
 
-	euclidean_vector::operator std::list<double>() const{
-		auto a = std::list<double>();
-		std::copy(magnitude_.get(), magnitude_.get()+dimensions_, std::back_inserter(a));
-		return a;
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A>::operator std::list<T>() const{
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(copied_bytes, sizeof(T)*dimensions_);
+		return std::list<T>(data_, data_+dimensions_);
 	}
 
-	double euclidean_vector::at(int i) const {
+	template<typename T, typename A>
+	std::vector<T> basic_euclidean_vector<T, A>::to_vector() const& {
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(copied_bytes, sizeof(T)*dimensions_);
+		return std::vector<T>(data_, data_+dimensions_);
+	}
+
+	template<typename T, typename A>
+	std::vector<T> basic_euclidean_vector<T, A>::to_vector() && {
+		auto result = magnitude_ != nullptr and magnitude_.get_deleter().adopted != nullptr
+		            ? std::move(*magnitude_.get_deleter().adopted)
+		            : std::as_const(*this).to_vector();
+		magnitude_.reset();
+		data_ = inline_.data();
+		dimensions_ = 0;
+		AdjustMutables();
+		return result;
+	}
+
+	template<typename T, typename A>
+	T basic_euclidean_vector<T, A>::at(int i) const {
 		//NEED to add exception
 		if (i < 0 or i >= this->dimensions()) {
 			throw euclidean_vector_error("Index " + std::to_string(i) +" is not valid for this euclidean_vector object");
 		}
-		return *(magnitude_.get()+i);
+		return *(data_+i);
 	}
 
-	double& euclidean_vector::at(int i) {
+	template<typename T, typename A>
+	T& basic_euclidean_vector<T, A>::at(int i) {
 		//NEED to add exception
 		if (i < 0 or i >= this->dimensions()) {
 			throw euclidean_vector_error("Index " + std::to_string(i) +" is not valid for this euclidean_vector object");
 		}
-		AdjustMutables(false, 0.0, -1.0);
-		return *(magnitude_.get()+i);
+		AdjustMutables();
+		return *(data_+i);
+	}
+
+	template<typename T, typename A>
+	void basic_euclidean_vector<T, A>::set(int i, T const value) {
+		if (i < 0 or i >= this->dimensions()) {
+			throw euclidean_vector_error("Index " + std::to_string(i) +" is not valid for this euclidean_vector object");
+		}
+		auto& element = data_[i];
+		auto const old = static_cast<A>(element);
+		AdjustNorm(old * old, static_cast<A>(value) * static_cast<A>(value));
+		element = value;
+	}
+
+	//Counts one incremental update against norm_refresh_interval. False means the cache has been
+	//dropped instead and the caller has nothing to adjust.
+	template<typename T, typename A>
+	bool basic_euclidean_vector<T, A>::KeepCache() noexcept {
+		if (not maintain_norm_ or ++updates_ >= norm_refresh_interval) {
+			AdjustMutables();
+			return false;
+		}
+		return true;
 	}
 
-	int euclidean_vector::dimensions() const {
+	//One element's square went from `removed` to `added`.
+	template<typename T, typename A>
+	void basic_euclidean_vector<T, A>::AdjustNorm(A const removed, A const added) noexcept {
+		auto const dot = dot_.load();
+		auto const norm = norm_.load();
+		if ((not dot and not norm) or not KeepCache()) {
+			return;
+		}
+		auto const old = dot ? *dot : *norm * *norm;
+		auto const updated = old - removed + added;
+		if (updated < old * A(1e-8)) {
+			//Cancellation has eaten most of the significant bits (or gone negative); start afresh.
+			AdjustMutables();
+			return;
+		}
+		if (dot) {
+			dot_.store(updated);
+		}
+		if (norm) {
+			norm_.store(std::sqrt(updated));
+		}
+	}
+
+	//Every element is about to be multiplied by `factor`.
+	template<typename T, typename A>
+	void basic_euclidean_vector<T, A>::ScaleNorm(A const factor) noexcept {
+		auto const dot = dot_.load();
+		auto const norm = norm_.load();
+		if ((not dot and not norm) or not KeepCache()) {
+			return;
+		}
+		if (dot) {
+			dot_.store(*dot * factor * factor);
+		}
+		if (norm) {
+			norm_.store(*norm * std::abs(factor));
+		}
+	}
+
+	template<typename T, typename A>
+	int basic_euclidean_vector<T, A>::dimensions() const {
 		return static_cast<int>(dimensions_);
 	}
 
-	double euclidean_norm(euclidean_vector const&v) {
+	template<typename T, typename A>
+	A euclidean_norm(basic_euclidean_vector<T, A> const&v) {
 		//ADD EXCEPTIONS
-		if (v.State_) {
-			return v.norm_;
+		//Racing readers may both compute the norm; they store the same bits, so either store is fine.
+		if (auto const cached = v.norm_.load()) {
+			COMP6771_EUCLIDEAN_VECTOR_COUNT(norm_cache_hits, 1);
+			return *cached;
 		} else {
+			COMP6771_EUCLIDEAN_VECTOR_COUNT(norm_cache_misses, 1);
 			auto z = std::sqrt(comp6771::dot(v,v));
-			v.norm_ = z;
-			v.State_ = true;
+			v.norm_.store(z);
 			return z;
 		}
 	}
 
 
-	double dot(euclidean_vector const& x, euclidean_vector const& y) {
-		//ADD EXCEPTIONS HERE
-		if (y.dimensions_ != x.dimensions_) {
-			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(x.dimensions_) +") and RHS(" +
-			std::to_string(y.dimensions_) + ") do not match");
-		}
+	template<typename T, typename A>
+	A dot(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y) {
+		detail::check_dimensions(x.dimensions_, y.dimensions_);
 		auto key = false;
 		if (&x == &y) {
 			key = true;
-			if (std::abs(x.dot_-(-1)) > 0.0001) {
-				return x.dot_;
+			if (auto const cached = x.dot_.load()) {
+				COMP6771_EUCLIDEAN_VECTOR_COUNT(dot_cache_hits, 1);
+				return *cached;
 			}
+			COMP6771_EUCLIDEAN_VECTOR_COUNT(dot_cache_misses, 1);
 		}
-		double r1 = std::inner_product(x.magnitude_.get()
-									,x.magnitude_.get()+x.dimensions_
-									, y.magnitude_.get(), 0.0);
+		A r1 = key ? squared_norm<A>(x.data_, x.dimensions_)
+		           : dot_product<A>(x.data_, y.data_, x.dimensions_);
 		if (key == true) {
-			x.dot_ = r1;
+			x.dot_.store(r1);
 		}
 		return r1;
 	}
-	euclidean_vector unit(euclidean_vector const& v) {
+
+	template<typename T, typename A>
+	basic_euclidean_vector<T, A> unit(basic_euclidean_vector<T, A> const& v) {
 		//ADD EXCEPTIONS
 		if (v.dimensions() == 0) {
 			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a unit vector");
 		}
 		auto x = v;
-		auto d = v.norm_;
+		auto const cached = v.norm_.load();
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(norm_cache_hits, cached.has_value());
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(norm_cache_misses, not cached.has_value());
+		auto d = cached.value_or(A(0.0));
 		if (std::abs(d-0) < 0.0001) {
 			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a unit vector");
 		}
-		x /= d;
+		x /= static_cast<T>(d);
 		return x;
 	}
 
+	template<typename T, typename A>
+	A squared_distance(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y) {
+		detail::check_dimensions(detail::vector_access::size(x), detail::vector_access::size(y));
+		return squared_difference<A>(detail::vector_access::data(x), detail::vector_access::data(y),
+		                             detail::vector_access::size(x));
+	}
+
+	template<typename T, typename A>
+	A euclidean_distance(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y) {
+		return std::sqrt(squared_distance(x, y));
+	}
+
+	template<typename T, typename A>
+	A cosine_similarity(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y) {
+		detail::check_dimensions(x.dimensions_, y.dimensions_);
+		auto const x_cached = x.norm_.load();
+		auto const y_cached = y.norm_.load();
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(norm_cache_hits, x_cached.has_value() + y_cached.has_value());
+		COMP6771_EUCLIDEAN_VECTOR_COUNT(norm_cache_misses, not x_cached.has_value() + not y_cached.has_value());
+		auto x_norm = A(0);
+		auto y_norm = A(0);
+		auto xy = A(0);
+		if (x_cached and y_cached) {
+			x_norm = *x_cached;
+			y_norm = *y_cached;
+			xy = dot_product<A>(x.data_, y.data_, x.dimensions_);
+		} else {
+			auto const terms = dot_and_squared_norms<A>(x.data_, y.data_, x.dimensions_);
+			xy = terms[0];
+			x_norm = x_cached.value_or(std::sqrt(terms[1]));
+			y_norm = y_cached.value_or(std::sqrt(terms[2]));
+		}
+		detail::check_direction(x_norm);
+		detail::check_direction(y_norm);
+		return xy / (x_norm * y_norm);
+	}
+
+	template<typename T, typename A>
+	A manhattan_distance(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y) {
+		detail::check_dimensions(detail::vector_access::size(x), detail::vector_access::size(y));
+		return absolute_difference<A>(detail::vector_access::data(x), detail::vector_access::data(y),
+		                              detail::vector_access::size(x));
+	}
+
+	template<typename T, typename A>
+	A chebyshev_distance(basic_euclidean_vector<T, A> const& x, basic_euclidean_vector<T, A> const& y) {
+		detail::check_dimensions(detail::vector_access::size(x), detail::vector_access::size(y));
+		return largest_difference<A>(detail::vector_access::data(x), detail::vector_access::data(y),
+		                             detail::vector_access::size(x));
+	}
 
+#define COMP6771_INSTANTIATE_EUCLIDEAN_VECTOR(T, A) \
+	template class basic_euclidean_vector<T, A>; \
+	template A euclidean_norm(basic_euclidean_vector<T, A> const&); \
+	template A dot(basic_euclidean_vector<T, A> const&, basic_euclidean_vector<T, A> const&); \
+	template basic_euclidean_vector<T, A> unit(basic_euclidean_vector<T, A> const&); \
+	template A squared_distance(basic_euclidean_vector<T, A> const&, basic_euclidean_vector<T, A> const&); \
+	template A euclidean_distance(basic_euclidean_vector<T, A> const&, basic_euclidean_vector<T, A> const&); \
+	template A cosine_similarity(basic_euclidean_vector<T, A> const&, basic_euclidean_vector<T, A> const&); \
+	template A manhattan_distance(basic_euclidean_vector<T, A> const&, basic_euclidean_vector<T, A> const&); \
+	template A chebyshev_distance(basic_euclidean_vector<T, A> const&, basic_euclidean_vector<T, A> const&);
+
+	COMP6771_INSTANTIATE_EUCLIDEAN_VECTOR(float, float)
+	COMP6771_INSTANTIATE_EUCLIDEAN_VECTOR(float, double)
+	COMP6771_INSTANTIATE_EUCLIDEAN_VECTOR(float, long double)
+	COMP6771_INSTANTIATE_EUCLIDEAN_VECTOR(double, double)
+	COMP6771_INSTANTIATE_EUCLIDEAN_VECTOR(double, long double)
+	COMP6771_INSTANTIATE_EUCLIDEAN_VECTOR(long double, long double)
+
+#undef COMP6771_INSTANTIATE_EUCLIDEAN_VECTOR
 } // namespace comp6771
@@ -0,0 +1,314 @@
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		constexpr std::size_t doubles_per_line = euclidean_vector_batch::alignment / sizeof(double);
+
+		std::size_t round_up(std::size_t const n) noexcept {
+			return (n + doubles_per_line - 1) / doubles_per_line * doubles_per_line;
+		}
+
+		void check_rows(std::size_t const lhs, std::size_t const rhs) {
+			if (lhs != rhs) {
+				throw euclidean_vector_error("Rows of LHS(" + std::to_string(lhs) +") and RHS(" +
+				std::to_string(rhs) + ") do not match");
+			}
+		}
+	} // namespace
+
+	euclidean_vector_batch::euclidean_vector_batch(int const rows, int const dimensions, batch_layout const layout,
+	                                               allocator_type const& alloc)
+	: rows_{static_cast<std::size_t>(rows)}, dimensions_{static_cast<std::size_t>(dimensions)}, layout_{layout}
+	, leading_{round_up(layout == batch_layout::row_major ? dimensions_ : rows_)}, alloc_{alloc} {
+		auto const size = BufferSize();
+		auto* p = static_cast<double*>(alloc_.resource()->allocate(size * sizeof(double), alignment));
+		data_ = std::unique_ptr<double[], detail::buffer_deleter>(p, detail::buffer_deleter{alloc_.resource(), size, alignment});
+		std::fill(p, p + size, 0.0);
+	}
+
+	euclidean_vector_batch::euclidean_vector_batch(std::span<euclidean_vector const> vectors, batch_layout const layout,
+	                                               allocator_type const& alloc)
+	: euclidean_vector_batch(static_cast<int>(vectors.size()), vectors.empty() ? 0 : vectors.front().dimensions(), layout, alloc) {
+		for (std::size_t i = 0; i < vectors.size(); ++i) {
+			set_row(static_cast<int>(i), vectors[i]);
+		}
+	}
+
+	euclidean_vector_batch::euclidean_vector_batch(euclidean_vector_batch const& other)
+	: euclidean_vector_batch(other.rows(), other.dimensions(), other.layout_) {
+		std::memcpy(data_.get(), other.data_.get(), sizeof(double) * BufferSize());
+	}
+
+	euclidean_vector_batch::euclidean_vector_batch(euclidean_vector_batch&& other) noexcept
+	: rows_{std::exchange(other.rows_, 0)}, dimensions_{std::exchange(other.dimensions_, 0)}, layout_{other.layout_}
+	, leading_{std::exchange(other.leading_, 0)}, alloc_{other.alloc_}, data_{std::move(other.data_)} {}
+
+	euclidean_vector_batch& euclidean_vector_batch::operator=(euclidean_vector_batch const& other) {
+		if (this != &other) {
+			auto tmp = euclidean_vector_batch(other.rows(), other.dimensions(), other.layout_, alloc_);
+			std::memcpy(tmp.data_.get(), other.data_.get(), sizeof(double) * tmp.BufferSize());
+			rows_ = tmp.rows_;
+			dimensions_ = tmp.dimensions_;
+			layout_ = tmp.layout_;
+			leading_ = tmp.leading_;
+			data_ = std::move(tmp.data_);
+		}
+		return *this;
+	}
+
+	//As with euclidean_vector, the target keeps its memory resource; other's buffer is only taken
+	//when it came from the same one.
+	euclidean_vector_batch& euclidean_vector_batch::operator=(euclidean_vector_batch&& other) {
+		if (this == &other) {
+			return *this;
+		}
+		if (alloc_ != other.alloc_) {
+			*this = static_cast<euclidean_vector_batch const&>(other);
+		} else {
+			layout_ = other.layout_;
+			data_ = std::move(other.data_);
+		}
+		rows_ = std::exchange(other.rows_, 0);
+		dimensions_ = std::exchange(other.dimensions_, 0);
+		leading_ = std::exchange(other.leading_, 0);
+		other.data_.reset();
+		return *this;
+	}
+
+	row_view euclidean_vector_batch::operator[](int const row) noexcept {
+		return row_view(data_.get() + Offset(static_cast<std::size_t>(row), 0), dimensions_, Stride());
+	}
+
+	const_row_view euclidean_vector_batch::operator[](int const row) const noexcept {
+		return const_row_view(data_.get() + Offset(static_cast<std::size_t>(row), 0), dimensions_, Stride());
+	}
+
+	row_view euclidean_vector_batch::row(int const row) {
+		CheckRow(row);
+		return (*this)[row];
+	}
+
+	const_row_view euclidean_vector_batch::row(int const row) const {
+		CheckRow(row);
+		return (*this)[row];
+	}
+
+	void euclidean_vector_batch::CheckRow(int const row) const {
+		if (row < 0 or static_cast<std::size_t>(row) >= rows_) {
+			throw euclidean_vector_error("Row " + std::to_string(row) + " is not valid for this euclidean_vector_batch object");
+		}
+	}
+
+	void euclidean_vector_batch::set_row(int const row, euclidean_vector const& v) {
+		CheckRow(row);
+		detail::check_dimensions(dimensions_, detail::vector_access::size(v));
+		auto const* src = detail::vector_access::data(v);
+		auto dst = (*this)[row];
+		for (std::size_t i = 0; i < dimensions_; ++i) {
+			dst[static_cast<int>(i)] = src[i];
+		}
+	}
+
+	//Same-layout batches line up element for element, padding included, so whole-buffer kernels
+	//apply. Padding stays zero under +, - and scaling.
+	euclidean_vector_batch& euclidean_vector_batch::operator+=(euclidean_vector_batch const& b) {
+		check_rows(rows_, b.rows_);
+		detail::check_dimensions(dimensions_, b.dimensions_);
+		if (layout_ == b.layout_) {
+			kernels::active().add(data_.get(), b.data_.get(), BufferSize());
+		} else {
+			for (std::size_t r = 0; r < rows_; ++r) {
+				for (std::size_t d = 0; d < dimensions_; ++d) {
+					data_[Offset(r, d)] += b.data_[b.Offset(r, d)];
+				}
+			}
+		}
+		return *this;
+	}
+
+	euclidean_vector_batch& euclidean_vector_batch::operator-=(euclidean_vector_batch const& b) {
+		check_rows(rows_, b.rows_);
+		detail::check_dimensions(dimensions_, b.dimensions_);
+		if (layout_ == b.layout_) {
+			kernels::active().subtract(data_.get(), b.data_.get(), BufferSize());
+		} else {
+			for (std::size_t r = 0; r < rows_; ++r) {
+				for (std::size_t d = 0; d < dimensions_; ++d) {
+					data_[Offset(r, d)] -= b.data_[b.Offset(r, d)];
+				}
+			}
+		}
+		return *this;
+	}
+
+	euclidean_vector_batch& euclidean_vector_batch::operator+=(euclidean_vector const& v) {
+		detail::check_dimensions(dimensions_, detail::vector_access::size(v));
+		auto const* src = detail::vector_access::data(v);
+		if (layout_ == batch_layout::row_major) {
+			for (std::size_t r = 0; r < rows_; ++r) {
+				kernels::active().add(data_.get() + r * leading_, src, dimensions_);
+			}
+		} else {
+			for (std::size_t d = 0; d < dimensions_; ++d) {
+				auto* column = data_.get() + d * leading_;
+				std::for_each(column, column + rows_, [b = src[d]](double& x) { x += b; });
+			}
+		}
+		return *this;
+	}
+
+	euclidean_vector_batch& euclidean_vector_batch::operator-=(euclidean_vector const& v) {
+		detail::check_dimensions(dimensions_, detail::vector_access::size(v));
+		auto const* src = detail::vector_access::data(v);
+		if (layout_ == batch_layout::row_major) {
+			for (std::size_t r = 0; r < rows_; ++r) {
+				kernels::active().subtract(data_.get() + r * leading_, src, dimensions_);
+			}
+		} else {
+			for (std::size_t d = 0; d < dimensions_; ++d) {
+				auto* column = data_.get() + d * leading_;
+				std::for_each(column, column + rows_, [b = src[d]](double& x) { x -= b; });
+			}
+		}
+		return *this;
+	}
+
+	euclidean_vector_batch& euclidean_vector_batch::operator*=(double const& b) {
+		kernels::active().multiply(data_.get(), b, BufferSize());
+		return *this;
+	}
+
+	euclidean_vector_batch& euclidean_vector_batch::operator/=(double const& b) {
+		if (std::abs(b-0) < 0.0001) {
+			throw euclidean_vector_error("Invalid vector division by 0");
+		}
+		kernels::active().divide(data_.get(), b, BufferSize());
+		return *this;
+	}
+
+	bool operator==(euclidean_vector_batch const& a, euclidean_vector_batch const& b) {
+		if (a.rows_ != b.rows_ or a.dimensions_ != b.dimensions_) {
+			return false;
+		}
+		for (std::size_t r = 0; r < a.rows_; ++r) {
+			for (std::size_t d = 0; d < a.dimensions_; ++d) {
+				if (not (std::abs(a.data_[a.Offset(r, d)] - b.data_[b.Offset(r, d)]) < 0.0001)) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	std::vector<double> dot(euclidean_vector_batch const& x, euclidean_vector const& y) {
+		detail::check_dimensions(x.dimensions(), detail::vector_access::size(y));
+		auto const rows = static_cast<std::size_t>(x.rows());
+		auto const dims = static_cast<std::size_t>(x.dimensions());
+		auto const* q = detail::vector_access::data(y);
+		auto result = std::vector<double>(rows, 0.0);
+		if (x.layout() == batch_layout::row_major) {
+			auto const& k = kernels::active();
+			for (std::size_t r = 0; r < rows; ++r) {
+				result[r] = k.dot(x.data() + r * x.leading_dimension(), q, dims);
+			}
+		} else {
+			//Column by column, so the inner loop runs down contiguous memory.
+			for (std::size_t d = 0; d < dims; ++d) {
+				auto const* column = x.data() + d * x.leading_dimension();
+				for (std::size_t r = 0; r < rows; ++r) {
+					result[r] += column[r] * q[d];
+				}
+			}
+		}
+		return result;
+	}
+
+	std::vector<double> dot(euclidean_vector_batch const& x, euclidean_vector_batch const& y) {
+		check_rows(static_cast<std::size_t>(x.rows()), static_cast<std::size_t>(y.rows()));
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		auto const rows = static_cast<std::size_t>(x.rows());
+		auto result = std::vector<double>(rows, 0.0);
+		if (x.layout() == batch_layout::row_major and y.layout() == batch_layout::row_major) {
+			auto const& k = kernels::active();
+			for (std::size_t r = 0; r < rows; ++r) {
+				result[r] = k.dot(x.data() + r * x.leading_dimension(), y.data() + r * y.leading_dimension(),
+				                  static_cast<std::size_t>(x.dimensions()));
+			}
+		} else {
+			for (std::size_t r = 0; r < rows; ++r) {
+				auto const a = x[static_cast<int>(r)];
+				auto const b = y[static_cast<int>(r)];
+				for (auto d = 0; d < x.dimensions(); ++d) {
+					result[r] += a[d] * b[d];
+				}
+			}
+		}
+		return result;
+	}
+
+	std::vector<double> euclidean_norm(euclidean_vector_batch const& v) {
+		auto const rows = static_cast<std::size_t>(v.rows());
+		auto const dims = static_cast<std::size_t>(v.dimensions());
+		auto result = std::vector<double>(rows, 0.0);
+		if (v.layout() == batch_layout::row_major) {
+			auto const& k = kernels::active();
+			for (std::size_t r = 0; r < rows; ++r) {
+				result[r] = k.squared_norm(v.data() + r * v.leading_dimension(), dims);
+			}
+		} else {
+			for (std::size_t d = 0; d < dims; ++d) {
+				auto const* column = v.data() + d * v.leading_dimension();
+				for (std::size_t r = 0; r < rows; ++r) {
+					result[r] += column[r] * column[r];
+				}
+			}
+		}
+		std::transform(result.begin(), result.end(), result.begin(), [](double const x) { return std::sqrt(x); });
+		return result;
+	}
+
+	euclidean_vector_batch unit(euclidean_vector_batch const& v) {
+		if (v.dimensions() == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a unit vector");
+		}
+		auto const norms = euclidean_norm(v);
+		if (std::any_of(norms.begin(), norms.end(), [](double const d) { return std::abs(d-0) < 0.0001; })) {
+			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a unit vector");
+		}
+		auto result = euclidean_vector_batch(v);
+		for (auto r = 0; r < result.rows(); ++r) {
+			auto row = result[r];
+			for (auto d = 0; d < result.dimensions(); ++d) {
+				row[d] /= norms[static_cast<std::size_t>(r)];
+			}
+		}
+		return result;
+	}
+
+	namespace detail {
+		euclidean_vector_batch row_major(euclidean_vector_batch vectors) {
+			if (vectors.layout() == batch_layout::row_major) {
+				return vectors;
+			}
+			auto result = euclidean_vector_batch(vectors.rows(), vectors.dimensions(), batch_layout::row_major,
+			                                     vectors.get_allocator());
+			for (auto r = 0; r < vectors.rows(); ++r) {
+				auto const from = std::as_const(vectors)[r];
+				auto const to = result[r];
+				for (auto d = 0; d < vectors.dimensions(); ++d) {
+					to[d] = from[d];
+				}
+			}
+			return result;
+		}
+	} // namespace detail
+} // namespace comp6771
@@ -0,0 +1,258 @@
+#include "comp6771/euclidean_vector_file.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace comp6771 {
+	namespace {
+		static_assert(std::endian::native == std::endian::little, "vector files are read and written in place");
+
+		[[noreturn]] void throw_errno(std::string const& what, std::filesystem::path const& path) {
+			throw std::system_error(errno, std::generic_category(), what + " " + path.string());
+		}
+
+		void check_alignment(std::size_t const alignment) {
+			if (alignment < sizeof(double) or alignment > 4096 or not std::has_single_bit(alignment)) {
+				throw euclidean_vector_error("Alignment " + std::to_string(alignment) + " is not valid for a vector file");
+			}
+		}
+
+		//Rounded up without forming dimensions + per_line - 1, which could wrap for a corrupt header.
+		std::uint64_t stride_of(std::uint64_t const dimensions, std::uint64_t const alignment) noexcept {
+			auto const per_line = alignment / sizeof(double);
+			return (dimensions / per_line + (dimensions % per_line != 0 ? 1 : 0)) * per_line;
+		}
+
+		//Closes the descriptor on every path out of a function.
+		class file_descriptor {
+		public:
+			explicit file_descriptor(int const fd) noexcept : fd_{fd} {}
+			file_descriptor(file_descriptor const&) = delete;
+			file_descriptor& operator=(file_descriptor const&) = delete;
+			~file_descriptor() {
+				if (fd_ >= 0) {
+					::close(fd_);
+				}
+			}
+
+			int get() const noexcept { return fd_; }
+
+		private:
+			int fd_;
+		};
+
+		void write_all(int const fd, void const* data, std::size_t size, off_t offset, std::filesystem::path const& path) {
+			auto const* bytes = static_cast<char const*>(data);
+			while (size > 0) {
+				auto const written = ::pwrite(fd, bytes, size, offset);
+				if (written < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					throw_errno("Could not write", path);
+				}
+				bytes += written;
+				size -= static_cast<std::size_t>(written);
+				offset += written;
+			}
+		}
+
+		//Writes the records one at a time through a stride-sized buffer, so padding is zeroed and the
+		//checksum is accumulated without holding the whole payload.
+		template<typename Record>
+		void write_records(std::filesystem::path const& path, std::size_t const count, std::size_t const dimensions,
+		                   std::size_t const alignment, Record record) {
+			check_alignment(alignment);
+			auto header = vector_file_header{};
+			header.magic = vector_file_header::expected_magic;
+			header.version = vector_file_header::current_version;
+			header.dtype = vector_file_dtype::float64;
+			header.count = count;
+			header.dimensions = dimensions;
+			header.alignment = alignment;
+			header.payload_offset = std::max<std::uint64_t>(alignment, sizeof(vector_file_header));
+			header.checksum = vector_file_checksum({});
+
+			auto const fd = file_descriptor(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+			if (fd.get() < 0) {
+				throw_errno("Could not create", path);
+			}
+
+			auto const stride = static_cast<std::size_t>(stride_of(dimensions, alignment));
+			auto buffer = std::vector<double>(stride, 0.0);
+			auto offset = static_cast<off_t>(header.payload_offset);
+			for (std::size_t i = 0; i < count; ++i) {
+				record(i, buffer.data());
+				header.checksum = vector_file_checksum(buffer, header.checksum);
+				write_all(fd.get(), buffer.data(), sizeof(double) * stride, offset, path);
+				offset += static_cast<off_t>(sizeof(double) * stride);
+			}
+			//Written last, so a file cut short by a failure never carries a valid header.
+			write_all(fd.get(), &header, sizeof(header), 0, path);
+			if (::ftruncate(fd.get(), offset) != 0) {
+				throw_errno("Could not write", path);
+			}
+		}
+	} // namespace
+
+	std::uint64_t vector_file_checksum(std::span<double const> const payload, std::uint64_t seed) noexcept {
+		constexpr auto prime = std::uint64_t{0x100'0000'01b3};
+		for (auto const d : payload) {
+			seed = (seed ^ std::bit_cast<std::uint64_t>(d)) * prime;
+			seed ^= seed >> 32;
+		}
+		return seed;
+	}
+
+	void write_vector_file(std::filesystem::path const& path, std::span<euclidean_vector const> const vectors,
+	                       std::size_t const alignment) {
+		auto const dimensions = vectors.empty() ? 0 : detail::vector_access::size(vectors.front());
+		for (auto const& v : vectors) {
+			detail::check_dimensions(dimensions, detail::vector_access::size(v));
+		}
+		write_records(path, vectors.size(), dimensions, alignment, [&](std::size_t const i, double* out) {
+			std::memcpy(out, detail::vector_access::data(vectors[i]), sizeof(double) * dimensions);
+		});
+	}
+
+	void write_vector_file(std::filesystem::path const& path, euclidean_vector_batch const& vectors,
+	                       std::size_t const alignment) {
+		write_records(path, static_cast<std::size_t>(vectors.rows()), static_cast<std::size_t>(vectors.dimensions()),
+		              alignment, [&](std::size_t const i, double* out) {
+			auto const row = vectors[static_cast<int>(i)];
+			for (auto d = 0; d < row.dimensions(); ++d) {
+				out[d] = row[d];
+			}
+		});
+	}
+
+	mapped_vector_file::mapped_vector_file(std::filesystem::path const& path) {
+		auto const fd = file_descriptor(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+		if (fd.get() < 0) {
+			throw_errno("Could not open", path);
+		}
+		struct ::stat status{};
+		if (::fstat(fd.get(), &status) != 0) {
+			throw_errno("Could not open", path);
+		}
+		auto const length = static_cast<std::uint64_t>(status.st_size);
+		if (length < sizeof(vector_file_header)) {
+			throw euclidean_vector_error(path.string() + " is too short to be a vector file");
+		}
+		if (::pread(fd.get(), &header_, sizeof(header_), 0) != static_cast<ssize_t>(sizeof(header_))) {
+			throw_errno("Could not read", path);
+		}
+
+		if (header_.magic != vector_file_header::expected_magic) {
+			throw euclidean_vector_error(path.string() + " is not a vector file");
+		}
+		if (header_.version != vector_file_header::current_version or header_.dtype != vector_file_dtype::float64) {
+			throw euclidean_vector_error(path.string() + " has an unsupported version or dtype");
+		}
+		check_alignment(header_.alignment);
+		//size() and dimensions() are ints, and a record with no dimensions has no bytes to check the
+		//count against.
+		constexpr auto largest = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+		if (header_.count > largest or header_.dimensions > largest or (header_.dimensions == 0 and header_.count != 0)) {
+			throw euclidean_vector_error(path.string() + " has a malformed header");
+		}
+		auto const stride = stride_of(header_.dimensions, header_.alignment);
+		//The payload in doubles, compared by division so count * stride can't wrap.
+		auto const available = length < header_.payload_offset ? 0 : (length - header_.payload_offset) / sizeof(double);
+		if (header_.payload_offset < sizeof(vector_file_header) or header_.payload_offset % header_.alignment != 0
+		    or (stride != 0 and header_.count > available / stride)) {
+			throw euclidean_vector_error(path.string() + " is truncated or has a malformed header");
+		}
+		stride_ = static_cast<std::size_t>(stride);
+
+		length_ = static_cast<std::size_t>(length);
+		mapping_ = ::mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd.get(), 0);
+		if (mapping_ == MAP_FAILED) {
+			mapping_ = nullptr;
+			throw_errno("Could not map", path);
+		}
+		payload_ = reinterpret_cast<double const*>(static_cast<char const*>(mapping_) + header_.payload_offset);
+	}
+
+	mapped_vector_file::mapped_vector_file(mapped_vector_file&& other) noexcept
+	: mapping_{std::exchange(other.mapping_, nullptr)}, length_{std::exchange(other.length_, 0)}
+	, header_{std::exchange(other.header_, {})}, payload_{std::exchange(other.payload_, nullptr)}
+	, stride_{std::exchange(other.stride_, 0)} {}
+
+	mapped_vector_file& mapped_vector_file::operator=(mapped_vector_file&& other) noexcept {
+		if (this != &other) {
+			Unmap();
+			mapping_ = std::exchange(other.mapping_, nullptr);
+			length_ = std::exchange(other.length_, 0);
+			header_ = std::exchange(other.header_, {});
+			payload_ = std::exchange(other.payload_, nullptr);
+			stride_ = std::exchange(other.stride_, 0);
+		}
+		return *this;
+	}
+
+	mapped_vector_file::~mapped_vector_file() {
+		Unmap();
+	}
+
+	void mapped_vector_file::Unmap() noexcept {
+		if (mapping_ != nullptr) {
+			::munmap(mapping_, length_);
+			mapping_ = nullptr;
+		}
+	}
+
+	const_euclidean_vector_view mapped_vector_file::operator[](int const i) const noexcept {
+		auto const* first = payload_ + static_cast<std::size_t>(i) * stride_;
+		return const_euclidean_vector_view(std::span<double const>(first, static_cast<std::size_t>(header_.dimensions)));
+	}
+
+	const_euclidean_vector_view mapped_vector_file::record(int const i) const {
+		if (i < 0 or i >= size()) {
+			throw euclidean_vector_error("Record " + std::to_string(i) + " is not valid for this mapped_vector_file object");
+		}
+		return (*this)[i];
+	}
+
+	euclidean_vector mapped_vector_file::load(int const i, euclidean_vector::allocator_type const& alloc) const {
+		return euclidean_vector(record(i).magnitudes(), alloc);
+	}
+
+	euclidean_vector_batch mapped_vector_file::load_batch(batch_layout const layout,
+	                                                      euclidean_vector_batch::allocator_type const& alloc) const {
+		auto result = euclidean_vector_batch(size(), dimensions(), layout, alloc);
+		for (auto r = 0; r < size(); ++r) {
+			auto const source = (*this)[r];
+			if (layout == batch_layout::row_major) {
+				std::memcpy(result.data() + static_cast<std::size_t>(r) * result.leading_dimension(), source.data(),
+				            sizeof(double) * source.magnitudes().size());
+			} else {
+				auto row = result[r];
+				for (auto d = 0; d < dimensions(); ++d) {
+					row[d] = source[d];
+				}
+			}
+		}
+		return result;
+	}
+
+	bool mapped_vector_file::verify() const noexcept {
+		auto const payload = std::span<double const>(payload_, static_cast<std::size_t>(header_.count) * stride_);
+		return vector_file_checksum(payload) == header_.checksum;
+	}
+} // namespace comp6771
@@ -0,0 +1,269 @@
+#include "comp6771/euclidean_vector_format.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <ios>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		bool is_blank(char const c) noexcept {
+			return c == ' ' or c == '\t';
+		}
+
+		bool is_line_end(char const c) noexcept {
+			return c == '\n' or c == '\r';
+		}
+
+		bool is_space(char const c) noexcept {
+			return is_blank(c) or is_line_end(c) or c == '\v' or c == '\f';
+		}
+
+		template<typename Predicate>
+		char const* skip(char const* p, char const* const last, Predicate skipped) noexcept {
+			while (p != last and skipped(*p)) {
+				++p;
+			}
+			return p;
+		}
+
+		//Longest text one magnitude of type T can take, sign included. For double: 26 chars shortest,
+		//and fixed notation needs up to 309 integer digits, or ~340 fraction digits for a denormal.
+		template<typename T>
+		std::size_t max_magnitude_chars(text_format const& format) noexcept {
+			using limits = std::numeric_limits<T>;
+			//printf treats a negative precision as if none were given.
+			auto const precision = static_cast<std::size_t>(std::max(format.precision.value_or(6), 0));
+			auto const significant = static_cast<std::size_t>(limits::max_digits10);
+			auto const integer_digits = static_cast<std::size_t>(limits::max_exponent10) + 1;
+			auto const denormal_digits = static_cast<std::size_t>(-limits::min_exponent10 + limits::digits10) + 3;
+			switch (format.notation) {
+			case std::chars_format::fixed:
+				//"-" + integer digits + "." + fraction
+				return format.precision ? integer_digits + 2 + precision : integer_digits + 2 + denormal_digits;
+			case std::chars_format::hex:
+				//"-1." + hex digits + "p-16445"
+				return (format.precision ? precision : static_cast<std::size_t>(limits::digits + 3) / 4) + 10;
+			default:
+				//"-1." + digits + "e-4951", or at most as long when general picks fixed.
+				return (format.precision ? precision : significant) + 10;
+			}
+		}
+
+		char magnitude_separator(text_layout const layout) noexcept {
+			return layout == text_layout::csv ? ',' : ' ';
+		}
+
+		template<typename T>
+		std::from_chars_result parse_magnitude(char const* first, char const* const last, T& value) noexcept {
+			//from_chars rejects a leading '+', which other tools happily write.
+			auto p = first;
+			if (p != last and *p == '+' and last - p > 1 and p[1] != '-') {
+				++p;
+			}
+			auto const result = std::from_chars(p, last, value);
+			return result.ec == std::errc{} ? result : std::from_chars_result{first, result.ec};
+		}
+	} // namespace
+
+	template<std::floating_point T>
+	std::size_t max_chars(std::size_t const dimensions, text_format const& format) noexcept {
+		auto const brackets = format.layout == text_layout::bracketed ? std::size_t{2} : 0;
+		if (dimensions == 0) {
+			return brackets;
+		}
+		return brackets + dimensions * max_magnitude_chars<T>(format) + (dimensions - 1);
+	}
+
+	template std::size_t max_chars<float>(std::size_t, text_format const&) noexcept;
+	template std::size_t max_chars<double>(std::size_t, text_format const&) noexcept;
+	template std::size_t max_chars<long double>(std::size_t, text_format const&) noexcept;
+
+	namespace {
+	template<typename T>
+	std::to_chars_result format_magnitudes(char* first, char* const last, std::span<T const> const magnitudes,
+	                                       text_format const& format) {
+		auto const too_large = std::to_chars_result{last, std::errc::value_too_large};
+		auto const bracketed = format.layout == text_layout::bracketed;
+		auto const separator = magnitude_separator(format.layout);
+		if (bracketed) {
+			if (first == last) {
+				return too_large;
+			}
+			*first++ = '[';
+		}
+		for (std::size_t i = 0; i < magnitudes.size(); ++i) {
+			if (i != 0) {
+				if (first == last) {
+					return too_large;
+				}
+				*first++ = separator;
+			}
+			auto const result = format.precision
+			                  ? std::to_chars(first, last, magnitudes[i], format.notation, *format.precision)
+			                  : std::to_chars(first, last, magnitudes[i], format.notation);
+			if (result.ec != std::errc{}) {
+				return too_large;
+			}
+			first = result.ptr;
+		}
+		if (bracketed) {
+			if (first == last) {
+				return too_large;
+			}
+			*first++ = ']';
+		}
+		return {first, std::errc{}};
+	}
+
+	template<typename T>
+	std::from_chars_result parse_magnitudes(char const* first, char const* const last, std::vector<T>& magnitudes,
+	                                        text_layout const layout) {
+		auto const original = magnitudes.size();
+		auto fail = [&](char const* const where, std::errc const ec = std::errc::invalid_argument) {
+			magnitudes.resize(original);
+			return std::from_chars_result{where, ec};
+		};
+		auto value = T{0};
+
+		if (layout == text_layout::bracketed) {
+			auto p = skip(first, last, is_space);
+			if (p == last or *p != '[') {
+				return fail(p);
+			}
+			p = skip(p + 1, last, is_space);
+			while (p != last and *p != ']') {
+				auto const result = parse_magnitude(p, last, value);
+				if (result.ec != std::errc{}) {
+					return fail(result.ptr, result.ec);
+				}
+				if (result.ptr != last and not is_space(*result.ptr) and *result.ptr != ']') {
+					return fail(result.ptr);
+				}
+				magnitudes.push_back(value);
+				p = skip(result.ptr, last, is_space);
+			}
+			if (p == last) {
+				return fail(p);
+			}
+			return {p + 1, std::errc{}};
+		}
+
+		auto const csv = layout == text_layout::csv;
+		auto p = skip(first, last, is_blank);
+		if (p == last or is_line_end(*p)) {
+			return {p, std::errc{}};
+		}
+		for (;;) {
+			auto const result = parse_magnitude(p, last, value);
+			if (result.ec != std::errc{}) {
+				return fail(result.ptr, result.ec);
+			}
+			magnitudes.push_back(value);
+			p = skip(result.ptr, last, is_blank);
+			if (p == last or is_line_end(*p)) {
+				return {p, std::errc{}};
+			}
+			if (csv) {
+				if (*p != ',') {
+					return fail(p);
+				}
+				p = skip(p + 1, last, is_blank);
+			} else if (p == result.ptr) {
+				//Magnitudes must be separated by at least one blank.
+				return fail(p);
+			}
+		}
+	}
+
+	template<typename T>
+	std::ostream& write_magnitudes(std::ostream& os, std::span<T const> const magnitudes) {
+		auto format = text_format{text_layout::whitespace};
+		switch (os.flags() & std::ios_base::floatfield) {
+		case std::ios_base::fixed:
+			format.notation = std::chars_format::fixed;
+			break;
+		case std::ios_base::scientific:
+			format.notation = std::chars_format::scientific;
+			break;
+		case std::ios_base::fixed | std::ios_base::scientific:
+			format.notation = std::chars_format::hex;
+			break;
+		default:
+			break;
+		}
+		if (format.notation != std::chars_format::hex) {
+			format.precision = static_cast<int>(os.precision());
+		}
+
+		//A block of magnitudes at a time through a stack buffer, so no vector is too long to print
+		//without allocating. Only an absurd precision needs the heap.
+		auto stack = std::array<char, 4096>{};
+		auto heap = std::string();
+		auto buffer = std::span<char>(stack);
+		auto const per_magnitude = max_chars<T>(1, format) + 1;
+		if (per_magnitude > buffer.size()) {
+			heap.resize(per_magnitude);
+			buffer = heap;
+		}
+		auto const block = buffer.size() / per_magnitude;
+		os.put('[');
+		for (std::size_t i = 0; i < magnitudes.size(); i += block) {
+			auto* out = buffer.data();
+			if (i != 0) {
+				*out++ = ' ';
+			}
+			auto const part = magnitudes.subspan(i, std::min(block, magnitudes.size() - i));
+			auto const result = format_magnitudes(out, buffer.data() + buffer.size(), part, format);
+			os.write(buffer.data(), result.ptr - buffer.data());
+		}
+		return os.put(']');
+	}
+	} // namespace
+
+	std::to_chars_result to_chars(char* first, char* last, std::span<float const> magnitudes, text_format const& format) {
+		return format_magnitudes(first, last, magnitudes, format);
+	}
+
+	std::to_chars_result to_chars(char* first, char* last, std::span<double const> magnitudes, text_format const& format) {
+		return format_magnitudes(first, last, magnitudes, format);
+	}
+
+	std::to_chars_result to_chars(char* first, char* last, std::span<long double const> magnitudes,
+	                              text_format const& format) {
+		return format_magnitudes(first, last, magnitudes, format);
+	}
+
+	std::from_chars_result from_chars(char const* first, char const* last, std::vector<float>& magnitudes,
+	                                  text_layout layout) {
+		return parse_magnitudes(first, last, magnitudes, layout);
+	}
+
+	std::from_chars_result from_chars(char const* first, char const* last, std::vector<double>& magnitudes,
+	                                  text_layout layout) {
+		return parse_magnitudes(first, last, magnitudes, layout);
+	}
+
+	std::from_chars_result from_chars(char const* first, char const* last, std::vector<long double>& magnitudes,
+	                                  text_layout layout) {
+		return parse_magnitudes(first, last, magnitudes, layout);
+	}
+
+	std::ostream& write_text(std::ostream& os, std::span<float const> magnitudes) {
+		return write_magnitudes(os, magnitudes);
+	}
+
+	std::ostream& write_text(std::ostream& os, std::span<double const> magnitudes) {
+		return write_magnitudes(os, magnitudes);
+	}
+
+	std::ostream& write_text(std::ostream& os, std::span<long double const> magnitudes) {
+		return write_magnitudes(os, magnitudes);
+	}
+} // namespace comp6771
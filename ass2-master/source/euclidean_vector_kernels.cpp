@@ -0,0 +1,777 @@
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define COMP6771_KERNELS_X86 1
+#include <immintrin.h>
+#define COMP6771_TARGET(isa) __attribute__((target(isa)))
+#else
+#define COMP6771_KERNELS_X86 0
+#endif
+
+namespace comp6771::kernels {
+	namespace {
+		//The scalar kernels are the reference every other path is tested against. dot keeps the
+		//left-to-right summation order std::inner_product used.
+		double scalar_dot(double const* x, double const* y, std::size_t n) {
+			auto r = 0.0;
+			for (std::size_t i = 0; i < n; ++i) {
+				r += x[i] * y[i];
+			}
+			return r;
+		}
+
+		double scalar_squared_norm(double const* x, std::size_t n) {
+			return scalar_dot(x, x, n);
+		}
+
+		double scalar_squared_distance(double const* x, double const* y, std::size_t n) {
+			auto r = 0.0;
+			for (std::size_t i = 0; i < n; ++i) {
+				auto const d = x[i] - y[i];
+				r += d * d;
+			}
+			return r;
+		}
+
+		double scalar_manhattan_distance(double const* x, double const* y, std::size_t n) {
+			auto r = 0.0;
+			for (std::size_t i = 0; i < n; ++i) {
+				r += std::abs(x[i] - y[i]);
+			}
+			return r;
+		}
+
+		double scalar_chebyshev_distance(double const* x, double const* y, std::size_t n) {
+			auto r = 0.0;
+			for (std::size_t i = 0; i < n; ++i) {
+				r = std::max(r, std::abs(x[i] - y[i]));
+			}
+			return r;
+		}
+
+		fused_dot scalar_dot_and_squared_norms(double const* x, double const* y, std::size_t n) {
+			auto r = fused_dot{0.0, 0.0, 0.0};
+			for (std::size_t i = 0; i < n; ++i) {
+				r.xy += x[i] * y[i];
+				r.xx += x[i] * x[i];
+				r.yy += y[i] * y[i];
+			}
+			return r;
+		}
+
+		void scalar_dot_tile(double const* a, double const* b, std::size_t k, double* c) {
+			for (std::size_t s = 0; s < k; ++s) {
+				for (std::size_t i = 0; i < tile_rows; ++i) {
+					for (std::size_t j = 0; j < tile_columns; ++j) {
+						c[i * tile_columns + j] += a[s * tile_rows + i] * b[s * tile_columns + j];
+					}
+				}
+			}
+		}
+
+		void scalar_add(double* x, double const* y, std::size_t n) {
+			for (std::size_t i = 0; i < n; ++i) {
+				x[i] += y[i];
+			}
+		}
+
+		void scalar_subtract(double* x, double const* y, std::size_t n) {
+			for (std::size_t i = 0; i < n; ++i) {
+				x[i] -= y[i];
+			}
+		}
+
+		void scalar_multiply(double* x, double b, std::size_t n) {
+			for (std::size_t i = 0; i < n; ++i) {
+				x[i] *= b;
+			}
+		}
+
+		void scalar_divide(double* x, double b, std::size_t n) {
+			for (std::size_t i = 0; i < n; ++i) {
+				x[i] /= b;
+			}
+		}
+
+		constexpr auto scalar_table = kernel_table{isa::scalar, scalar_dot, scalar_squared_norm,
+			scalar_squared_distance, scalar_manhattan_distance, scalar_chebyshev_distance,
+			scalar_dot_and_squared_norms, scalar_dot_tile, scalar_add, scalar_subtract, scalar_multiply, scalar_divide};
+
+#if COMP6771_KERNELS_X86
+		//SSE2: two doubles per register, two independent accumulators to hide add latency.
+		COMP6771_TARGET("sse2")
+		double sse2_dot(double const* x, double const* y, std::size_t n) {
+			auto acc0 = _mm_setzero_pd();
+			auto acc1 = _mm_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+				acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+			}
+			auto const acc = _mm_add_pd(acc0, acc1);
+			auto r = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+			for (; i < n; ++i) {
+				r += x[i] * y[i];
+			}
+			return r;
+		}
+
+		COMP6771_TARGET("sse2")
+		double sse2_squared_norm(double const* x, std::size_t n) {
+			return sse2_dot(x, x, n);
+		}
+
+		COMP6771_TARGET("sse2")
+		double sse2_squared_distance(double const* x, double const* y, std::size_t n) {
+			auto acc0 = _mm_setzero_pd();
+			auto acc1 = _mm_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				auto const d0 = _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i));
+				auto const d1 = _mm_sub_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2));
+				acc0 = _mm_add_pd(acc0, _mm_mul_pd(d0, d0));
+				acc1 = _mm_add_pd(acc1, _mm_mul_pd(d1, d1));
+			}
+			auto const acc = _mm_add_pd(acc0, acc1);
+			auto r = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+			for (; i < n; ++i) {
+				auto const d = x[i] - y[i];
+				r += d * d;
+			}
+			return r;
+		}
+
+		COMP6771_TARGET("sse2")
+		double sse2_manhattan_distance(double const* x, double const* y, std::size_t n) {
+			auto const sign = _mm_set1_pd(-0.0);
+			auto acc0 = _mm_setzero_pd();
+			auto acc1 = _mm_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				acc0 = _mm_add_pd(acc0, _mm_andnot_pd(sign, _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i))));
+				acc1 = _mm_add_pd(acc1, _mm_andnot_pd(sign, _mm_sub_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2))));
+			}
+			auto const acc = _mm_add_pd(acc0, acc1);
+			auto r = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+			for (; i < n; ++i) {
+				r += std::abs(x[i] - y[i]);
+			}
+			return r;
+		}
+
+		COMP6771_TARGET("sse2")
+		double sse2_chebyshev_distance(double const* x, double const* y, std::size_t n) {
+			auto const sign = _mm_set1_pd(-0.0);
+			auto acc = _mm_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				acc = _mm_max_pd(acc, _mm_andnot_pd(sign, _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i))));
+			}
+			auto r = _mm_cvtsd_f64(_mm_max_sd(acc, _mm_unpackhi_pd(acc, acc)));
+			for (; i < n; ++i) {
+				r = std::max(r, std::abs(x[i] - y[i]));
+			}
+			return r;
+		}
+
+		COMP6771_TARGET("sse2")
+		fused_dot sse2_dot_and_squared_norms(double const* x, double const* y, std::size_t n) {
+			auto xy = _mm_setzero_pd();
+			auto xx = _mm_setzero_pd();
+			auto yy = _mm_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				auto const a = _mm_loadu_pd(x + i);
+				auto const b = _mm_loadu_pd(y + i);
+				xy = _mm_add_pd(xy, _mm_mul_pd(a, b));
+				xx = _mm_add_pd(xx, _mm_mul_pd(a, a));
+				yy = _mm_add_pd(yy, _mm_mul_pd(b, b));
+			}
+			auto r = fused_dot{_mm_cvtsd_f64(_mm_add_sd(xy, _mm_unpackhi_pd(xy, xy))),
+			                   _mm_cvtsd_f64(_mm_add_sd(xx, _mm_unpackhi_pd(xx, xx))),
+			                   _mm_cvtsd_f64(_mm_add_sd(yy, _mm_unpackhi_pd(yy, yy)))};
+			for (; i < n; ++i) {
+				r.xy += x[i] * y[i];
+				r.xx += x[i] * x[i];
+				r.yy += y[i] * y[i];
+			}
+			return r;
+		}
+
+		//Sixteen accumulators: every XMM register, with the operands reloaded from L1.
+		COMP6771_TARGET("sse2")
+		void sse2_dot_tile(double const* a, double const* b, std::size_t k, double* c) {
+			__m128d acc[tile_rows][tile_columns / 2];
+			for (std::size_t i = 0; i < tile_rows; ++i) {
+				for (std::size_t j = 0; j < tile_columns / 2; ++j) {
+					acc[i][j] = _mm_setzero_pd();
+				}
+			}
+			for (std::size_t s = 0; s < k; ++s) {
+				for (std::size_t i = 0; i < tile_rows; ++i) {
+					auto const x = _mm_set1_pd(a[s * tile_rows + i]);
+					for (std::size_t j = 0; j < tile_columns / 2; ++j) {
+						acc[i][j] = _mm_add_pd(acc[i][j], _mm_mul_pd(x, _mm_loadu_pd(b + s * tile_columns + 2 * j)));
+					}
+				}
+			}
+			for (std::size_t i = 0; i < tile_rows; ++i) {
+				for (std::size_t j = 0; j < tile_columns / 2; ++j) {
+					auto* out = c + i * tile_columns + 2 * j;
+					_mm_storeu_pd(out, _mm_add_pd(_mm_loadu_pd(out), acc[i][j]));
+				}
+			}
+		}
+
+		COMP6771_TARGET("sse2")
+		void sse2_add(double* x, double const* y, std::size_t n) {
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				_mm_storeu_pd(x + i, _mm_add_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+			}
+			for (; i < n; ++i) {
+				x[i] += y[i];
+			}
+		}
+
+		COMP6771_TARGET("sse2")
+		void sse2_subtract(double* x, double const* y, std::size_t n) {
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				_mm_storeu_pd(x + i, _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+			}
+			for (; i < n; ++i) {
+				x[i] -= y[i];
+			}
+		}
+
+		COMP6771_TARGET("sse2")
+		void sse2_multiply(double* x, double b, std::size_t n) {
+			auto const s = _mm_set1_pd(b);
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				_mm_storeu_pd(x + i, _mm_mul_pd(_mm_loadu_pd(x + i), s));
+			}
+			for (; i < n; ++i) {
+				x[i] *= b;
+			}
+		}
+
+		COMP6771_TARGET("sse2")
+		void sse2_divide(double* x, double b, std::size_t n) {
+			auto const s = _mm_set1_pd(b);
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				_mm_storeu_pd(x + i, _mm_div_pd(_mm_loadu_pd(x + i), s));
+			}
+			for (; i < n; ++i) {
+				x[i] /= b;
+			}
+		}
+
+		//AVX2: four doubles per register, four accumulators and FMA for the reductions.
+		COMP6771_TARGET("avx2,fma")
+		double avx2_dot(double const* x, double const* y, std::size_t n) {
+			auto acc0 = _mm256_setzero_pd();
+			auto acc1 = _mm256_setzero_pd();
+			auto acc2 = _mm256_setzero_pd();
+			auto acc3 = _mm256_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+				acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), acc1);
+				acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8), acc2);
+				acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), acc3);
+			}
+			for (; i + 4 <= n; i += 4) {
+				acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+			}
+			auto const acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+			auto const half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+			auto r = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+			for (; i < n; ++i) {
+				r += x[i] * y[i];
+			}
+			return r;
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		double avx2_squared_norm(double const* x, std::size_t n) {
+			return avx2_dot(x, x, n);
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		double avx2_squared_distance(double const* x, double const* y, std::size_t n) {
+			auto acc0 = _mm256_setzero_pd();
+			auto acc1 = _mm256_setzero_pd();
+			auto acc2 = _mm256_setzero_pd();
+			auto acc3 = _mm256_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				auto const d0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i));
+				auto const d1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4));
+				auto const d2 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8));
+				auto const d3 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12));
+				acc0 = _mm256_fmadd_pd(d0, d0, acc0);
+				acc1 = _mm256_fmadd_pd(d1, d1, acc1);
+				acc2 = _mm256_fmadd_pd(d2, d2, acc2);
+				acc3 = _mm256_fmadd_pd(d3, d3, acc3);
+			}
+			for (; i + 4 <= n; i += 4) {
+				auto const d = _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i));
+				acc0 = _mm256_fmadd_pd(d, d, acc0);
+			}
+			auto const acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+			auto const half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+			auto r = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+			for (; i < n; ++i) {
+				auto const d = x[i] - y[i];
+				r += d * d;
+			}
+			return r;
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		double avx2_sum(__m256d const acc) {
+			auto const half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+			return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		double avx2_manhattan_distance(double const* x, double const* y, std::size_t n) {
+			auto const sign = _mm256_set1_pd(-0.0);
+			auto acc0 = _mm256_setzero_pd();
+			auto acc1 = _mm256_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				auto const d0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i));
+				auto const d1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4));
+				acc0 = _mm256_add_pd(acc0, _mm256_andnot_pd(sign, d0));
+				acc1 = _mm256_add_pd(acc1, _mm256_andnot_pd(sign, d1));
+			}
+			for (; i + 4 <= n; i += 4) {
+				acc0 = _mm256_add_pd(acc0, _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i))));
+			}
+			auto r = avx2_sum(_mm256_add_pd(acc0, acc1));
+			for (; i < n; ++i) {
+				r += std::abs(x[i] - y[i]);
+			}
+			return r;
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		double avx2_chebyshev_distance(double const* x, double const* y, std::size_t n) {
+			auto const sign = _mm256_set1_pd(-0.0);
+			auto acc = _mm256_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				acc = _mm256_max_pd(acc, _mm256_andnot_pd(sign, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i))));
+			}
+			auto const half = _mm_max_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+			auto r = _mm_cvtsd_f64(_mm_max_sd(half, _mm_unpackhi_pd(half, half)));
+			for (; i < n; ++i) {
+				r = std::max(r, std::abs(x[i] - y[i]));
+			}
+			return r;
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		fused_dot avx2_dot_and_squared_norms(double const* x, double const* y, std::size_t n) {
+			auto xy = _mm256_setzero_pd();
+			auto xx = _mm256_setzero_pd();
+			auto yy = _mm256_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				auto const a = _mm256_loadu_pd(x + i);
+				auto const b = _mm256_loadu_pd(y + i);
+				xy = _mm256_fmadd_pd(a, b, xy);
+				xx = _mm256_fmadd_pd(a, a, xx);
+				yy = _mm256_fmadd_pd(b, b, yy);
+			}
+			auto r = fused_dot{avx2_sum(xy), avx2_sum(xx), avx2_sum(yy)};
+			for (; i < n; ++i) {
+				r.xy += x[i] * y[i];
+				r.xx += x[i] * x[i];
+				r.yy += y[i] * y[i];
+			}
+			return r;
+		}
+
+		static_assert(tile_rows == 4 and tile_columns == 8, "the AVX2 and AVX-512 dot_tile kernels are unrolled for 4 x 8");
+
+		//Eight accumulators, two per row; each step is two loads, four broadcasts and eight FMAs.
+		COMP6771_TARGET("avx2,fma")
+		void avx2_dot_tile(double const* a, double const* b, std::size_t k, double* c) {
+			auto c00 = _mm256_setzero_pd();
+			auto c01 = _mm256_setzero_pd();
+			auto c10 = _mm256_setzero_pd();
+			auto c11 = _mm256_setzero_pd();
+			auto c20 = _mm256_setzero_pd();
+			auto c21 = _mm256_setzero_pd();
+			auto c30 = _mm256_setzero_pd();
+			auto c31 = _mm256_setzero_pd();
+			for (std::size_t s = 0; s < k; ++s) {
+				auto const b0 = _mm256_loadu_pd(b + s * tile_columns);
+				auto const b1 = _mm256_loadu_pd(b + s * tile_columns + 4);
+				auto const* x = a + s * tile_rows;
+				auto const a0 = _mm256_broadcast_sd(x);
+				c00 = _mm256_fmadd_pd(a0, b0, c00);
+				c01 = _mm256_fmadd_pd(a0, b1, c01);
+				auto const a1 = _mm256_broadcast_sd(x + 1);
+				c10 = _mm256_fmadd_pd(a1, b0, c10);
+				c11 = _mm256_fmadd_pd(a1, b1, c11);
+				auto const a2 = _mm256_broadcast_sd(x + 2);
+				c20 = _mm256_fmadd_pd(a2, b0, c20);
+				c21 = _mm256_fmadd_pd(a2, b1, c21);
+				auto const a3 = _mm256_broadcast_sd(x + 3);
+				c30 = _mm256_fmadd_pd(a3, b0, c30);
+				c31 = _mm256_fmadd_pd(a3, b1, c31);
+			}
+			_mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c00));
+			_mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c01));
+			_mm256_storeu_pd(c + 8, _mm256_add_pd(_mm256_loadu_pd(c + 8), c10));
+			_mm256_storeu_pd(c + 12, _mm256_add_pd(_mm256_loadu_pd(c + 12), c11));
+			_mm256_storeu_pd(c + 16, _mm256_add_pd(_mm256_loadu_pd(c + 16), c20));
+			_mm256_storeu_pd(c + 20, _mm256_add_pd(_mm256_loadu_pd(c + 20), c21));
+			_mm256_storeu_pd(c + 24, _mm256_add_pd(_mm256_loadu_pd(c + 24), c30));
+			_mm256_storeu_pd(c + 28, _mm256_add_pd(_mm256_loadu_pd(c + 28), c31));
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		void avx2_add(double* x, double const* y, std::size_t n) {
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				_mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+			}
+			for (; i < n; ++i) {
+				x[i] += y[i];
+			}
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		void avx2_subtract(double* x, double const* y, std::size_t n) {
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				_mm256_storeu_pd(x + i, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+			}
+			for (; i < n; ++i) {
+				x[i] -= y[i];
+			}
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		void avx2_multiply(double* x, double b, std::size_t n) {
+			auto const s = _mm256_set1_pd(b);
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				_mm256_storeu_pd(x + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), s));
+			}
+			for (; i < n; ++i) {
+				x[i] *= b;
+			}
+		}
+
+		COMP6771_TARGET("avx2,fma")
+		void avx2_divide(double* x, double b, std::size_t n) {
+			auto const s = _mm256_set1_pd(b);
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				_mm256_storeu_pd(x + i, _mm256_div_pd(_mm256_loadu_pd(x + i), s));
+			}
+			for (; i < n; ++i) {
+				x[i] /= b;
+			}
+		}
+
+		//AVX-512: eight doubles per register; tails use masked loads and stores instead of a
+		//scalar loop.
+		COMP6771_TARGET("avx512f")
+		double avx512_dot(double const* x, double const* y, std::size_t n) {
+			auto acc0 = _mm512_setzero_pd();
+			auto acc1 = _mm512_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), acc0);
+				acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), acc1);
+			}
+			for (; i + 8 <= n; i += 8) {
+				acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), acc0);
+			}
+			if (i < n) {
+				auto const mask = static_cast<__mmask8>((1U << (n - i)) - 1U);
+				acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i), acc1);
+			}
+			//Spelled out rather than _mm512_reduce_add_pd, which trips -Wuninitialized in GCC's headers.
+			alignas(64) double lanes[8];
+			_mm512_store_pd(lanes, _mm512_add_pd(acc0, acc1));
+			return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+		}
+
+		COMP6771_TARGET("avx512f")
+		double avx512_squared_norm(double const* x, std::size_t n) {
+			return avx512_dot(x, x, n);
+		}
+
+		COMP6771_TARGET("avx512f")
+		double avx512_squared_distance(double const* x, double const* y, std::size_t n) {
+			auto acc0 = _mm512_setzero_pd();
+			auto acc1 = _mm512_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				auto const d0 = _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i));
+				auto const d1 = _mm512_sub_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8));
+				acc0 = _mm512_fmadd_pd(d0, d0, acc0);
+				acc1 = _mm512_fmadd_pd(d1, d1, acc1);
+			}
+			for (; i + 8 <= n; i += 8) {
+				auto const d = _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i));
+				acc0 = _mm512_fmadd_pd(d, d, acc0);
+			}
+			if (i < n) {
+				auto const mask = static_cast<__mmask8>((1U << (n - i)) - 1U);
+				auto const d = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+				acc1 = _mm512_fmadd_pd(d, d, acc1);
+			}
+			alignas(64) double lanes[8];
+			_mm512_store_pd(lanes, _mm512_add_pd(acc0, acc1));
+			return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+		}
+
+		COMP6771_TARGET("avx512f")
+		double avx512_sum(__m512d const acc) {
+			alignas(64) double lanes[8];
+			_mm512_store_pd(lanes, acc);
+			return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+		}
+
+		COMP6771_TARGET("avx512f")
+		double avx512_manhattan_distance(double const* x, double const* y, std::size_t n) {
+			auto acc0 = _mm512_setzero_pd();
+			auto acc1 = _mm512_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				acc0 = _mm512_add_pd(acc0, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i))));
+				acc1 = _mm512_add_pd(acc1, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8))));
+			}
+			for (; i + 8 <= n; i += 8) {
+				acc0 = _mm512_add_pd(acc0, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i))));
+			}
+			if (i < n) {
+				//Masked-off lanes load as zero on both sides, so add nothing.
+				auto const mask = static_cast<__mmask8>((1U << (n - i)) - 1U);
+				auto const d = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+				acc1 = _mm512_add_pd(acc1, _mm512_abs_pd(d));
+			}
+			return avx512_sum(_mm512_add_pd(acc0, acc1));
+		}
+
+		COMP6771_TARGET("avx512f")
+		double avx512_chebyshev_distance(double const* x, double const* y, std::size_t n) {
+			auto acc = _mm512_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				acc = _mm512_max_pd(acc, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i))));
+			}
+			if (i < n) {
+				auto const mask = static_cast<__mmask8>((1U << (n - i)) - 1U);
+				auto const d = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+				acc = _mm512_max_pd(acc, _mm512_abs_pd(d));
+			}
+			alignas(64) double lanes[8];
+			_mm512_store_pd(lanes, acc);
+			auto r = 0.0;
+			for (auto const lane : lanes) {
+				r = std::max(r, lane);
+			}
+			return r;
+		}
+
+		COMP6771_TARGET("avx512f")
+		fused_dot avx512_dot_and_squared_norms(double const* x, double const* y, std::size_t n) {
+			auto xy = _mm512_setzero_pd();
+			auto xx = _mm512_setzero_pd();
+			auto yy = _mm512_setzero_pd();
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				auto const a = _mm512_loadu_pd(x + i);
+				auto const b = _mm512_loadu_pd(y + i);
+				xy = _mm512_fmadd_pd(a, b, xy);
+				xx = _mm512_fmadd_pd(a, a, xx);
+				yy = _mm512_fmadd_pd(b, b, yy);
+			}
+			if (i < n) {
+				auto const mask = static_cast<__mmask8>((1U << (n - i)) - 1U);
+				auto const a = _mm512_maskz_loadu_pd(mask, x + i);
+				auto const b = _mm512_maskz_loadu_pd(mask, y + i);
+				xy = _mm512_fmadd_pd(a, b, xy);
+				xx = _mm512_fmadd_pd(a, a, xx);
+				yy = _mm512_fmadd_pd(b, b, yy);
+			}
+			return fused_dot{avx512_sum(xy), avx512_sum(xx), avx512_sum(yy)};
+		}
+
+		//One accumulator per row, as a row of the tile fills a register.
+		COMP6771_TARGET("avx512f")
+		void avx512_dot_tile(double const* a, double const* b, std::size_t k, double* c) {
+			auto c0 = _mm512_setzero_pd();
+			auto c1 = _mm512_setzero_pd();
+			auto c2 = _mm512_setzero_pd();
+			auto c3 = _mm512_setzero_pd();
+			for (std::size_t s = 0; s < k; ++s) {
+				auto const y = _mm512_loadu_pd(b + s * tile_columns);
+				auto const* x = a + s * tile_rows;
+				c0 = _mm512_fmadd_pd(_mm512_set1_pd(x[0]), y, c0);
+				c1 = _mm512_fmadd_pd(_mm512_set1_pd(x[1]), y, c1);
+				c2 = _mm512_fmadd_pd(_mm512_set1_pd(x[2]), y, c2);
+				c3 = _mm512_fmadd_pd(_mm512_set1_pd(x[3]), y, c3);
+			}
+			_mm512_storeu_pd(c, _mm512_add_pd(_mm512_loadu_pd(c), c0));
+			_mm512_storeu_pd(c + 8, _mm512_add_pd(_mm512_loadu_pd(c + 8), c1));
+			_mm512_storeu_pd(c + 16, _mm512_add_pd(_mm512_loadu_pd(c + 16), c2));
+			_mm512_storeu_pd(c + 24, _mm512_add_pd(_mm512_loadu_pd(c + 24), c3));
+		}
+
+		COMP6771_TARGET("avx512f")
+		void avx512_add(double* x, double const* y, std::size_t n) {
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				_mm512_storeu_pd(x + i, _mm512_add_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+			}
+			if (i < n) {
+				auto const mask = static_cast<__mmask8>((1U << (n - i)) - 1U);
+				_mm512_mask_storeu_pd(x + i, mask,
+					_mm512_add_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i)));
+			}
+		}
+
+		COMP6771_TARGET("avx512f")
+		void avx512_subtract(double* x, double const* y, std::size_t n) {
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				_mm512_storeu_pd(x + i, _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+			}
+			if (i < n) {
+				auto const mask = static_cast<__mmask8>((1U << (n - i)) - 1U);
+				_mm512_mask_storeu_pd(x + i, mask,
+					_mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i)));
+			}
+		}
+
+		COMP6771_TARGET("avx512f")
+		void avx512_multiply(double* x, double b, std::size_t n) {
+			auto const s = _mm512_set1_pd(b);
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				_mm512_storeu_pd(x + i, _mm512_mul_pd(_mm512_loadu_pd(x + i), s));
+			}
+			if (i < n) {
+				auto const mask = static_cast<__mmask8>((1U << (n - i)) - 1U);
+				_mm512_mask_storeu_pd(x + i, mask, _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, x + i), s));
+			}
+		}
+
+		COMP6771_TARGET("avx512f")
+		void avx512_divide(double* x, double b, std::size_t n) {
+			auto const s = _mm512_set1_pd(b);
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				_mm512_storeu_pd(x + i, _mm512_div_pd(_mm512_loadu_pd(x + i), s));
+			}
+			if (i < n) {
+				//Masked-off lanes would compute 0/b; harmless, and never stored.
+				auto const mask = static_cast<__mmask8>((1U << (n - i)) - 1U);
+				_mm512_mask_storeu_pd(x + i, mask, _mm512_div_pd(_mm512_maskz_loadu_pd(mask, x + i), s));
+			}
+		}
+
+		constexpr auto sse2_table = kernel_table{isa::sse2, sse2_dot, sse2_squared_norm,
+			sse2_squared_distance, sse2_manhattan_distance, sse2_chebyshev_distance,
+			sse2_dot_and_squared_norms, sse2_dot_tile, sse2_add, sse2_subtract, sse2_multiply, sse2_divide};
+		constexpr auto avx2_table = kernel_table{isa::avx2, avx2_dot, avx2_squared_norm,
+			avx2_squared_distance, avx2_manhattan_distance, avx2_chebyshev_distance,
+			avx2_dot_and_squared_norms, avx2_dot_tile, avx2_add, avx2_subtract, avx2_multiply, avx2_divide};
+		constexpr auto avx512_table = kernel_table{isa::avx512, avx512_dot, avx512_squared_norm,
+			avx512_squared_distance, avx512_manhattan_distance, avx512_chebyshev_distance,
+			avx512_dot_and_squared_norms, avx512_dot_tile, avx512_add, avx512_subtract, avx512_multiply, avx512_divide};
+#endif
+
+		kernel_table const& select() noexcept {
+#if COMP6771_KERNELS_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx512f")) {
+				return avx512_table;
+			}
+			if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma")) {
+				return avx2_table;
+			}
+			if (__builtin_cpu_supports("sse2")) {
+				return sse2_table;
+			}
+#endif
+			return scalar_table;
+		}
+	} // namespace
+
+	bool supported(isa const level) noexcept {
+#if COMP6771_KERNELS_X86
+		__builtin_cpu_init();
+		switch (level) {
+		case isa::scalar:
+			return true;
+		case isa::sse2:
+			return __builtin_cpu_supports("sse2");
+		case isa::avx2:
+			return __builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma");
+		case isa::avx512:
+			return __builtin_cpu_supports("avx512f");
+		}
+		return false;
+#else
+		return level == isa::scalar;
+#endif
+	}
+
+	kernel_table const& table(isa const level) {
+		if (not supported(level)) {
+			throw std::invalid_argument("Kernel set " + std::string(name(level)) + " is not supported on this host");
+		}
+		switch (level) {
+#if COMP6771_KERNELS_X86
+		case isa::sse2:
+			return sse2_table;
+		case isa::avx2:
+			return avx2_table;
+		case isa::avx512:
+			return avx512_table;
+#endif
+		default:
+			return scalar_table;
+		}
+	}
+
+	kernel_table const& active() noexcept {
+		//Resolved once, on first use, so static initialisation order never matters.
+		static kernel_table const& chosen = select();
+		return chosen;
+	}
+
+	std::string_view name(isa const level) noexcept {
+		switch (level) {
+		case isa::scalar:
+			return "scalar";
+		case isa::sse2:
+			return "sse2";
+		case isa::avx2:
+			return "avx2";
+		case isa::avx512:
+			return "avx512";
+		}
+		return "unknown";
+	}
+} // namespace comp6771::kernels
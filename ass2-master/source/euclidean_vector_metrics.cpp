@@ -0,0 +1,162 @@
+#include "comp6771/euclidean_vector_metrics.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace comp6771::metrics {
+	namespace detail {
+		//Live threads' counters, and the totals of those that have exited, or reset theirs. The live
+		//list is intrusive so that a thread's first count allocates nothing. Never destroyed, so a
+		//thread that outlives static destruction can still retire its counters.
+		struct registry {
+			std::mutex mutex;
+			thread_counters* live = nullptr;
+			snapshot retired;
+		};
+	} // namespace detail
+
+	namespace {
+		struct description {
+			std::string_view name;
+			std::string_view help;
+		};
+
+		//In counter order.
+		constexpr auto descriptions = std::array<description, counter_count>{{
+			{"allocations", "Magnitude buffers allocated from a memory resource."},
+			{"allocated_bytes", "Bytes of magnitude buffers allocated from a memory resource."},
+			{"copies", "euclidean_vector copy constructions and assignments."},
+			{"moves", "euclidean_vector move constructions and assignments."},
+			{"copied_bytes", "Bytes of magnitudes copied out of a euclidean_vector."},
+			{"norm_cache_hits", "Norm reads answered by the cache."},
+			{"norm_cache_misses", "Norm reads that had to compute the norm."},
+			{"dot_cache_hits", "dot(v, v) calls answered by the cache."},
+			{"dot_cache_misses", "dot(v, v) calls that had to compute the product."},
+			{"cache_invalidations", "Writes that discarded a cached norm or dot product."},
+			{"errors", "euclidean_vector_error exceptions thrown."},
+		}};
+
+		//In static storage rather than on the heap, for the same reason.
+		detail::registry& the_registry() {
+			alignas(detail::registry) static std::byte storage[sizeof(detail::registry)];
+			static auto* const instance = ::new (storage) detail::registry();
+			return *instance;
+		}
+
+		double hit_rate(std::uint64_t const hits, std::uint64_t const misses) noexcept {
+			auto const reads = hits + misses;
+			return reads == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(reads);
+		}
+	} // namespace
+
+	std::string_view name(counter const c) noexcept {
+		return descriptions[static_cast<std::size_t>(c)].name;
+	}
+
+	double snapshot::norm_hit_rate() const noexcept {
+		return hit_rate((*this)[counter::norm_cache_hits], (*this)[counter::norm_cache_misses]);
+	}
+
+	double snapshot::dot_hit_rate() const noexcept {
+		return hit_rate((*this)[counter::dot_cache_hits], (*this)[counter::dot_cache_misses]);
+	}
+
+	//These don't check `enabled`: this file may be built without the definition that the counting code
+	//was built with, and without it nothing is counted, so they read zeros anyway.
+	snapshot this_thread() noexcept {
+		return detail::local().read();
+	}
+
+	void reset_this_thread() noexcept {
+		detail::local().reset();
+	}
+
+	snapshot all_threads() {
+		auto& shared = the_registry();
+		auto const lock = std::lock_guard(shared.mutex);
+		auto result = shared.retired;
+		for (auto const* counters = shared.live; counters != nullptr; counters = counters->next()) {
+			auto const values = counters->read();
+			for (std::size_t i = 0; i < counter_count; ++i) {
+				result.values[i] += values.values[i];
+			}
+		}
+		return result;
+	}
+
+	void write_prometheus(std::ostream& os, snapshot const& counters, std::string_view const prefix) {
+		for (std::size_t i = 0; i < counter_count; ++i) {
+			auto const& [name, help] = descriptions[i];
+			os << "# HELP " << prefix << '_' << name << "_total " << help << '\n'
+			   << "# TYPE " << prefix << '_' << name << "_total counter\n"
+			   << prefix << '_' << name << "_total " << counters.values[i] << '\n';
+		}
+	}
+
+	namespace detail {
+		thread_counters::thread_counters() noexcept {
+			auto& shared = the_registry();
+			try {
+				auto const lock = std::lock_guard(shared.mutex);
+				next_ = std::exchange(shared.live, this);
+				if (next_ != nullptr) {
+					next_->previous_ = this;
+				}
+			} catch (...) {
+				//Still counts for this_thread; all_threads just won't see it.
+			}
+		}
+
+		thread_counters::~thread_counters() {
+			auto& shared = the_registry();
+			auto const lock = std::lock_guard(shared.mutex);
+			if (shared.live != this and previous_ == nullptr) {
+				//Never registered.
+				return;
+			}
+			(previous_ != nullptr ? previous_->next_ : shared.live) = next_;
+			if (next_ != nullptr) {
+				next_->previous_ = previous_;
+			}
+			Retire(shared);
+		}
+
+		void thread_counters::Retire(registry& shared) const noexcept {
+			auto const values = read();
+			for (std::size_t i = 0; i < counter_count; ++i) {
+				shared.retired.values[i] += values.values[i];
+			}
+		}
+
+		snapshot thread_counters::read() const noexcept {
+			auto result = snapshot();
+			for (std::size_t i = 0; i < counter_count; ++i) {
+				result.values[i] = values_[i].load(std::memory_order_relaxed);
+			}
+			return result;
+		}
+
+		//Moves the counts to the retired totals first, so all_threads never goes backwards.
+		void thread_counters::reset() noexcept {
+			auto& shared = the_registry();
+			auto const clear = [this] {
+				for (auto& value : values_) {
+					value.store(0, std::memory_order_relaxed);
+				}
+			};
+			try {
+				auto const lock = std::lock_guard(shared.mutex);
+				Retire(shared);
+				clear();
+			} catch (...) {
+				//Couldn't lock: all_threads forgets the counts instead.
+				clear();
+			}
+		}
+	} // namespace detail
+} // namespace comp6771::metrics
@@ -0,0 +1,201 @@
+#include "comp6771/euclidean_vector_pairwise.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		using kernels::tile_columns;
+		using kernels::tile_rows;
+
+		//Dimensions per pass: a y panel is then 16KiB, and fits in L1 beside the tile's x panel.
+		constexpr std::size_t depth_block = 256;
+		//Results per thread job. A job's x panels, 128KiB at depth_block, stay in L2 while it walks
+		//its y panels.
+		constexpr std::size_t row_block = 16 * tile_rows;
+		constexpr std::size_t column_block = 32 * tile_columns;
+
+		enum class result_kind { dot, squared_distance, distance };
+
+		//Panels of Width vectors, each laid out dimension by dimension, with the last padded by zeros.
+		template<std::size_t Width, typename Value>
+		std::vector<double> pack(std::size_t const count, std::size_t const dimensions, Value const& value) {
+			auto result = std::vector<double>((count + Width - 1) / Width * Width * dimensions, 0.0);
+			for (std::size_t r = 0; r < count; ++r) {
+				auto* panel = result.data() + r / Width * Width * dimensions + r % Width;
+				for (std::size_t d = 0; d < dimensions; ++d) {
+					panel[d * Width] = value(r, d);
+				}
+			}
+			return result;
+		}
+
+		//One side of the product, ready for dot_tile.
+		struct operand {
+			std::size_t count;
+			std::vector<double> panels;
+			//Empty unless distances are wanted.
+			std::vector<double> squared_norms;
+		};
+
+		template<std::size_t Width>
+		operand pack_batch(euclidean_vector_batch const& v, result_kind const kind) {
+			auto const count = static_cast<std::size_t>(v.rows());
+			auto const dimensions = static_cast<std::size_t>(v.dimensions());
+			auto result = operand{count, pack<Width>(count, dimensions, [&v](std::size_t const r, std::size_t const d) {
+				return v[static_cast<int>(r)][static_cast<int>(d)];
+			}), {}};
+			if (kind != result_kind::dot) {
+				auto const& kernel = kernels::active();
+				result.squared_norms.reserve(count);
+				for (auto r = 0; r < v.rows(); ++r) {
+					auto const row = v[r];
+					auto squared_norm = 0.0;
+					if (row.contiguous()) {
+						squared_norm = kernel.squared_norm(row.data(), dimensions);
+					} else {
+						for (auto d = 0; d < row.dimensions(); ++d) {
+							squared_norm += row[d] * row[d];
+						}
+					}
+					result.squared_norms.push_back(squared_norm);
+				}
+			}
+			return result;
+		}
+
+		std::size_t dimensions_of(std::span<euclidean_vector const> const vectors) {
+			auto const dimensions = vectors.empty() ? std::size_t{0} : detail::vector_access::size(vectors.front());
+			for (auto const& v : vectors) {
+				detail::check_dimensions(dimensions, detail::vector_access::size(v));
+			}
+			return dimensions;
+		}
+
+		template<std::size_t Width>
+		operand pack_vectors(std::span<euclidean_vector const> const vectors, std::size_t const dimensions,
+		                     result_kind const kind) {
+			auto result = operand{vectors.size(), pack<Width>(vectors.size(), dimensions,
+				[vectors](std::size_t const r, std::size_t const d) {
+					return detail::vector_access::data(vectors[r])[d];
+				}), {}};
+			if (kind != result_kind::dot) {
+				result.squared_norms.reserve(vectors.size());
+				auto const& kernel = kernels::active();
+				for (auto const& v : vectors) {
+					auto const cached = detail::vector_access::cached_squared_norm(v);
+					result.squared_norms.push_back(
+					   cached ? *cached : kernel.squared_norm(detail::vector_access::data(v), detail::vector_access::size(v)));
+				}
+			}
+			return result;
+		}
+
+		euclidean_vector_batch compute(operand const& x, operand const& y, std::size_t const dimensions,
+		                               result_kind const kind, euclidean_vector_batch::allocator_type const& alloc) {
+			auto result = euclidean_vector_batch(static_cast<int>(x.count), static_cast<int>(y.count),
+			                                     batch_layout::row_major, alloc);
+			if (x.count == 0 or y.count == 0) {
+				return result;
+			}
+			auto const& kernel = kernels::active();
+			auto const leading = result.leading_dimension();
+			auto* out = result.data();
+			auto const column_blocks = (y.count + column_block - 1) / column_block;
+			auto const jobs = (x.count + row_block - 1) / row_block * column_blocks;
+
+			parallel::run(jobs, [&](std::size_t const job) {
+				auto const first_row = job / column_blocks * row_block;
+				auto const last_row = std::min(first_row + row_block, x.count);
+				auto const first_column = job % column_blocks * column_block;
+				auto const last_column = std::min(first_column + column_block, y.count);
+
+				for (std::size_t depth = 0; depth < dimensions; depth += depth_block) {
+					auto const steps = std::min(depth_block, dimensions - depth);
+					for (auto c = first_column; c < last_column; c += tile_columns) {
+						auto const* b = y.panels.data() + (c / tile_columns * dimensions + depth) * tile_columns;
+						auto const columns = std::min(tile_columns, last_column - c);
+						for (auto r = first_row; r < last_row; r += tile_rows) {
+							auto const* a = x.panels.data() + (r / tile_rows * dimensions + depth) * tile_rows;
+							double tile[tile_rows * tile_columns] = {};
+							kernel.dot_tile(a, b, steps, tile);
+							for (std::size_t i = 0; i < std::min(tile_rows, last_row - r); ++i) {
+								auto* row = out + (r + i) * leading + c;
+								for (std::size_t j = 0; j < columns; ++j) {
+									row[j] += tile[i * tile_columns + j];
+								}
+							}
+						}
+					}
+				}
+
+				if (kind == result_kind::dot) {
+					return;
+				}
+				for (auto r = first_row; r < last_row; ++r) {
+					auto* row = out + r * leading;
+					for (auto c = first_column; c < last_column; ++c) {
+						auto const squared = std::max(x.squared_norms[r] + y.squared_norms[c] - 2 * row[c], 0.0);
+						row[c] = kind == result_kind::distance ? std::sqrt(squared) : squared;
+					}
+				}
+			});
+			return result;
+		}
+
+		euclidean_vector_batch pairwise(euclidean_vector_batch const& x, euclidean_vector_batch const& y,
+		                                result_kind const kind, euclidean_vector_batch::allocator_type const& alloc) {
+			detail::check_dimensions(x.dimensions(), y.dimensions());
+			return compute(pack_batch<tile_rows>(x, kind), pack_batch<tile_columns>(y, kind),
+			               static_cast<std::size_t>(x.dimensions()), kind, alloc);
+		}
+
+		euclidean_vector_batch pairwise(std::span<euclidean_vector const> const x, std::span<euclidean_vector const> const y,
+		                                result_kind const kind, euclidean_vector_batch::allocator_type const& alloc) {
+			auto const x_dimensions = dimensions_of(x);
+			auto const y_dimensions = dimensions_of(y);
+			if (not x.empty() and not y.empty()) {
+				detail::check_dimensions(x_dimensions, y_dimensions);
+			}
+			auto const dimensions = std::max(x_dimensions, y_dimensions);
+			return compute(pack_vectors<tile_rows>(x, dimensions, kind), pack_vectors<tile_columns>(y, dimensions, kind),
+			               dimensions, kind, alloc);
+		}
+	} // namespace
+
+	euclidean_vector_batch pairwise_dot(euclidean_vector_batch const& x, euclidean_vector_batch const& y,
+	                                    euclidean_vector_batch::allocator_type const& alloc) {
+		return pairwise(x, y, result_kind::dot, alloc);
+	}
+
+	euclidean_vector_batch pairwise_dot(std::span<euclidean_vector const> const x, std::span<euclidean_vector const> const y,
+	                                    euclidean_vector_batch::allocator_type const& alloc) {
+		return pairwise(x, y, result_kind::dot, alloc);
+	}
+
+	euclidean_vector_batch pairwise_squared_distance(euclidean_vector_batch const& x, euclidean_vector_batch const& y,
+	                                                 euclidean_vector_batch::allocator_type const& alloc) {
+		return pairwise(x, y, result_kind::squared_distance, alloc);
+	}
+
+	euclidean_vector_batch pairwise_squared_distance(std::span<euclidean_vector const> const x,
+	                                                 std::span<euclidean_vector const> const y,
+	                                                 euclidean_vector_batch::allocator_type const& alloc) {
+		return pairwise(x, y, result_kind::squared_distance, alloc);
+	}
+
+	euclidean_vector_batch pairwise_distance(euclidean_vector_batch const& x, euclidean_vector_batch const& y,
+	                                         euclidean_vector_batch::allocator_type const& alloc) {
+		return pairwise(x, y, result_kind::distance, alloc);
+	}
+
+	euclidean_vector_batch pairwise_distance(std::span<euclidean_vector const> const x,
+	                                         std::span<euclidean_vector const> const y,
+	                                         euclidean_vector_batch::allocator_type const& alloc) {
+		return pairwise(x, y, result_kind::distance, alloc);
+	}
+} // namespace comp6771
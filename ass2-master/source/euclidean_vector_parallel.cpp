@@ -0,0 +1,277 @@
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace comp6771::parallel {
+	namespace {
+		//True on a pool's workers, and on a caller while its jobs run. A job that reaches run again,
+		//say through dot on a long vector, then runs the nested jobs itself rather than waiting on a
+		//pool that is busy with it.
+		thread_local bool inside_pool = false;
+
+		//Sets inside_pool for as long as it lives.
+		class pool_scope {
+		public:
+			pool_scope() noexcept : previous_{std::exchange(inside_pool, true)} {}
+			pool_scope(pool_scope const&) = delete;
+			pool_scope& operator=(pool_scope const&) = delete;
+			~pool_scope() { inside_pool = previous_; }
+
+		private:
+			bool previous_;
+		};
+
+		//Runs job(0) ... job(count - 1) on the workers and the calling thread, and returns once all
+		//of them have finished. One job at a time; concurrent callers queue up. If a job throws, no
+		//further jobs start, and the first exception is rethrown to the caller once the jobs already
+		//running have finished.
+		class thread_pool {
+		public:
+			explicit thread_pool(unsigned const threads) {
+				workers_.reserve(threads - 1);
+				for (auto i = 1U; i < threads; ++i) {
+					workers_.emplace_back([this] { Work(); });
+				}
+			}
+
+			thread_pool(thread_pool const&) = delete;
+			thread_pool& operator=(thread_pool const&) = delete;
+
+			~thread_pool() {
+				{
+					auto const lock = std::lock_guard(mutex_);
+					stop_ = true;
+				}
+				wake_.notify_all();
+				for (auto& worker : workers_) {
+					worker.join();
+				}
+			}
+
+			unsigned size() const noexcept { return static_cast<unsigned>(workers_.size()) + 1; }
+
+			void run(std::size_t const count, std::function<void(std::size_t)> const& job) {
+				if (inside_pool) {
+					for (std::size_t i = 0; i < count; ++i) {
+						job(i);
+					}
+					return;
+				}
+				auto const scope = pool_scope();
+				auto const caller = std::lock_guard(run_mutex_);
+				{
+					auto const lock = std::lock_guard(mutex_);
+					job_ = &job;
+					count_ = count;
+					next_.store(0, std::memory_order_relaxed);
+					busy_ = workers_.size();
+					error_ = nullptr;
+					++generation_;
+				}
+				wake_.notify_all();
+				Drain();
+				auto lock = std::unique_lock(mutex_);
+				done_.wait(lock, [this] { return busy_ == 0; });
+				job_ = nullptr;
+				if (error_ != nullptr) {
+					std::rethrow_exception(std::exchange(error_, nullptr));
+				}
+			}
+
+		private:
+			void Work() {
+				inside_pool = true;
+				auto seen = std::size_t{0};
+				for (;;) {
+					{
+						auto lock = std::unique_lock(mutex_);
+						wake_.wait(lock, [&] { return stop_ or generation_ != seen; });
+						if (stop_) {
+							return;
+						}
+						seen = generation_;
+					}
+					Drain();
+					{
+						auto const lock = std::lock_guard(mutex_);
+						--busy_;
+					}
+					done_.notify_one();
+				}
+			}
+
+			void Drain() noexcept {
+				for (auto i = next_.fetch_add(1, std::memory_order_relaxed); i < count_;
+				     i = next_.fetch_add(1, std::memory_order_relaxed)) {
+					try {
+						(*job_)(i);
+					} catch (...) {
+						//Hand out no more indices; run rethrows once everyone is back.
+						next_.store(count_, std::memory_order_relaxed);
+						auto const lock = std::lock_guard(mutex_);
+						if (error_ == nullptr) {
+							error_ = std::current_exception();
+						}
+						return;
+					}
+				}
+			}
+
+			std::vector<std::thread> workers_;
+			std::mutex run_mutex_;
+			std::mutex mutex_;
+			std::condition_variable wake_;
+			std::condition_variable done_;
+			std::function<void(std::size_t)> const* job_ = nullptr;
+			std::size_t count_ = 0;
+			std::atomic<std::size_t> next_ = 0;
+			std::size_t busy_ = 0;
+			std::size_t generation_ = 0;
+			//The first exception a job threw, guarded by mutex_.
+			std::exception_ptr error_;
+			bool stop_ = false;
+		};
+
+		std::mutex pool_mutex;
+		std::shared_ptr<thread_pool> pool;
+		std::atomic<std::size_t> min_dimensions = std::size_t{1} << 20;
+
+		std::shared_ptr<thread_pool> pool_for(std::size_t const n) {
+			if (n < min_dimensions.load(std::memory_order_relaxed)) {
+				return nullptr;
+			}
+			auto const lock = std::lock_guard(pool_mutex);
+			return pool;
+		}
+
+		std::size_t block_count(std::size_t const n) noexcept {
+			return (n + block_size - 1) / block_size;
+		}
+
+		std::size_t block_length(std::size_t const block, std::size_t const n) noexcept {
+			return std::min(block_size, n - block * block_size);
+		}
+
+		//Calls f(offset, length) for every block, on the pool when one applies.
+		template<typename F>
+		void for_each_block(std::size_t const n, F const& f) {
+			auto const blocks = block_count(n);
+			auto const job = [&](std::size_t const block) { f(block * block_size, block_length(block, n)); };
+			if (auto const p = pool_for(n); p != nullptr and blocks > 1) {
+				p->run(blocks, job);
+			} else {
+				for (std::size_t block = 0; block < blocks; ++block) {
+					job(block);
+				}
+			}
+		}
+
+		//Partial sums go into fixed slots and are added in block order afterwards, so the
+		//result doesn't depend on which thread finished first.
+		template<typename F>
+		double reduce(std::size_t const n, F const& partial) {
+			if (n <= block_size) {
+				return partial(0, n);
+			}
+			auto sums = std::vector<double>(block_count(n));
+			for_each_block(n, [&](std::size_t const offset, std::size_t const length) {
+				sums[offset / block_size] = partial(offset, length);
+			});
+			auto total = 0.0;
+			for (auto const s : sums) {
+				total += s;
+			}
+			return total;
+		}
+	} // namespace
+
+	void set_thread_count(unsigned count) {
+		if (count == 0) {
+			count = std::max(std::thread::hardware_concurrency(), 1U);
+		}
+		auto replacement = count > 1 ? std::make_shared<thread_pool>(count) : nullptr;
+		auto const lock = std::lock_guard(pool_mutex);
+		//An old pool still in use is kept alive by its callers and shuts down after them.
+		pool = std::move(replacement);
+	}
+
+	unsigned thread_count() noexcept {
+		auto const lock = std::lock_guard(pool_mutex);
+		return pool != nullptr ? pool->size() : 1;
+	}
+
+	void set_threshold(std::size_t const dimensions) noexcept {
+		min_dimensions.store(dimensions, std::memory_order_relaxed);
+	}
+
+	std::size_t threshold() noexcept {
+		return min_dimensions.load(std::memory_order_relaxed);
+	}
+
+	void run(std::size_t const count, std::function<void(std::size_t)> const& job) {
+		auto p = std::shared_ptr<thread_pool>();
+		if (count > 1) {
+			auto const lock = std::lock_guard(pool_mutex);
+			p = pool;
+		}
+		if (p != nullptr) {
+			p->run(count, job);
+		} else {
+			for (std::size_t i = 0; i < count; ++i) {
+				job(i);
+			}
+		}
+	}
+
+	double dot(double const* x, double const* y, std::size_t const n) {
+		auto const& k = kernels::active();
+		return reduce(n, [&](std::size_t const offset, std::size_t const length) {
+			return k.dot(x + offset, y + offset, length);
+		});
+	}
+
+	double squared_norm(double const* x, std::size_t const n) {
+		auto const& k = kernels::active();
+		return reduce(n, [&](std::size_t const offset, std::size_t const length) {
+			return k.squared_norm(x + offset, length);
+		});
+	}
+
+	void add(double* x, double const* y, std::size_t const n) {
+		auto const& k = kernels::active();
+		for_each_block(n, [&](std::size_t const offset, std::size_t const length) {
+			k.add(x + offset, y + offset, length);
+		});
+	}
+
+	void subtract(double* x, double const* y, std::size_t const n) {
+		auto const& k = kernels::active();
+		for_each_block(n, [&](std::size_t const offset, std::size_t const length) {
+			k.subtract(x + offset, y + offset, length);
+		});
+	}
+
+	void multiply(double* x, double const b, std::size_t const n) {
+		auto const& k = kernels::active();
+		for_each_block(n, [&](std::size_t const offset, std::size_t const length) {
+			k.multiply(x + offset, b, length);
+		});
+	}
+
+	void divide(double* x, double const b, std::size_t const n) {
+		auto const& k = kernels::active();
+		for_each_block(n, [&](std::size_t const offset, std::size_t const length) {
+			k.divide(x + offset, b, length);
+		});
+	}
+} // namespace comp6771::parallel
@@ -0,0 +1,118 @@
+#include "comp6771/euclidean_vector_view.hpp"
+#include "comp6771/euclidean_vector_format.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		void check_index(int const i, int const dimensions) {
+			if (i < 0 or i >= dimensions) {
+				throw euclidean_vector_error("Index " + std::to_string(i) +" is not valid for this euclidean_vector object");
+			}
+		}
+
+	} // namespace
+
+	double const_euclidean_vector_view::at(int const i) const {
+		check_index(i, dimensions());
+		return (*this)[i];
+	}
+
+	const_euclidean_vector_view::operator euclidean_vector() const {
+		return euclidean_vector(magnitudes_);
+	}
+
+	double& euclidean_vector_view::at(int const i) const {
+		check_index(i, dimensions());
+		return (*this)[i];
+	}
+
+	euclidean_vector_view::operator euclidean_vector() const {
+		return euclidean_vector(magnitudes_);
+	}
+
+	euclidean_vector_view const& euclidean_vector_view::operator+=(const_euclidean_vector_view const b) const {
+		detail::check_dimensions(dimensions(), b.dimensions());
+		parallel::add(data(), b.data(), magnitudes_.size());
+		return *this;
+	}
+
+	euclidean_vector_view const& euclidean_vector_view::operator-=(const_euclidean_vector_view const b) const {
+		detail::check_dimensions(dimensions(), b.dimensions());
+		parallel::subtract(data(), b.data(), magnitudes_.size());
+		return *this;
+	}
+
+	euclidean_vector_view const& euclidean_vector_view::operator*=(double const& b) const {
+		parallel::multiply(data(), b, magnitudes_.size());
+		return *this;
+	}
+
+	euclidean_vector_view const& euclidean_vector_view::operator/=(double const& b) const {
+		if (std::abs(b-0) < 0.0001) {
+			throw euclidean_vector_error("Invalid vector division by 0");
+		}
+		parallel::divide(data(), b, magnitudes_.size());
+		return *this;
+	}
+
+	double dot(const_euclidean_vector_view const x, const_euclidean_vector_view const y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		return x.data() == y.data() ? parallel::squared_norm(x.data(), x.magnitudes().size())
+		                            : parallel::dot(x.data(), y.data(), x.magnitudes().size());
+	}
+
+	double euclidean_norm(const_euclidean_vector_view const v) {
+		return std::sqrt(parallel::squared_norm(v.data(), v.magnitudes().size()));
+	}
+
+	double squared_distance(const_euclidean_vector_view const x, const_euclidean_vector_view const y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		return kernels::active().squared_distance(x.data(), y.data(), x.magnitudes().size());
+	}
+
+	double euclidean_distance(const_euclidean_vector_view const x, const_euclidean_vector_view const y) {
+		return std::sqrt(squared_distance(x, y));
+	}
+
+	double cosine_similarity(const_euclidean_vector_view const x, const_euclidean_vector_view const y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		auto const terms = kernels::active().dot_and_squared_norms(x.data(), y.data(), x.magnitudes().size());
+		auto const x_norm = std::sqrt(terms.xx);
+		auto const y_norm = std::sqrt(terms.yy);
+		detail::check_direction(x_norm);
+		detail::check_direction(y_norm);
+		return terms.xy / (x_norm * y_norm);
+	}
+
+	double manhattan_distance(const_euclidean_vector_view const x, const_euclidean_vector_view const y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		return kernels::active().manhattan_distance(x.data(), y.data(), x.magnitudes().size());
+	}
+
+	double chebyshev_distance(const_euclidean_vector_view const x, const_euclidean_vector_view const y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		return kernels::active().chebyshev_distance(x.data(), y.data(), x.magnitudes().size());
+	}
+
+	bool operator==(const_euclidean_vector_view const a, const_euclidean_vector_view const b) {
+		if (a.dimensions() != b.dimensions()) {
+			return false;
+		}
+		for (auto i = 0; i < a.dimensions(); ++i) {
+			if (not (std::abs(a[i]-b[i]) < 0.0001)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::ostream& operator<<(std::ostream& os, const_euclidean_vector_view const v) {
+		return write_text(os, v.magnitudes());
+	}
+} // namespace comp6771
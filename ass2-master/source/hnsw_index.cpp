@@ -0,0 +1,486 @@
+#include "comp6771/hnsw_index.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		static_assert(std::endian::native == std::endian::little, "index files are read and written in place");
+
+		struct hnsw_file_header {
+			static constexpr std::uint64_t expected_magic = 0x534e'4831'3737'3643; //"C6771HNS", read little-endian
+			static constexpr std::uint32_t current_version = 1;
+
+			std::uint64_t magic;
+			std::uint32_t version;
+			std::uint32_t metric;
+			std::uint64_t dimensions;
+			std::uint64_t count;
+			std::uint64_t m;
+			std::uint64_t ef_construction;
+			std::uint64_t ef_search;
+			std::uint64_t seed;
+			std::int64_t entry_point;
+			std::int64_t max_level;
+			//Length of the level generator's state, which follows the header as text.
+			std::uint64_t engine_state;
+		};
+
+		[[noreturn]] void throw_errno(std::string const& what, std::filesystem::path const& path) {
+			throw std::system_error(errno, std::generic_category(), what + " " + path.string());
+		}
+
+		template<typename T>
+		void write_values(std::ofstream& out, T const* values, std::size_t const count, std::filesystem::path const& path) {
+			out.write(reinterpret_cast<char const*>(values), static_cast<std::streamsize>(sizeof(T) * count));
+			if (not out) {
+				throw_errno("Could not write", path);
+			}
+		}
+
+		template<typename T>
+		void read_values(std::ifstream& in, T* values, std::size_t const count, std::filesystem::path const& path) {
+			in.read(reinterpret_cast<char*>(values), static_cast<std::streamsize>(sizeof(T) * count));
+			if (not in) {
+				throw euclidean_vector_error(path.string() + " is truncated or has a malformed header");
+			}
+		}
+
+		//Marks nodes seen by one layer search. Each search takes a new generation rather than
+		//clearing the marks, and each thread has its own, so concurrent searches never share.
+		class visited_list {
+		public:
+			void reset(std::size_t const size) {
+				if (marks_.size() < size) {
+					marks_.resize(size, 0);
+				}
+				if (++generation_ == 0) {
+					std::fill(marks_.begin(), marks_.end(), 0);
+					generation_ = 1;
+				}
+			}
+
+			//False if `index` was already visited.
+			bool visit(int const index) noexcept {
+				auto& mark = marks_[static_cast<std::size_t>(index)];
+				return std::exchange(mark, generation_) != generation_;
+			}
+
+		private:
+			std::vector<std::uint32_t> marks_;
+			std::uint32_t generation_ = 0;
+		};
+
+		thread_local visited_list visited;
+	} // namespace
+
+	hnsw_index::hnsw_index(int const dimensions, distance_metric const metric, hnsw_parameters const& parameters,
+	                       allocator_type const& alloc)
+	: dimensions_{dimensions}, metric_{metric}, parameters_{parameters}
+	, level_factor_{1.0 / std::log(static_cast<double>(std::max(parameters.m, 2)))}, engine_{parameters.seed}
+	, vectors_(alloc), levels_(alloc), base_links_(alloc), upper_links_(alloc) {
+		if (dimensions < 0 or parameters.m < 2 or parameters.ef_construction < 1 or parameters.ef_search < 1) {
+			throw euclidean_vector_error("hnsw_index needs m >= 2, positive ef values and non-negative dimensions");
+		}
+	}
+
+	hnsw_index::hnsw_index(hnsw_index&& other) noexcept
+	: dimensions_{other.dimensions_}, metric_{other.metric_}, parameters_{other.parameters_}
+	, level_factor_{other.level_factor_}, engine_{other.engine_}
+	, vectors_(std::move(other.vectors_)), levels_(std::move(other.levels_)), base_links_(std::move(other.base_links_))
+	, upper_links_(std::move(other.upper_links_)), entry_point_{std::exchange(other.entry_point_, -1)}
+	, max_level_{std::exchange(other.max_level_, -1)} {}
+
+	hnsw_index& hnsw_index::operator=(hnsw_index&& other) {
+		if (this != &other) {
+			auto const lock = std::scoped_lock(mutex_, other.mutex_);
+			dimensions_ = other.dimensions_;
+			metric_ = other.metric_;
+			parameters_ = other.parameters_;
+			level_factor_ = other.level_factor_;
+			engine_ = other.engine_;
+			vectors_ = std::move(other.vectors_);
+			levels_ = std::move(other.levels_);
+			base_links_ = std::move(other.base_links_);
+			upper_links_ = std::move(other.upper_links_);
+			entry_point_ = std::exchange(other.entry_point_, -1);
+			max_level_ = std::exchange(other.max_level_, -1);
+		}
+		return *this;
+	}
+
+	int hnsw_index::size() const {
+		auto const lock = std::shared_lock(mutex_);
+		return static_cast<int>(levels_.size());
+	}
+
+	void hnsw_index::set_ef_search(int const ef) {
+		if (ef < 1) {
+			throw euclidean_vector_error("hnsw_index needs m >= 2, positive ef values and non-negative dimensions");
+		}
+		auto const lock = std::unique_lock(mutex_);
+		parameters_.ef_search = ef;
+	}
+
+	const_euclidean_vector_view hnsw_index::operator[](int const i) const noexcept {
+		return const_euclidean_vector_view(std::span<double const>(Vector(i), static_cast<std::size_t>(dimensions_)));
+	}
+
+	double const* hnsw_index::Vector(int const index) const noexcept {
+		return vectors_.data() + static_cast<std::size_t>(index) * static_cast<std::size_t>(dimensions_);
+	}
+
+	//Smaller is closer for every metric; inner products are negated.
+	double hnsw_index::Distance(double const* query, int const index) const noexcept {
+		auto const& k = kernels::active();
+		auto const n = static_cast<std::size_t>(dimensions_);
+		return metric_ == distance_metric::l2 ? k.squared_distance(query, Vector(index), n)
+		                                      : -k.dot(query, Vector(index), n);
+	}
+
+	std::size_t hnsw_index::MaxLinks(int const layer) const noexcept {
+		return static_cast<std::size_t>(layer == 0 ? 2 * parameters_.m : parameters_.m);
+	}
+
+	int* hnsw_index::Links(int const index, int const layer) noexcept {
+		return const_cast<int*>(std::as_const(*this).Links(index, layer));
+	}
+
+	int const* hnsw_index::Links(int const index, int const layer) const noexcept {
+		auto const i = static_cast<std::size_t>(index);
+		if (layer == 0) {
+			return base_links_.data() + i * (1 + MaxLinks(0));
+		}
+		return upper_links_[i].data() + static_cast<std::size_t>(layer - 1) * (1 + MaxLinks(1));
+	}
+
+	int hnsw_index::RandomLevel() {
+		auto const u = std::uniform_real_distribution<double>(0.0, 1.0)(engine_);
+		return static_cast<int>(-std::log(1.0 - u) * level_factor_);
+	}
+
+	int hnsw_index::GreedyClosest(double const* query, int entry, int const layer) const {
+		auto best = Distance(query, entry);
+		for (auto moved = true; moved;) {
+			moved = false;
+			auto const* links = Links(entry, layer);
+			for (auto i = 1; i <= links[0]; ++i) {
+				auto const d = Distance(query, links[i]);
+				if (d < best) {
+					best = d;
+					entry = links[i];
+					moved = true;
+				}
+			}
+		}
+		return entry;
+	}
+
+	std::vector<hnsw_index::candidate> hnsw_index::SearchLayer(double const* query, std::vector<candidate> entries,
+	                                                           std::size_t const ef, int const layer) const {
+		auto const closer = [](candidate const& a, candidate const& b) {
+			return a.distance < b.distance or (a.distance == b.distance and a.index < b.index);
+		};
+		auto const farther = [&](candidate const& a, candidate const& b) { return closer(b, a); };
+		//Unexpanded candidates, closest on top, and the ef best found so far, farthest on top.
+		auto frontier = std::priority_queue<candidate, std::vector<candidate>, decltype(farther)>(farther);
+		auto found = std::priority_queue<candidate, std::vector<candidate>, decltype(closer)>(closer);
+
+		visited.reset(levels_.size());
+		for (auto const& e : entries) {
+			if (visited.visit(e.index)) {
+				frontier.push(e);
+				found.push(e);
+			}
+		}
+		while (found.size() > ef) {
+			found.pop();
+		}
+
+		while (not frontier.empty()) {
+			auto const current = frontier.top();
+			if (found.size() >= ef and closer(found.top(), current)) {
+				break;
+			}
+			frontier.pop();
+			auto const* links = Links(current.index, layer);
+			for (auto i = 1; i <= links[0]; ++i) {
+				if (not visited.visit(links[i])) {
+					continue;
+				}
+				auto const next = candidate{Distance(query, links[i]), links[i]};
+				if (found.size() < ef or closer(next, found.top())) {
+					frontier.push(next);
+					found.push(next);
+					if (found.size() > ef) {
+						found.pop();
+					}
+				}
+			}
+		}
+
+		auto result = std::vector<candidate>(found.size());
+		for (auto i = result.size(); i > 0; --i) {
+			result[i - 1] = found.top();
+			found.pop();
+		}
+		return result;
+	}
+
+	//The paper's heuristic: a candidate is kept only if it is closer to the query than to every
+	//neighbour already kept, which spreads links out in direction rather than clumping them.
+	std::vector<hnsw_index::candidate> hnsw_index::SelectNeighbours(std::vector<candidate> candidates,
+	                                                                std::size_t const count) const {
+		std::sort(candidates.begin(), candidates.end(), [](candidate const& a, candidate const& b) {
+			return a.distance < b.distance or (a.distance == b.distance and a.index < b.index);
+		});
+		auto kept = std::vector<candidate>();
+		kept.reserve(count);
+		for (auto const& c : candidates) {
+			if (kept.size() == count) {
+				break;
+			}
+			auto const diverse = std::none_of(kept.begin(), kept.end(), [&](candidate const& k) {
+				return Distance(Vector(c.index), k.index) < c.distance;
+			});
+			if (diverse) {
+				kept.push_back(c);
+			}
+		}
+		return kept;
+	}
+
+	void hnsw_index::Connect(int const index, int const layer, std::vector<candidate> const& neighbours) {
+		auto* links = Links(index, layer);
+		links[0] = static_cast<int>(neighbours.size());
+		for (std::size_t i = 0; i < neighbours.size(); ++i) {
+			links[i + 1] = neighbours[i].index;
+		}
+
+		auto const max_links = MaxLinks(layer);
+		for (auto const& n : neighbours) {
+			auto* back = Links(n.index, layer);
+			if (static_cast<std::size_t>(back[0]) < max_links) {
+				back[++back[0]] = index;
+				continue;
+			}
+			//Full: re-select among the old links and the new one.
+			auto const* from = Vector(n.index);
+			auto pool = std::vector<candidate>{{Distance(from, index), index}};
+			for (auto i = 1; i <= back[0]; ++i) {
+				pool.push_back({Distance(from, back[i]), back[i]});
+			}
+			auto const kept = SelectNeighbours(std::move(pool), max_links);
+			back[0] = static_cast<int>(kept.size());
+			for (std::size_t i = 0; i < kept.size(); ++i) {
+				back[i + 1] = kept[i].index;
+			}
+		}
+	}
+
+	int hnsw_index::insert(const_euclidean_vector_view const v) {
+		detail::check_dimensions(dimensions_, v.dimensions());
+		auto const lock = std::unique_lock(mutex_);
+		auto const index = static_cast<int>(levels_.size());
+		auto const offset = vectors_.size();
+		//Checked before anything changes, so a rejected insert leaves the index as it was.
+		auto norm = 1.0;
+		if (metric_ == distance_metric::cosine) {
+			norm = std::sqrt(kernels::active().squared_norm(v.data(), static_cast<std::size_t>(dimensions_)));
+			detail::check_direction(norm);
+		}
+		vectors_.insert(vectors_.end(), v.data(), v.data() + dimensions_);
+		if (metric_ == distance_metric::cosine) {
+			kernels::active().divide(vectors_.data() + offset, norm, static_cast<std::size_t>(dimensions_));
+		}
+		//Drawn only once the vector is accepted, so a rejected insert leaves the graph's growth as it was.
+		auto const level = RandomLevel();
+		levels_.push_back(level);
+		base_links_.resize(base_links_.size() + 1 + MaxLinks(0), 0);
+		upper_links_.emplace_back(static_cast<std::size_t>(level) * (1 + MaxLinks(1)), 0);
+
+		if (entry_point_ < 0) {
+			entry_point_ = index;
+			max_level_ = level;
+			return index;
+		}
+
+		auto const* query = Vector(index);
+		auto entry = entry_point_;
+		for (auto layer = max_level_; layer > level; --layer) {
+			entry = GreedyClosest(query, entry, layer);
+		}
+		auto entries = std::vector<candidate>{{Distance(query, entry), entry}};
+		for (auto layer = std::min(level, max_level_); layer >= 0; --layer) {
+			auto found = SearchLayer(query, std::move(entries), static_cast<std::size_t>(parameters_.ef_construction), layer);
+			Connect(index, layer, SelectNeighbours(found, static_cast<std::size_t>(parameters_.m)));
+			entries = std::move(found);
+		}
+		if (level > max_level_) {
+			entry_point_ = index;
+			max_level_ = level;
+		}
+		return index;
+	}
+
+	void hnsw_index::insert(std::span<euclidean_vector const> const vectors) {
+		for (auto const& v : vectors) {
+			insert(v);
+		}
+	}
+
+	std::vector<neighbour> hnsw_index::search(const_euclidean_vector_view const query, int const k) const {
+		detail::check_dimensions(dimensions_, query.dimensions());
+		auto const* q = query.data();
+		auto normalised = std::vector<double>();
+		if (metric_ == distance_metric::cosine) {
+			auto const norm = std::sqrt(kernels::active().squared_norm(q, static_cast<std::size_t>(dimensions_)));
+			detail::check_direction(norm);
+			normalised.assign(q, q + dimensions_);
+			kernels::active().divide(normalised.data(), norm, normalised.size());
+			q = normalised.data();
+		}
+
+		auto const lock = std::shared_lock(mutex_);
+		if (entry_point_ < 0 or k <= 0) {
+			return {};
+		}
+		auto entry = entry_point_;
+		for (auto layer = max_level_; layer > 0; --layer) {
+			entry = GreedyClosest(q, entry, layer);
+		}
+		auto const ef = static_cast<std::size_t>(std::max(parameters_.ef_search, k));
+		auto const found = SearchLayer(q, {{Distance(q, entry), entry}}, ef, 0);
+
+		auto result = std::vector<neighbour>();
+		result.reserve(std::min(found.size(), static_cast<std::size_t>(k)));
+		for (std::size_t i = 0; i < found.size() and i < static_cast<std::size_t>(k); ++i) {
+			auto const score = metric_ == distance_metric::l2 ? found[i].distance : -found[i].distance;
+			result.push_back({found[i].index, score});
+		}
+		return result;
+	}
+
+	void hnsw_index::save(std::filesystem::path const& path) const {
+		auto const lock = std::shared_lock(mutex_);
+		auto engine_state = std::ostringstream();
+		engine_state << engine_;
+		auto const state = engine_state.str();
+
+		auto header = hnsw_file_header{};
+		header.magic = hnsw_file_header::expected_magic;
+		header.version = hnsw_file_header::current_version;
+		header.metric = static_cast<std::uint32_t>(metric_);
+		header.dimensions = static_cast<std::uint64_t>(dimensions_);
+		header.count = levels_.size();
+		header.m = static_cast<std::uint64_t>(parameters_.m);
+		header.ef_construction = static_cast<std::uint64_t>(parameters_.ef_construction);
+		header.ef_search = static_cast<std::uint64_t>(parameters_.ef_search);
+		header.seed = parameters_.seed;
+		header.entry_point = entry_point_;
+		header.max_level = max_level_;
+		header.engine_state = state.size();
+
+		auto out = std::ofstream(path, std::ios::binary | std::ios::trunc);
+		if (not out) {
+			throw_errno("Could not create", path);
+		}
+		write_values(out, &header, 1, path);
+		write_values(out, state.data(), state.size(), path);
+		write_values(out, vectors_.data(), vectors_.size(), path);
+		write_values(out, levels_.data(), levels_.size(), path);
+		write_values(out, base_links_.data(), base_links_.size(), path);
+		for (auto const& links : upper_links_) {
+			write_values(out, links.data(), links.size(), path);
+		}
+		out.close();
+		if (not out) {
+			throw_errno("Could not write", path);
+		}
+	}
+
+	hnsw_index hnsw_index::load(std::filesystem::path const& path, allocator_type const& alloc) {
+		auto in = std::ifstream(path, std::ios::binary);
+		if (not in) {
+			throw_errno("Could not open", path);
+		}
+		auto header = hnsw_file_header{};
+		read_values(in, &header, 1, path);
+		if (header.magic != hnsw_file_header::expected_magic) {
+			throw euclidean_vector_error(path.string() + " is not an hnsw_index file");
+		}
+		if (header.version != hnsw_file_header::current_version or header.metric > 2) {
+			throw euclidean_vector_error(path.string() + " has an unsupported version or metric");
+		}
+		auto const malformed = [&] { return euclidean_vector_error(path.string() + " is truncated or has a malformed header"); };
+		constexpr auto limit = std::uint64_t{std::numeric_limits<int>::max()};
+		if (header.dimensions > limit or header.count > limit or header.m > limit / 2 or header.ef_construction > limit
+		    or header.ef_search > limit or header.engine_state > 1 << 16
+		    or header.entry_point < -1 or header.entry_point >= static_cast<std::int64_t>(header.count)) {
+			throw malformed();
+		}
+
+		auto parameters = hnsw_parameters{static_cast<int>(header.m), static_cast<int>(header.ef_construction),
+		                                   static_cast<int>(header.ef_search), header.seed};
+		auto index = hnsw_index(static_cast<int>(header.dimensions), static_cast<distance_metric>(header.metric),
+		                        parameters, alloc);
+		auto state = std::string(header.engine_state, '\0');
+		read_values(in, state.data(), state.size(), path);
+		auto engine_state = std::istringstream(state);
+		if (not (engine_state >> index.engine_)) {
+			throw malformed();
+		}
+
+		auto const count = static_cast<std::size_t>(header.count);
+		index.vectors_.resize(count * static_cast<std::size_t>(header.dimensions));
+		read_values(in, index.vectors_.data(), index.vectors_.size(), path);
+		index.levels_.resize(count);
+		read_values(in, index.levels_.data(), count, path);
+		index.base_links_.resize(count * (1 + index.MaxLinks(0)));
+		read_values(in, index.base_links_.data(), index.base_links_.size(), path);
+		auto highest = -1;
+		for (auto const level : index.levels_) {
+			if (level < 0 or level > 64) {
+				throw malformed();
+			}
+			highest = std::max(highest, level);
+			auto& links = index.upper_links_.emplace_back(static_cast<std::size_t>(level) * (1 + index.MaxLinks(1)), 0);
+			read_values(in, links.data(), links.size(), path);
+		}
+		if (highest != header.max_level or (count > 0) != (header.entry_point >= 0)
+		    or (count > 0 and index.levels_[static_cast<std::size_t>(header.entry_point)] != highest)) {
+			throw malformed();
+		}
+		index.entry_point_ = static_cast<int>(header.entry_point);
+		index.max_level_ = static_cast<int>(header.max_level);
+
+		//Every link must name a node that exists, so a corrupt file can't send a search out of bounds.
+		for (auto i = 0; i < static_cast<int>(count); ++i) {
+			for (auto layer = 0; layer <= index.levels_[static_cast<std::size_t>(i)]; ++layer) {
+				auto const* links = index.Links(i, layer);
+				if (links[0] < 0 or static_cast<std::size_t>(links[0]) > index.MaxLinks(layer)) {
+					throw malformed();
+				}
+				for (auto l = 1; l <= links[0]; ++l) {
+					if (links[l] < 0 or links[l] >= static_cast<int>(count)) {
+						throw malformed();
+					}
+				}
+			}
+		}
+		return index;
+	}
+} // namespace comp6771
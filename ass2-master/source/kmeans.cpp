@@ -0,0 +1,435 @@
+#include "comp6771/kmeans.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		//Points per assignment job. Fixed, rather than derived from the thread count, so every run
+		//splits and merges the same way.
+		constexpr std::size_t points_per_job = 4096;
+
+		constexpr auto infinity = std::numeric_limits<double>::infinity();
+
+		//job(first, last) for each points_per_job slice of [0, count), spread over the pool.
+		void for_chunks(std::size_t const count, std::function<void(std::size_t, std::size_t)> const& job) {
+			auto const chunks = (count + points_per_job - 1) / points_per_job;
+			parallel::run(chunks, [&](std::size_t const chunk) {
+				job(chunk * points_per_job, std::min((chunk + 1) * points_per_job, count));
+			});
+		}
+
+		//One clustering run. Centroids live in one row-major buffer while it iterates.
+		class engine {
+		public:
+			engine(euclidean_vector_batch points, int const k, kmeans_parameters const& parameters)
+			: points_{detail::row_major(std::move(points))}, count_{static_cast<std::size_t>(points_.rows())}
+			, dimensions_{static_cast<std::size_t>(points_.dimensions())}, k_{static_cast<std::size_t>(k)}
+			, parameters_{parameters}, engine_{parameters.seed}, centroids_(k_ * dimensions_)
+			, assignments_(count_, 0), shifts_(k_, 0.0) {}
+
+			kmeans_result Run() {
+				if (parameters_.init == kmeans_init::kmeans_plus_plus) {
+					InitPlusPlus();
+				} else {
+					InitRandom();
+				}
+				if (parameters_.algorithm == kmeans_algorithm::mini_batch) {
+					return RunMiniBatch();
+				}
+
+				auto iterations = 0;
+				auto converged = false;
+				while (iterations < parameters_.max_iterations and not converged) {
+					switch (parameters_.algorithm) {
+					case kmeans_algorithm::lloyd:
+						AssignLloyd();
+						break;
+					case kmeans_algorithm::hamerly:
+						AssignHamerly(iterations == 0);
+						break;
+					case kmeans_algorithm::elkan:
+						AssignElkan(iterations == 0);
+						break;
+					case kmeans_algorithm::mini_batch:
+						break;
+					}
+					converged = UpdateCentroids() <= parameters_.tolerance;
+					if (parameters_.algorithm == kmeans_algorithm::hamerly) {
+						MoveHamerlyBounds();
+					} else if (parameters_.algorithm == kmeans_algorithm::elkan) {
+						MoveElkanBounds();
+					}
+					++iterations;
+				}
+				return Finish(iterations, converged);
+			}
+
+		private:
+			double const* Point(std::size_t const i) const noexcept {
+				return points_.data() + i * points_.leading_dimension();
+			}
+
+			double* Centroid(std::size_t const c) noexcept { return centroids_.data() + c * dimensions_; }
+			double const* Centroid(std::size_t const c) const noexcept { return centroids_.data() + c * dimensions_; }
+
+			double SquaredDistance(double const* x, double const* y) const noexcept {
+				return kernels::active().squared_distance(x, y, dimensions_);
+			}
+
+			double Distance(std::size_t const point, std::size_t const c) const noexcept {
+				return std::sqrt(SquaredDistance(Point(point), Centroid(c)));
+			}
+
+			//The closest centroid to `x` and the squared distance to it, ties to the lower index.
+			std::pair<std::size_t, double> Nearest(double const* x) const noexcept {
+				auto best = std::size_t{0};
+				auto best_distance = infinity;
+				for (std::size_t c = 0; c < k_; ++c) {
+					auto const d = SquaredDistance(x, Centroid(c));
+					if (d < best_distance) {
+						best = c;
+						best_distance = d;
+					}
+				}
+				return {best, best_distance};
+			}
+
+			void SetCentroid(std::size_t const c, std::size_t const point) {
+				std::copy(Point(point), Point(point) + dimensions_, Centroid(c));
+			}
+
+			void InitRandom() {
+				auto order = std::vector<std::size_t>(count_);
+				std::iota(order.begin(), order.end(), std::size_t{0});
+				for (std::size_t c = 0; c < k_; ++c) {
+					auto pick = std::uniform_int_distribution<std::size_t>(c, count_ - 1);
+					std::swap(order[c], order[pick(engine_)]);
+					SetCentroid(c, order[c]);
+				}
+			}
+
+			void InitPlusPlus() {
+				auto first = std::uniform_int_distribution<std::size_t>(0, count_ - 1);
+				SetCentroid(0, first(engine_));
+				auto nearest = std::vector<double>(count_, infinity);
+				for (std::size_t c = 1; c <= k_; ++c) {
+					for_chunks(count_, [&](std::size_t const begin, std::size_t const end) {
+						for (auto i = begin; i < end; ++i) {
+							nearest[i] = std::min(nearest[i], SquaredDistance(Point(i), Centroid(c - 1)));
+						}
+					});
+					if (c == k_) {
+						break;
+					}
+					auto const total = std::accumulate(nearest.begin(), nearest.end(), 0.0);
+					if (total <= 0) {
+						//Every point already sits on a centroid; any choice is as good as another.
+						SetCentroid(c, first(engine_));
+						continue;
+					}
+					auto target = std::uniform_real_distribution<double>(0.0, total)(engine_);
+					//Rounding can leave target just short of running out; fall back to the last candidate.
+					auto chosen = count_ - 1;
+					while (nearest[chosen] <= 0) {
+						--chosen;
+					}
+					for (std::size_t i = 0; i < count_; ++i) {
+						target -= nearest[i];
+						if (target < 0 and nearest[i] > 0) {
+							chosen = i;
+							break;
+						}
+					}
+					SetCentroid(c, chosen);
+				}
+			}
+
+			void AssignLloyd() {
+				for_chunks(count_, [&](std::size_t const begin, std::size_t const end) {
+					for (auto i = begin; i < end; ++i) {
+						assignments_[i] = static_cast<int>(Nearest(Point(i)).first);
+					}
+				});
+			}
+
+			//Half the distance from each centroid to its nearest neighbour: a point closer than that to
+			//its own centroid can't be closer to any other. Elkan also keeps the whole table.
+			void MeasureCentroids(bool const keep_table) {
+				separation_.assign(k_, infinity);
+				if (keep_table) {
+					between_.assign(k_ * k_, 0.0);
+				}
+				for (std::size_t a = 0; a < k_; ++a) {
+					for (auto b = a + 1; b < k_; ++b) {
+						auto const d = std::sqrt(SquaredDistance(Centroid(a), Centroid(b)));
+						separation_[a] = std::min(separation_[a], d / 2);
+						separation_[b] = std::min(separation_[b], d / 2);
+						if (keep_table) {
+							between_[a * k_ + b] = d;
+							between_[b * k_ + a] = d;
+						}
+					}
+				}
+			}
+
+			void AssignHamerly(bool const first) {
+				if (first) {
+					upper_.assign(count_, 0.0);
+					lower_.assign(count_, 0.0);
+				}
+				MeasureCentroids(false);
+				for_chunks(count_, [&](std::size_t const begin, std::size_t const end) {
+					for (auto i = begin; i < end; ++i) {
+						auto const a = static_cast<std::size_t>(assignments_[i]);
+						if (not first) {
+							auto const bound = std::max(separation_[a], lower_[i]);
+							if (upper_[i] <= bound) {
+								continue;
+							}
+							upper_[i] = Distance(i, a);
+							if (upper_[i] <= bound) {
+								continue;
+							}
+						}
+						auto best = infinity;
+						auto second = infinity;
+						auto best_index = std::size_t{0};
+						for (std::size_t c = 0; c < k_; ++c) {
+							auto const d = Distance(i, c);
+							if (d < best) {
+								second = best;
+								best = d;
+								best_index = c;
+							} else if (d < second) {
+								second = d;
+							}
+						}
+						assignments_[i] = static_cast<int>(best_index);
+						upper_[i] = best;
+						lower_[i] = second;
+					}
+				});
+			}
+
+			void MoveHamerlyBounds() {
+				auto const furthest = *std::max_element(shifts_.begin(), shifts_.end());
+				for (std::size_t i = 0; i < count_; ++i) {
+					upper_[i] += shifts_[static_cast<std::size_t>(assignments_[i])];
+					lower_[i] -= furthest;
+				}
+			}
+
+			void AssignElkan(bool const first) {
+				MeasureCentroids(true);
+				if (first) {
+					upper_.assign(count_, 0.0);
+					lower_.assign(count_ * k_, 0.0);
+					stale_.assign(count_, 0);
+					for_chunks(count_, [&](std::size_t const begin, std::size_t const end) {
+						for (auto i = begin; i < end; ++i) {
+							auto* bounds = lower_.data() + i * k_;
+							auto best = std::size_t{0};
+							for (std::size_t c = 0; c < k_; ++c) {
+								bounds[c] = Distance(i, c);
+								if (bounds[c] < bounds[best]) {
+									best = c;
+								}
+							}
+							assignments_[i] = static_cast<int>(best);
+							upper_[i] = bounds[best];
+						}
+					});
+					return;
+				}
+				for_chunks(count_, [&](std::size_t const begin, std::size_t const end) {
+					for (auto i = begin; i < end; ++i) {
+						auto a = static_cast<std::size_t>(assignments_[i]);
+						if (upper_[i] <= separation_[a]) {
+							continue;
+						}
+						auto* bounds = lower_.data() + i * k_;
+						for (std::size_t c = 0; c < k_; ++c) {
+							if (c == a or upper_[i] <= bounds[c] or upper_[i] <= between_[a * k_ + c] / 2) {
+								continue;
+							}
+							if (stale_[i] != 0) {
+								upper_[i] = Distance(i, a);
+								bounds[a] = upper_[i];
+								stale_[i] = 0;
+								if (upper_[i] <= bounds[c] or upper_[i] <= between_[a * k_ + c] / 2) {
+									continue;
+								}
+							}
+							bounds[c] = Distance(i, c);
+							if (bounds[c] < upper_[i]) {
+								a = c;
+								upper_[i] = bounds[c];
+							}
+						}
+						assignments_[i] = static_cast<int>(a);
+					}
+				});
+			}
+
+			void MoveElkanBounds() {
+				for_chunks(count_, [&](std::size_t const begin, std::size_t const end) {
+					for (auto i = begin; i < end; ++i) {
+						auto* bounds = lower_.data() + i * k_;
+						for (std::size_t c = 0; c < k_; ++c) {
+							bounds[c] = std::max(bounds[c] - shifts_[c], 0.0);
+						}
+						upper_[i] += shifts_[static_cast<std::size_t>(assignments_[i])];
+						stale_[i] = 1;
+					}
+				});
+			}
+
+			//Moves each centroid to the mean of its points, summed in point order, and returns the
+			//furthest any moved.
+			double UpdateCentroids() {
+				auto first = std::vector<std::size_t>(k_ + 1, 0);
+				for (auto const a : assignments_) {
+					++first[static_cast<std::size_t>(a) + 1];
+				}
+				std::partial_sum(first.begin(), first.end(), first.begin());
+				auto members = std::vector<std::size_t>(count_);
+				auto next = std::vector<std::size_t>(first.begin(), first.end() - 1);
+				for (std::size_t i = 0; i < count_; ++i) {
+					members[next[static_cast<std::size_t>(assignments_[i])]++] = i;
+				}
+
+				parallel::run(k_, [&](std::size_t const c) {
+					shifts_[c] = 0.0;
+					if (first[c] == first[c + 1]) {
+						return;
+					}
+					auto mean = std::vector<double>(dimensions_, 0.0);
+					for (auto m = first[c]; m < first[c + 1]; ++m) {
+						auto const* p = Point(members[m]);
+						for (std::size_t d = 0; d < dimensions_; ++d) {
+							mean[d] += p[d];
+						}
+					}
+					auto const size = static_cast<double>(first[c + 1] - first[c]);
+					for (auto& x : mean) {
+						x /= size;
+					}
+					shifts_[c] = std::sqrt(SquaredDistance(mean.data(), Centroid(c)));
+					std::copy(mean.begin(), mean.end(), Centroid(c));
+				});
+				return *std::max_element(shifts_.begin(), shifts_.end());
+			}
+
+			kmeans_result RunMiniBatch() {
+				auto const batch = static_cast<std::size_t>(std::max(parameters_.batch_size, 1));
+				auto pick = std::uniform_int_distribution<std::size_t>(0, count_ - 1);
+				auto samples = std::vector<std::size_t>(batch);
+				auto nearest = std::vector<std::size_t>(batch);
+				auto seen = std::vector<double>(k_, 0.0);
+				auto previous = std::vector<double>();
+
+				auto iterations = 0;
+				auto converged = false;
+				while (iterations < parameters_.max_iterations and not converged) {
+					for (auto& s : samples) {
+						s = pick(engine_);
+					}
+					for_chunks(batch, [&](std::size_t const begin, std::size_t const end) {
+						for (auto j = begin; j < end; ++j) {
+							nearest[j] = Nearest(Point(samples[j])).first;
+						}
+					});
+					previous = centroids_;
+					for (std::size_t j = 0; j < batch; ++j) {
+						auto const c = nearest[j];
+						auto const rate = 1.0 / ++seen[c];
+						auto* centroid = Centroid(c);
+						auto const* p = Point(samples[j]);
+						for (std::size_t d = 0; d < dimensions_; ++d) {
+							centroid[d] += rate * (p[d] - centroid[d]);
+						}
+					}
+					auto furthest = 0.0;
+					for (std::size_t c = 0; c < k_; ++c) {
+						furthest = std::max(furthest, SquaredDistance(Centroid(c), previous.data() + c * dimensions_));
+					}
+					converged = std::sqrt(furthest) <= parameters_.tolerance;
+					++iterations;
+				}
+				return Finish(iterations, converged);
+			}
+
+			//Assigns every point to the final centroids, whatever the algorithm left behind.
+			kmeans_result Finish(int const iterations, bool const converged) {
+				auto const chunks = (count_ + points_per_job - 1) / points_per_job;
+				auto inertia = std::vector<double>(chunks, 0.0);
+				for_chunks(count_, [&](std::size_t const begin, std::size_t const end) {
+					for (auto i = begin; i < end; ++i) {
+						auto const [c, d] = Nearest(Point(i));
+						assignments_[i] = static_cast<int>(c);
+						inertia[begin / points_per_job] += d;
+					}
+				});
+
+				auto result = kmeans_result{{}, std::move(assignments_), std::accumulate(inertia.begin(), inertia.end(), 0.0),
+				                            iterations, converged};
+				result.centroids.reserve(k_);
+				for (std::size_t c = 0; c < k_; ++c) {
+					result.centroids.emplace_back(std::span<double const>(Centroid(c), dimensions_));
+				}
+				return result;
+			}
+
+			euclidean_vector_batch points_;
+			std::size_t count_;
+			std::size_t dimensions_;
+			std::size_t k_;
+			kmeans_parameters parameters_;
+			std::mt19937_64 engine_;
+			std::vector<double> centroids_;
+			std::vector<int> assignments_;
+			//How far each centroid moved in the last update.
+			std::vector<double> shifts_;
+			std::vector<double> separation_;
+			//Elkan's centroid-to-centroid distances, k * k.
+			std::vector<double> between_;
+			//Distance bounds: to a point's own centroid above, to the others below; one lower bound
+			//per point for Hamerly, one per point and centroid for Elkan.
+			std::vector<double> upper_;
+			std::vector<double> lower_;
+			//Elkan: whether upper_ has been loosened since it was last computed exactly.
+			std::vector<char> stale_;
+		};
+
+		kmeans_result cluster(euclidean_vector_batch points, int const k, kmeans_parameters const& parameters) {
+			if (k < 1 or k > points.rows()) {
+				throw euclidean_vector_error("Cluster count " + std::to_string(k) + " is not valid for " +
+				                             std::to_string(points.rows()) + " points");
+			}
+			return engine(std::move(points), k, parameters).Run();
+		}
+	} // namespace
+
+	kmeans_result kmeans(std::span<euclidean_vector const> const points, int const k,
+	                     kmeans_parameters const& parameters) {
+		auto const dimensions = points.empty() ? std::size_t{0} : detail::vector_access::size(points.front());
+		for (auto const& p : points) {
+			detail::check_dimensions(dimensions, detail::vector_access::size(p));
+		}
+		return cluster(euclidean_vector_batch(points, batch_layout::row_major), k, parameters);
+	}
+
+	kmeans_result kmeans(euclidean_vector_batch const& points, int const k, kmeans_parameters const& parameters) {
+		return cluster(points, k, parameters);
+	}
+} // namespace comp6771
@@ -0,0 +1,150 @@
+#include "comp6771/knn_index.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		//A search only splits its rows between threads in chunks of at least this many.
+		constexpr auto min_rows_per_chunk = 1024;
+
+		double checked_norm(double const* v, std::size_t const n) {
+			auto const norm = std::sqrt(kernels::active().squared_norm(v, n));
+			detail::check_direction(norm);
+			return norm;
+		}
+
+		//Strict weak order putting better neighbours first, and the heaps' worst entry on top.
+		struct ranks_before {
+			distance_metric metric;
+
+			bool operator()(neighbour const& a, neighbour const& b) const noexcept {
+				if (a.score != b.score) {
+					return metric == distance_metric::l2 ? a.score < b.score : a.score > b.score;
+				}
+				return a.index < b.index;
+			}
+		};
+	} // namespace
+
+	knn_index::knn_index(euclidean_vector_batch vectors, distance_metric const metric)
+	: vectors_{detail::row_major(std::move(vectors))}, metric_{metric} {
+		if (metric_ == distance_metric::cosine) {
+			norms_.reserve(static_cast<std::size_t>(size()));
+			for (auto r = 0; r < size(); ++r) {
+				norms_.push_back(checked_norm(vectors_[r].data(), static_cast<std::size_t>(dimensions())));
+			}
+		}
+	}
+
+	knn_index::knn_index(std::span<euclidean_vector const> const vectors, distance_metric const metric,
+	                     allocator_type const& alloc)
+	: knn_index(euclidean_vector_batch(vectors, batch_layout::row_major, alloc), metric) {}
+
+	void knn_index::Scan(double const* query, double const query_norm, int const first, int const last,
+	                     std::size_t const k, std::vector<neighbour>& heap) const {
+		auto const& kernel = kernels::active();
+		auto const before = ranks_before{metric_};
+		auto const n = static_cast<std::size_t>(dimensions());
+		heap.reserve(k);
+		for (auto r = first; r < last; ++r) {
+			auto const* row = vectors_[r].data();
+			auto score = 0.0;
+			switch (metric_) {
+			case distance_metric::l2:
+				score = kernel.squared_distance(row, query, n);
+				break;
+			case distance_metric::inner_product:
+				score = kernel.dot(row, query, n);
+				break;
+			case distance_metric::cosine:
+				score = kernel.dot(row, query, n) / (norms_[static_cast<std::size_t>(r)] * query_norm);
+				break;
+			}
+			auto const candidate = neighbour{r, score};
+			if (heap.size() < k) {
+				heap.push_back(candidate);
+				std::push_heap(heap.begin(), heap.end(), before);
+			} else if (before(candidate, heap.front())) {
+				std::pop_heap(heap.begin(), heap.end(), before);
+				heap.back() = candidate;
+				std::push_heap(heap.begin(), heap.end(), before);
+			}
+		}
+	}
+
+	double knn_index::QueryNorm(double const* query) const {
+		return metric_ == distance_metric::cosine ? checked_norm(query, static_cast<std::size_t>(dimensions())) : 1.0;
+	}
+
+	std::vector<neighbour> knn_index::Search(double const* query, double const query_norm, std::size_t const k,
+	                                         bool const split) const {
+		if (k == 0) {
+			return {};
+		}
+		auto const before = ranks_before{metric_};
+		auto const threads = split ? static_cast<int>(parallel::thread_count()) : 1;
+		auto const chunks = std::clamp(size() / min_rows_per_chunk, 1, 4 * threads);
+		if (threads == 1 or chunks == 1) {
+			auto heap = std::vector<neighbour>();
+			Scan(query, query_norm, 0, size(), k, heap);
+			std::sort_heap(heap.begin(), heap.end(), before);
+			return heap;
+		}
+
+		auto heaps = std::vector<std::vector<neighbour>>(static_cast<std::size_t>(chunks));
+		parallel::run(heaps.size(), [&](std::size_t const chunk) {
+			auto const c = static_cast<int>(chunk);
+			Scan(query, query_norm, static_cast<int>(static_cast<long long>(size()) * c / chunks),
+			     static_cast<int>(static_cast<long long>(size()) * (c + 1) / chunks), k, heaps[chunk]);
+		});
+		auto merged = std::vector<neighbour>();
+		merged.reserve(heaps.size() * k);
+		for (auto const& heap : heaps) {
+			merged.insert(merged.end(), heap.begin(), heap.end());
+		}
+		auto const keep = std::min(k, merged.size());
+		std::partial_sort(merged.begin(), merged.begin() + static_cast<std::ptrdiff_t>(keep), merged.end(), before);
+		merged.resize(keep);
+		return merged;
+	}
+
+	std::vector<neighbour> knn_index::search(const_euclidean_vector_view const query, int const k) const {
+		detail::check_dimensions(dimensions(), query.dimensions());
+		return Search(query.data(), QueryNorm(query.data()), static_cast<std::size_t>(std::clamp(k, 0, size())), true);
+	}
+
+	std::vector<std::vector<neighbour>> knn_index::search_batch(euclidean_vector_batch const& queries, int const k) const {
+		detail::check_dimensions(dimensions(), queries.dimensions());
+		auto const count = static_cast<std::size_t>(std::clamp(k, 0, size()));
+		//Copied out when strided, and normed up front so nothing throws on a worker thread.
+		auto copies = std::vector<euclidean_vector>();
+		auto rows = std::vector<double const*>();
+		auto query_norms = std::vector<double>();
+		for (auto r = 0; r < queries.rows(); ++r) {
+			auto const row = queries[r];
+			if (row.contiguous()) {
+				rows.push_back(row.data());
+			} else {
+				copies.push_back(static_cast<euclidean_vector>(row));
+				rows.push_back(nullptr);
+			}
+		}
+		for (std::size_t r = 0, copy = 0; r < rows.size(); ++r) {
+			if (rows[r] == nullptr) {
+				rows[r] = detail::vector_access::data(copies[copy++]);
+			}
+			query_norms.push_back(QueryNorm(rows[r]));
+		}
+
+		auto results = std::vector<std::vector<neighbour>>(rows.size());
+		parallel::run(results.size(), [&](std::size_t const i) {
+			results[i] = Search(rows[i], query_norms[i], count, false);
+		});
+		return results;
+	}
+} // namespace comp6771
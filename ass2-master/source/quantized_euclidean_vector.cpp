@@ -0,0 +1,322 @@
+#include "comp6771/quantized_euclidean_vector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define COMP6771_QUANTIZED_X86 1
+#include <immintrin.h>
+#define COMP6771_TARGET(isa) __attribute__((target(isa)))
+#else
+#define COMP6771_QUANTIZED_X86 0
+#endif
+
+namespace comp6771 {
+	namespace {
+		template<typename Code>
+		constexpr double lowest_code = std::numeric_limits<Code>::min();
+		template<typename Code>
+		constexpr double highest_code = std::numeric_limits<Code>::max();
+
+		struct range {
+			double lo = std::numeric_limits<double>::infinity();
+			double hi = -std::numeric_limits<double>::infinity();
+
+			void add(double const* magnitudes, std::size_t const n, std::size_t const stride) {
+				for (std::size_t i = 0; i < n; ++i) {
+					auto const x = magnitudes[i * stride];
+					if (not std::isfinite(x)) {
+						throw euclidean_vector_error("euclidean_vector with non-finite magnitudes can not be quantized");
+					}
+					lo = std::min(lo, x);
+					hi = std::max(hi, x);
+				}
+			}
+		};
+
+		//The (scale, offset) that covers `r` with Code's codes.
+		template<typename Code>
+		std::pair<double, double> calibrate(range const r, calibration const mode) {
+			if (r.lo > r.hi) {
+				return {0.0, 0.0};
+			}
+			if (mode == calibration::symmetric) {
+				auto const m = std::max(std::abs(r.lo), std::abs(r.hi));
+				if constexpr (std::is_signed_v<Code>) {
+					return {m / highest_code<Code>, 0.0};
+				} else {
+					return {2 * m / highest_code<Code>, -m};
+				}
+			}
+			auto const scale = (r.hi - r.lo) / (highest_code<Code> - lowest_code<Code>);
+			return {scale, r.lo - lowest_code<Code> * scale};
+		}
+
+		void check_range(double const scale, double const offset) {
+			if (not (scale >= 0.0) or not std::isfinite(scale) or not std::isfinite(offset)) {
+				throw euclidean_vector_error("Quantization scale must be finite and non-negative, and offset finite");
+			}
+		}
+
+		//The integer kernels. Products of two 8-bit codes fit in 17 bits, so the vector paths sum
+		//them in 32-bit lanes for a block of block_size codes at a time before widening.
+		constexpr std::size_t block_size = std::size_t{1} << 16;
+
+		template<typename Code>
+		std::int64_t scalar_code_dot(Code const* x, Code const* y, std::size_t const n) {
+			auto r = std::int64_t{0};
+			for (std::size_t i = 0; i < n; ++i) {
+				r += std::int32_t{x[i]} * std::int32_t{y[i]};
+			}
+			return r;
+		}
+
+		template<typename Code>
+		std::int64_t scalar_code_squared_distance(Code const* x, Code const* y, std::size_t const n) {
+			auto r = std::int64_t{0};
+			for (std::size_t i = 0; i < n; ++i) {
+				auto const d = std::int32_t{x[i]} - std::int32_t{y[i]};
+				r += d * d;
+			}
+			return r;
+		}
+
+#if COMP6771_QUANTIZED_X86
+		//AVX2: sixteen codes widened to 16 bits per step, multiplied and pairwise added by madd.
+		template<typename Code>
+		COMP6771_TARGET("avx2")
+		__m256i avx2_widen(Code const* p) {
+			auto const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+			if constexpr (std::is_signed_v<Code>) {
+				return _mm256_cvtepi8_epi16(bytes);
+			} else {
+				return _mm256_cvtepu8_epi16(bytes);
+			}
+		}
+
+		COMP6771_TARGET("avx2")
+		std::int64_t avx2_sum(__m256i const lanes) {
+			alignas(32) std::int32_t parts[8];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(parts), lanes);
+			auto r = std::int64_t{0};
+			for (auto const p : parts) {
+				r += p;
+			}
+			return r;
+		}
+
+		template<typename Code, bool Difference>
+		COMP6771_TARGET("avx2")
+		std::int64_t avx2_code_kernel(Code const* x, Code const* y, std::size_t const n) {
+			auto r = std::int64_t{0};
+			std::size_t i = 0;
+			while (i + 16 <= n) {
+				auto const end = std::min(n - (n - i) % 16, i + block_size);
+				auto acc = _mm256_setzero_si256();
+				for (; i < end; i += 16) {
+					auto const a = avx2_widen(x + i);
+					auto const b = avx2_widen(y + i);
+					if constexpr (Difference) {
+						auto const d = _mm256_sub_epi16(a, b);
+						acc = _mm256_add_epi32(acc, _mm256_madd_epi16(d, d));
+					} else {
+						acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+					}
+				}
+				r += avx2_sum(acc);
+			}
+			return r + (Difference ? scalar_code_squared_distance(x + i, y + i, n - i)
+			                       : scalar_code_dot(x + i, y + i, n - i));
+		}
+#endif
+
+		template<typename Code>
+		struct code_kernels {
+			std::int64_t (*dot)(Code const* x, Code const* y, std::size_t n);
+			std::int64_t (*squared_distance)(Code const* x, Code const* y, std::size_t n);
+		};
+
+		//Chosen by CPUID the first time it is needed, like kernels::active().
+		template<typename Code>
+		code_kernels<Code> const& active_code_kernels() noexcept {
+			static auto const table = [] {
+#if COMP6771_QUANTIZED_X86
+				if (__builtin_cpu_supports("avx2")) {
+					return code_kernels<Code>{avx2_code_kernel<Code, false>, avx2_code_kernel<Code, true>};
+				}
+#endif
+				return code_kernels<Code>{scalar_code_dot<Code>, scalar_code_squared_distance<Code>};
+			}();
+			return table;
+		}
+
+		//|x|^2 of the dequantized vector.
+		double squared_norm(double const scale, double const offset, std::int64_t const code_sum,
+		                    std::int64_t const code_squares, std::size_t const n) {
+			return scale * scale * static_cast<double>(code_squares) + 2 * scale * offset * static_cast<double>(code_sum)
+			     + static_cast<double>(n) * offset * offset;
+		}
+	} // namespace
+
+	template<typename Code>
+	basic_quantized_euclidean_vector<Code>::basic_quantized_euclidean_vector(euclidean_vector const& v,
+	                                                                         calibration const mode,
+	                                                                         allocator_type const& alloc)
+	: basic_quantized_euclidean_vector(const_row_view(detail::vector_access::data(v), detail::vector_access::size(v), 1),
+	                                   mode, alloc) {}
+
+	template<typename Code>
+	basic_quantized_euclidean_vector<Code>::basic_quantized_euclidean_vector(const_row_view const v,
+	                                                                         calibration const mode,
+	                                                                         allocator_type const& alloc)
+	: codes_(static_cast<std::size_t>(v.dimensions()), alloc) {
+		auto r = range();
+		r.add(v.data(), codes_.size(), v.stride());
+		std::tie(scale_, offset_) = calibrate<Code>(r, mode);
+		Quantize(v.data(), v.stride());
+	}
+
+	template<typename Code>
+	basic_quantized_euclidean_vector<Code>::basic_quantized_euclidean_vector(euclidean_vector const& v,
+	                                                                         double const scale, double const offset,
+	                                                                         allocator_type const& alloc)
+	: basic_quantized_euclidean_vector(const_row_view(detail::vector_access::data(v), detail::vector_access::size(v), 1),
+	                                   scale, offset, alloc) {}
+
+	template<typename Code>
+	basic_quantized_euclidean_vector<Code>::basic_quantized_euclidean_vector(const_row_view const v,
+	                                                                         double const scale, double const offset,
+	                                                                         allocator_type const& alloc)
+	: scale_{scale}, offset_{offset}, codes_(static_cast<std::size_t>(v.dimensions()), alloc) {
+		check_range(scale, offset);
+		range().add(v.data(), codes_.size(), v.stride());
+		Quantize(v.data(), v.stride());
+	}
+
+	//Rounds each magnitude to the nearest code, clamped to Code's range, and gathers the sums the
+	//kernels need alongside the error actually made.
+	template<typename Code>
+	void basic_quantized_euclidean_vector<Code>::Quantize(double const* magnitudes, std::size_t const stride) {
+		for (std::size_t i = 0; i < codes_.size(); ++i) {
+			auto const x = magnitudes[i * stride];
+			auto const code = scale_ == 0.0 ? 0.0 : std::clamp(std::nearbyint((x - offset_) / scale_),
+			                                                    lowest_code<Code>, highest_code<Code>);
+			codes_[i] = static_cast<Code>(code);
+			auto const decoded = scale_ * codes_[i] + offset_;
+			max_error_ = std::max(max_error_, std::abs(x - decoded));
+			code_sum_ += codes_[i];
+			code_squares_ += std::int32_t{codes_[i]} * std::int32_t{codes_[i]};
+			l1_norm_ += std::abs(decoded);
+		}
+	}
+
+	template<typename Code>
+	basic_quantized_euclidean_vector<Code>::operator euclidean_vector() const {
+		auto result = euclidean_vector(dimensions());
+		for (auto i = 0; i < dimensions(); ++i) {
+			result[i] = (*this)[i];
+		}
+		return result;
+	}
+
+	template<typename Code>
+	double basic_quantized_euclidean_vector<Code>::at(int const i) const {
+		if (i < 0 or i >= dimensions()) {
+			throw euclidean_vector_error("Index " + std::to_string(i) +" is not valid for this euclidean_vector object");
+		}
+		return (*this)[i];
+	}
+
+	template<typename Code>
+	std::vector<basic_quantized_euclidean_vector<Code>>
+	quantize(euclidean_vector_batch const& batch, calibration const mode, calibration_scope const scope) {
+		auto result = std::vector<basic_quantized_euclidean_vector<Code>>();
+		result.reserve(static_cast<std::size_t>(batch.rows()));
+		if (scope == calibration_scope::per_vector) {
+			for (auto r = 0; r < batch.rows(); ++r) {
+				result.emplace_back(batch[r], mode);
+			}
+			return result;
+		}
+		auto shared = range();
+		for (auto r = 0; r < batch.rows(); ++r) {
+			shared.add(batch[r].data(), static_cast<std::size_t>(batch.dimensions()), batch[r].stride());
+		}
+		auto const [scale, offset] = calibrate<Code>(shared, mode);
+		for (auto r = 0; r < batch.rows(); ++r) {
+			result.emplace_back(batch[r], scale, offset);
+		}
+		return result;
+	}
+
+	template<typename Code>
+	double dot(basic_quantized_euclidean_vector<Code> const& x, basic_quantized_euclidean_vector<Code> const& y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		auto const n = x.codes_.size();
+		auto const codes = static_cast<double>(active_code_kernels<Code>().dot(x.codes_.data(), y.codes_.data(), n));
+		//(sx qx + ox).(sy qy + oy), expanded over the sums.
+		return x.scale_ * y.scale_ * codes + x.scale_ * y.offset_ * static_cast<double>(x.code_sum_)
+		     + x.offset_ * y.scale_ * static_cast<double>(y.code_sum_) + static_cast<double>(n) * x.offset_ * y.offset_;
+	}
+
+	template<typename Code>
+	double squared_distance(basic_quantized_euclidean_vector<Code> const& x,
+	                        basic_quantized_euclidean_vector<Code> const& y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		auto const n = x.codes_.size();
+		if (x.scale_ == y.scale_ and x.offset_ == y.offset_) {
+			auto const codes = active_code_kernels<Code>().squared_distance(x.codes_.data(), y.codes_.data(), n);
+			return x.scale_ * x.scale_ * static_cast<double>(codes);
+		}
+		auto const xx = squared_norm(x.scale_, x.offset_, x.code_sum_, x.code_squares_, n);
+		auto const yy = squared_norm(y.scale_, y.offset_, y.code_sum_, y.code_squares_, n);
+		//Cancellation can leave a tiny negative for nearly equal vectors.
+		return std::max(xx + yy - 2 * dot(x, y), 0.0);
+	}
+
+	//With a = x + e, b = y + f and |e_i|, |f_i| bounded by the max errors,
+	//|a.b - x.y| = |x.f + e.y + e.f| <= |x|_1 max|f| + |y|_1 max|e| + n max|e| max|f|.
+	template<typename Code>
+	double dot_error_bound(basic_quantized_euclidean_vector<Code> const& x,
+	                       basic_quantized_euclidean_vector<Code> const& y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		return x.l1_norm_ * y.max_error_ + y.l1_norm_ * x.max_error_
+		     + static_cast<double>(x.dimensions()) * x.max_error_ * y.max_error_;
+	}
+
+	//With d the difference of the dequantized vectors and each component of the true difference
+	//within e = x.max_error() + y.max_error() of it, the error is at most 2 e |d|_1 + n e^2, and
+	//|d|_1 <= sqrt(n) |d|.
+	template<typename Code>
+	double squared_distance_error_bound(basic_quantized_euclidean_vector<Code> const& x,
+	                                    basic_quantized_euclidean_vector<Code> const& y, double const squared_distance) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		auto const n = static_cast<double>(x.dimensions());
+		auto const e = x.max_error() + y.max_error();
+		return 2 * e * std::sqrt(n * std::max(squared_distance, 0.0)) + n * e * e;
+	}
+
+#define COMP6771_INSTANTIATE_QUANTIZED_EUCLIDEAN_VECTOR(Code) \
+	template class basic_quantized_euclidean_vector<Code>; \
+	template std::vector<basic_quantized_euclidean_vector<Code>> \
+	quantize(euclidean_vector_batch const&, calibration, calibration_scope); \
+	template double dot(basic_quantized_euclidean_vector<Code> const&, basic_quantized_euclidean_vector<Code> const&); \
+	template double squared_distance(basic_quantized_euclidean_vector<Code> const&, \
+	                                 basic_quantized_euclidean_vector<Code> const&); \
+	template double dot_error_bound(basic_quantized_euclidean_vector<Code> const&, \
+	                                basic_quantized_euclidean_vector<Code> const&); \
+	template double squared_distance_error_bound(basic_quantized_euclidean_vector<Code> const&, \
+	                                             basic_quantized_euclidean_vector<Code> const&, double);
+
+	COMP6771_INSTANTIATE_QUANTIZED_EUCLIDEAN_VECTOR(std::int8_t)
+	COMP6771_INSTANTIATE_QUANTIZED_EUCLIDEAN_VECTOR(std::uint8_t)
+
+#undef COMP6771_INSTANTIATE_QUANTIZED_EUCLIDEAN_VECTOR
+} // namespace comp6771
@@ -0,0 +1,274 @@
+#include "comp6771/sparse_euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	sparse_euclidean_vector::sparse_euclidean_vector(int const dimensions, allocator_type const& alloc)
+	: dimensions_{dimensions}, indices_(alloc), values_(alloc) {}
+
+	sparse_euclidean_vector::sparse_euclidean_vector(int const dimensions,
+	                                                 std::initializer_list<std::pair<int, double>> entries,
+	                                                 allocator_type const& alloc)
+	: sparse_euclidean_vector(dimensions, alloc) {
+		auto sorted = std::vector<std::pair<int, double>>(entries);
+		std::stable_sort(sorted.begin(), sorted.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+		indices_.reserve(sorted.size());
+		values_.reserve(sorted.size());
+		for (auto it = sorted.begin(); it != sorted.end(); ++it) {
+			CheckIndex(it->first);
+			if (std::next(it) != sorted.end() and std::next(it)->first == it->first) {
+				continue;
+			}
+			if (it->second != 0.0) {
+				indices_.push_back(it->first);
+				values_.push_back(it->second);
+			}
+		}
+	}
+
+	sparse_euclidean_vector::sparse_euclidean_vector(euclidean_vector const& v, allocator_type const& alloc)
+	: sparse_euclidean_vector(v.dimensions(), alloc) {
+		auto const* data = detail::vector_access::data(v);
+		for (auto i = 0; i < dimensions_; ++i) {
+			if (data[i] != 0.0) {
+				indices_.push_back(i);
+				values_.push_back(data[i]);
+			}
+		}
+	}
+
+	sparse_euclidean_vector::sparse_euclidean_vector(sparse_euclidean_vector const& other, allocator_type const& alloc)
+	: dimensions_{other.dimensions_}, indices_(other.indices_, alloc), values_(other.values_, alloc) {}
+
+	sparse_euclidean_vector::operator euclidean_vector() const {
+		auto result = euclidean_vector(dimensions_);
+		for (std::size_t k = 0; k < indices_.size(); ++k) {
+			result[indices_[k]] = values_[k];
+		}
+		return result;
+	}
+
+	void sparse_euclidean_vector::CheckIndex(int const i) const {
+		if (i < 0 or i >= dimensions_) {
+			throw euclidean_vector_error("Index " + std::to_string(i) +" is not valid for this euclidean_vector object");
+		}
+	}
+
+	double sparse_euclidean_vector::operator[](int const i) const {
+		auto const it = std::lower_bound(indices_.begin(), indices_.end(), i);
+		return it != indices_.end() and *it == i ? values_[static_cast<std::size_t>(it - indices_.begin())] : 0.0;
+	}
+
+	double sparse_euclidean_vector::at(int const i) const {
+		CheckIndex(i);
+		return (*this)[i];
+	}
+
+	void sparse_euclidean_vector::set(int const i, double const value) {
+		CheckIndex(i);
+		auto const it = std::lower_bound(indices_.begin(), indices_.end(), i);
+		auto const k = it - indices_.begin();
+		auto const present = it != indices_.end() and *it == i;
+		if (value == 0.0) {
+			if (present) {
+				indices_.erase(it);
+				values_.erase(values_.begin() + k);
+			}
+		} else if (present) {
+			values_[static_cast<std::size_t>(k)] = value;
+		} else {
+			indices_.insert(it, i);
+			values_.insert(values_.begin() + k, value);
+		}
+	}
+
+	sparse_euclidean_vector sparse_euclidean_vector::operator+() const {
+		return *this;
+	}
+
+	sparse_euclidean_vector sparse_euclidean_vector::operator-() const {
+		auto tmp = *this;
+		tmp *= -1;
+		return tmp;
+	}
+
+	//A single merge pass over both index lists into fresh arrays. Entries that cancel exactly are
+	//dropped so nonzeros() stays honest.
+	void sparse_euclidean_vector::Merge(sparse_euclidean_vector const& b, double const sign) {
+		detail::check_dimensions(dimensions_, b.dimensions_);
+		auto indices = std::pmr::vector<int>(indices_.get_allocator());
+		auto values = std::pmr::vector<double>(values_.get_allocator());
+		indices.reserve(indices_.size() + b.indices_.size());
+		values.reserve(indices_.size() + b.indices_.size());
+		auto emit = [&](int const i, double const v) {
+			if (v != 0.0) {
+				indices.push_back(i);
+				values.push_back(v);
+			}
+		};
+		std::size_t x = 0;
+		std::size_t y = 0;
+		while (x < indices_.size() or y < b.indices_.size()) {
+			if (y == b.indices_.size() or (x < indices_.size() and indices_[x] < b.indices_[y])) {
+				emit(indices_[x], values_[x]);
+				++x;
+			} else if (x == indices_.size() or b.indices_[y] < indices_[x]) {
+				emit(b.indices_[y], sign * b.values_[y]);
+				++y;
+			} else {
+				emit(indices_[x], values_[x] + sign * b.values_[y]);
+				++x;
+				++y;
+			}
+		}
+		indices_ = std::move(indices);
+		values_ = std::move(values);
+	}
+
+	sparse_euclidean_vector& sparse_euclidean_vector::operator+=(sparse_euclidean_vector const& b) {
+		Merge(b, 1.0);
+		return *this;
+	}
+
+	sparse_euclidean_vector& sparse_euclidean_vector::operator-=(sparse_euclidean_vector const& b) {
+		Merge(b, -1.0);
+		return *this;
+	}
+
+	sparse_euclidean_vector& sparse_euclidean_vector::operator*=(double const& b) {
+		if (b == 0.0) {
+			indices_.clear();
+			values_.clear();
+		} else {
+			kernels::active().multiply(values_.data(), b, values_.size());
+		}
+		return *this;
+	}
+
+	sparse_euclidean_vector& sparse_euclidean_vector::operator/=(double const& b) {
+		if (std::abs(b-0) < 0.0001) {
+			throw euclidean_vector_error("Invalid vector division by 0");
+		}
+		kernels::active().divide(values_.data(), b, values_.size());
+		return *this;
+	}
+
+	//Same tolerance as euclidean_vector: an entry present on one side only must be near zero.
+	bool operator==(sparse_euclidean_vector const& a, sparse_euclidean_vector const& b) {
+		if (a.dimensions_ != b.dimensions_) {
+			return false;
+		}
+		auto difference = a;
+		difference -= b;
+		return std::all_of(difference.values_.begin(), difference.values_.end(),
+		                   [](double const v) { return std::abs(v) < 0.0001; });
+	}
+
+	std::ostream& operator<<(std::ostream& os, sparse_euclidean_vector const& a) {
+		return os << static_cast<euclidean_vector>(a);
+	}
+
+	//Walks both sorted index lists together, so O(x.nonzeros() + y.nonzeros()).
+	double dot(sparse_euclidean_vector const& x, sparse_euclidean_vector const& y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		auto const xi = x.indices();
+		auto const yi = y.indices();
+		auto result = 0.0;
+		std::size_t a = 0;
+		std::size_t b = 0;
+		while (a < xi.size() and b < yi.size()) {
+			if (xi[a] < yi[b]) {
+				++a;
+			} else if (yi[b] < xi[a]) {
+				++b;
+			} else {
+				result += x.values()[a] * y.values()[b];
+				++a;
+				++b;
+			}
+		}
+		return result;
+	}
+
+	double dot(sparse_euclidean_vector const& x, euclidean_vector const& y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		auto const* data = detail::vector_access::data(y);
+		auto const indices = x.indices();
+		auto const values = x.values();
+		auto result = 0.0;
+		for (std::size_t k = 0; k < indices.size(); ++k) {
+			result += values[k] * data[indices[k]];
+		}
+		return result;
+	}
+
+	double dot(euclidean_vector const& x, sparse_euclidean_vector const& y) {
+		detail::check_dimensions(x.dimensions(), y.dimensions());
+		return dot(y, x);
+	}
+
+	double euclidean_norm(sparse_euclidean_vector const& v) {
+		return std::sqrt(kernels::active().squared_norm(v.values().data(), v.values().size()));
+	}
+
+	sparse_euclidean_vector unit(sparse_euclidean_vector const& v) {
+		if (v.dimensions() == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a unit vector");
+		}
+		auto const d = euclidean_norm(v);
+		if (std::abs(d-0) < 0.0001) {
+			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not have a unit vector");
+		}
+		return v / d;
+	}
+
+	//set() keeps a maintained norm current, so a dense accumulator can track its norm cheaply. The
+	//reads go through the const operator[], since the writable one discards the cached norm.
+	euclidean_vector& operator+=(euclidean_vector& a, sparse_euclidean_vector const& b) {
+		detail::check_dimensions(a.dimensions(), b.dimensions());
+		auto const indices = b.indices();
+		auto const values = b.values();
+		for (std::size_t k = 0; k < indices.size(); ++k) {
+			a.set(indices[k], std::as_const(a)[indices[k]] + values[k]);
+		}
+		return a;
+	}
+
+	euclidean_vector& operator-=(euclidean_vector& a, sparse_euclidean_vector const& b) {
+		detail::check_dimensions(a.dimensions(), b.dimensions());
+		auto const indices = b.indices();
+		auto const values = b.values();
+		for (std::size_t k = 0; k < indices.size(); ++k) {
+			a.set(indices[k], std::as_const(a)[indices[k]] - values[k]);
+		}
+		return a;
+	}
+
+	euclidean_vector operator+(euclidean_vector a, sparse_euclidean_vector const& b) {
+		a += b;
+		return a;
+	}
+
+	euclidean_vector operator+(sparse_euclidean_vector const& a, euclidean_vector b) {
+		b += a;
+		return b;
+	}
+
+	euclidean_vector operator-(euclidean_vector a, sparse_euclidean_vector const& b) {
+		a -= b;
+		return a;
+	}
+
+	euclidean_vector operator-(sparse_euclidean_vector const& a, euclidean_vector const& b) {
+		detail::check_dimensions(a.dimensions(), b.dimensions());
+		auto result = -b;
+		result += a;
+		return result;
+	}
+} // namespace comp6771
@@ -0,0 +1,385 @@
+#include "comp6771/spatial_tree.hpp"
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace {
+		//Node bounds are computed apart from the kernels that score points, so a bound may round a
+		//hair above the distance it promises not to exceed. Pruning allows for that much.
+		constexpr auto bound_slack = 1e-12;
+
+		bool may_reach(double const bound, double const distance) noexcept {
+			return bound * (1 - bound_slack) <= distance;
+		}
+
+		//Closest first, ties to the lower index, and so the worst entry on top of a heap.
+		bool closer(neighbour const& a, neighbour const& b) noexcept {
+			if (a.score != b.score) {
+				return a.score < b.score;
+			}
+			return a.index < b.index;
+		}
+
+		int dimensions_of(std::span<euclidean_vector const> const points) {
+			return points.empty() ? 0 : points.front().dimensions();
+		}
+
+		std::pmr::vector<double> gather(std::span<euclidean_vector const> const points,
+		                                std::pmr::polymorphic_allocator<> const& alloc) {
+			auto const dimensions = dimensions_of(points);
+			auto result = std::pmr::vector<double>(alloc);
+			result.reserve(points.size() * static_cast<std::size_t>(dimensions));
+			for (auto const& p : points) {
+				detail::check_dimensions(dimensions, p.dimensions());
+				auto const* data = detail::vector_access::data(p);
+				result.insert(result.end(), data, data + dimensions);
+			}
+			return result;
+		}
+
+		std::pmr::vector<double> gather(euclidean_vector_batch const& points,
+		                                std::pmr::polymorphic_allocator<> const& alloc) {
+			auto result = std::pmr::vector<double>(alloc);
+			result.reserve(static_cast<std::size_t>(points.rows()) * static_cast<std::size_t>(points.dimensions()));
+			for (auto r = 0; r < points.rows(); ++r) {
+				auto const row = points[r];
+				for (auto d = 0; d < points.dimensions(); ++d) {
+					result.push_back(row[d]);
+				}
+			}
+			return result;
+		}
+	} // namespace
+
+	namespace detail {
+		template<typename Tree>
+		basic_spatial_tree<Tree>::basic_spatial_tree(std::pmr::vector<double> points, int const dimensions,
+		                                             int const leaf_size)
+		: dimensions_{dimensions}, points_(points.get_allocator()), indices_(points.get_allocator())
+		, nodes_(points.get_allocator()) {
+			auto const n = static_cast<std::size_t>(dimensions_);
+			auto const count = n == 0 ? std::size_t{0} : points.size() / n;
+			if (count == 0) {
+				return;
+			}
+			auto order = std::vector<int>(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				order[i] = static_cast<int>(i);
+			}
+			Build(order, 0, static_cast<int>(count), std::max(leaf_size, 1), points);
+
+			points_.resize(points.size());
+			indices_.assign(order.begin(), order.end());
+			for (std::size_t position = 0; position < count; ++position) {
+				auto const* from = points.data() + static_cast<std::size_t>(order[position]) * n;
+				std::copy(from, from + n, points_.data() + position * n);
+			}
+		}
+
+		template<typename Tree>
+		int basic_spatial_tree<Tree>::Build(std::vector<int>& order, int const begin, int const end,
+		                                    int const leaf_size, std::pmr::vector<double> const& unordered) {
+			auto const index = static_cast<int>(nodes_.size());
+			nodes_.push_back(node{begin, end, -1});
+			if (end - begin <= leaf_size) {
+				return index;
+			}
+
+			auto const n = static_cast<std::size_t>(dimensions_);
+			auto const coordinate = [&](int const point, std::size_t const d) {
+				return unordered[static_cast<std::size_t>(point) * n + d];
+			};
+			auto widest = std::size_t{0};
+			auto widest_spread = -1.0;
+			for (std::size_t d = 0; d < n; ++d) {
+				auto low = coordinate(order[static_cast<std::size_t>(begin)], d);
+				auto high = low;
+				for (auto i = begin + 1; i < end; ++i) {
+					auto const x = coordinate(order[static_cast<std::size_t>(i)], d);
+					low = std::min(low, x);
+					high = std::max(high, x);
+				}
+				if (high - low > widest_spread) {
+					widest = d;
+					widest_spread = high - low;
+				}
+			}
+
+			auto const middle = begin + (end - begin) / 2;
+			std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+			                 [&](int const a, int const b) {
+				                 auto const x = coordinate(a, widest);
+				                 auto const y = coordinate(b, widest);
+				                 return x != y ? x < y : a < b;
+			                 });
+			Build(order, begin, middle, leaf_size, unordered);
+			auto const right = Build(order, middle, end, leaf_size, unordered);
+			nodes_[static_cast<std::size_t>(index)].right = right;
+			return index;
+		}
+
+		template<typename Tree>
+		void basic_spatial_tree<Tree>::Knn(int const index, double const* query, std::size_t const k,
+		                                   std::vector<neighbour>& heap) const {
+			auto const& current = nodes_[static_cast<std::size_t>(index)];
+			if (current.right < 0) {
+				auto const& kernel = kernels::active();
+				auto const n = static_cast<std::size_t>(dimensions_);
+				for (auto position = current.begin; position < current.end; ++position) {
+					auto const candidate = neighbour{indices_[static_cast<std::size_t>(position)],
+					                                 kernel.squared_distance(Point(position), query, n)};
+					if (heap.size() < k) {
+						heap.push_back(candidate);
+						std::push_heap(heap.begin(), heap.end(), closer);
+					} else if (closer(candidate, heap.front())) {
+						std::pop_heap(heap.begin(), heap.end(), closer);
+						heap.back() = candidate;
+						std::push_heap(heap.begin(), heap.end(), closer);
+					}
+				}
+				return;
+			}
+
+			auto near = index + 1;
+			auto far = current.right;
+			auto near_bound = Derived().MinSquaredDistance(near, query);
+			auto far_bound = Derived().MinSquaredDistance(far, query);
+			if (far_bound < near_bound) {
+				std::swap(near, far);
+				std::swap(near_bound, far_bound);
+			}
+			if (heap.size() < k or may_reach(near_bound, heap.front().score)) {
+				Knn(near, query, k, heap);
+			}
+			if (heap.size() < k or may_reach(far_bound, heap.front().score)) {
+				Knn(far, query, k, heap);
+			}
+		}
+
+		template<typename Tree>
+		void basic_spatial_tree<Tree>::Radius(int const index, double const* query, double const squared_radius,
+		                                      std::vector<neighbour>& found) const {
+			if (not may_reach(Derived().MinSquaredDistance(index, query), squared_radius)) {
+				return;
+			}
+			auto const& current = nodes_[static_cast<std::size_t>(index)];
+			if (current.right < 0) {
+				auto const& kernel = kernels::active();
+				auto const n = static_cast<std::size_t>(dimensions_);
+				for (auto position = current.begin; position < current.end; ++position) {
+					auto const distance = kernel.squared_distance(Point(position), query, n);
+					if (distance <= squared_radius) {
+						found.push_back(neighbour{indices_[static_cast<std::size_t>(position)], distance});
+					}
+				}
+				return;
+			}
+			Radius(index + 1, query, squared_radius, found);
+			Radius(current.right, query, squared_radius, found);
+		}
+
+		template<typename Tree>
+		void basic_spatial_tree<Tree>::Box(int const index, double const* lower, double const* upper,
+		                                   std::vector<int>& found) const {
+			auto const& current = nodes_[static_cast<std::size_t>(index)];
+			switch (Derived().Overlap(index, lower, upper)) {
+			case overlap::none:
+				return;
+			case overlap::all:
+				found.insert(found.end(), indices_.begin() + current.begin, indices_.begin() + current.end);
+				return;
+			case overlap::partial:
+				break;
+			}
+			if (current.right < 0) {
+				for (auto position = current.begin; position < current.end; ++position) {
+					auto const* p = Point(position);
+					auto inside = true;
+					for (auto d = 0; d < dimensions_ and inside; ++d) {
+						inside = lower[d] <= p[d] and p[d] <= upper[d];
+					}
+					if (inside) {
+						found.push_back(indices_[static_cast<std::size_t>(position)]);
+					}
+				}
+				return;
+			}
+			Box(index + 1, lower, upper, found);
+			Box(current.right, lower, upper, found);
+		}
+
+		template<typename Tree>
+		neighbour basic_spatial_tree<Tree>::nearest(const_euclidean_vector_view const query) const {
+			detail::check_dimensions(dimensions(), query.dimensions());
+			if (nodes_.empty()) {
+				throw euclidean_vector_error(std::string(Tree::name) + " with no points does not have a nearest neighbour");
+			}
+			return knn(query, 1).front();
+		}
+
+		template<typename Tree>
+		std::vector<neighbour> basic_spatial_tree<Tree>::knn(const_euclidean_vector_view const query, int const k) const {
+			detail::check_dimensions(dimensions(), query.dimensions());
+			auto const count = static_cast<std::size_t>(std::clamp(k, 0, size()));
+			auto heap = std::vector<neighbour>();
+			if (count == 0) {
+				return heap;
+			}
+			heap.reserve(count);
+			Knn(0, query.data(), count, heap);
+			std::sort_heap(heap.begin(), heap.end(), closer);
+			return heap;
+		}
+
+		template<typename Tree>
+		std::vector<neighbour> basic_spatial_tree<Tree>::radius(const_euclidean_vector_view const query,
+		                                                        double const radius) const {
+			detail::check_dimensions(dimensions(), query.dimensions());
+			auto found = std::vector<neighbour>();
+			if (nodes_.empty() or radius < 0) {
+				return found;
+			}
+			Radius(0, query.data(), radius * radius, found);
+			std::sort(found.begin(), found.end(), closer);
+			return found;
+		}
+
+		template<typename Tree>
+		std::vector<int> basic_spatial_tree<Tree>::box(const_euclidean_vector_view const lower,
+		                                               const_euclidean_vector_view const upper) const {
+			detail::check_dimensions(dimensions(), lower.dimensions());
+			detail::check_dimensions(dimensions(), upper.dimensions());
+			auto found = std::vector<int>();
+			if (nodes_.empty()) {
+				return found;
+			}
+			Box(0, lower.data(), upper.data(), found);
+			std::sort(found.begin(), found.end());
+			return found;
+		}
+	} // namespace detail
+
+	kd_tree::kd_tree(std::span<euclidean_vector const> const points, int const leaf_size, allocator_type const& alloc)
+	: basic_spatial_tree(gather(points, alloc), dimensions_of(points), leaf_size), lower_(alloc), upper_(alloc) {
+		Bound();
+	}
+
+	kd_tree::kd_tree(euclidean_vector_batch const& points, int const leaf_size, allocator_type const& alloc)
+	: basic_spatial_tree(gather(points, alloc), points.dimensions(), leaf_size), lower_(alloc), upper_(alloc) {
+		Bound();
+	}
+
+	void kd_tree::Bound() {
+		auto const n = static_cast<std::size_t>(dimensions_);
+		lower_.resize(nodes_.size() * n);
+		upper_.resize(nodes_.size() * n);
+		for (std::size_t i = 0; i < nodes_.size(); ++i) {
+			auto* low = lower_.data() + i * n;
+			auto* high = upper_.data() + i * n;
+			std::copy(Point(nodes_[i].begin), Point(nodes_[i].begin) + n, low);
+			std::copy(low, low + n, high);
+			for (auto position = nodes_[i].begin + 1; position < nodes_[i].end; ++position) {
+				auto const* p = Point(position);
+				for (std::size_t d = 0; d < n; ++d) {
+					low[d] = std::min(low[d], p[d]);
+					high[d] = std::max(high[d], p[d]);
+				}
+			}
+		}
+	}
+
+	double kd_tree::MinSquaredDistance(int const index, double const* query) const noexcept {
+		auto const n = static_cast<std::size_t>(dimensions_);
+		auto const* low = lower_.data() + static_cast<std::size_t>(index) * n;
+		auto const* high = upper_.data() + static_cast<std::size_t>(index) * n;
+		auto result = 0.0;
+		for (std::size_t d = 0; d < n; ++d) {
+			auto const gap = query[d] < low[d] ? low[d] - query[d] : query[d] > high[d] ? query[d] - high[d] : 0.0;
+			result += gap * gap;
+		}
+		return result;
+	}
+
+	kd_tree::overlap kd_tree::Overlap(int const index, double const* lower, double const* upper) const noexcept {
+		auto const n = static_cast<std::size_t>(dimensions_);
+		auto const* low = lower_.data() + static_cast<std::size_t>(index) * n;
+		auto const* high = upper_.data() + static_cast<std::size_t>(index) * n;
+		auto contained = true;
+		for (std::size_t d = 0; d < n; ++d) {
+			if (high[d] < lower[d] or low[d] > upper[d]) {
+				return overlap::none;
+			}
+			contained = contained and lower[d] <= low[d] and high[d] <= upper[d];
+		}
+		return contained ? overlap::all : overlap::partial;
+	}
+
+	ball_tree::ball_tree(std::span<euclidean_vector const> const points, int const leaf_size,
+	                     allocator_type const& alloc)
+	: basic_spatial_tree(gather(points, alloc), dimensions_of(points), leaf_size), centres_(alloc), radii_(alloc) {
+		Bound();
+	}
+
+	ball_tree::ball_tree(euclidean_vector_batch const& points, int const leaf_size, allocator_type const& alloc)
+	: basic_spatial_tree(gather(points, alloc), points.dimensions(), leaf_size), centres_(alloc), radii_(alloc) {
+		Bound();
+	}
+
+	void ball_tree::Bound() {
+		auto const& kernel = kernels::active();
+		auto const n = static_cast<std::size_t>(dimensions_);
+		centres_.assign(nodes_.size() * n, 0.0);
+		radii_.assign(nodes_.size(), 0.0);
+		for (std::size_t i = 0; i < nodes_.size(); ++i) {
+			auto* centre = centres_.data() + i * n;
+			for (auto position = nodes_[i].begin; position < nodes_[i].end; ++position) {
+				auto const* p = Point(position);
+				for (std::size_t d = 0; d < n; ++d) {
+					centre[d] += p[d];
+				}
+			}
+			auto const count = static_cast<double>(nodes_[i].end - nodes_[i].begin);
+			for (std::size_t d = 0; d < n; ++d) {
+				centre[d] /= count;
+			}
+			auto furthest = 0.0;
+			for (auto position = nodes_[i].begin; position < nodes_[i].end; ++position) {
+				furthest = std::max(furthest, kernel.squared_distance(centre, Point(position), n));
+			}
+			radii_[i] = std::sqrt(furthest);
+		}
+	}
+
+	double ball_tree::MinSquaredDistance(int const index, double const* query) const noexcept {
+		auto const n = static_cast<std::size_t>(dimensions_);
+		auto const* centre = centres_.data() + static_cast<std::size_t>(index) * n;
+		auto const to_centre = std::sqrt(kernels::active().squared_distance(centre, query, n));
+		auto const gap = std::max(0.0, to_centre - radii_[static_cast<std::size_t>(index)]);
+		return gap * gap;
+	}
+
+	ball_tree::overlap ball_tree::Overlap(int const index, double const* lower, double const* upper) const noexcept {
+		auto const n = static_cast<std::size_t>(dimensions_);
+		auto const* centre = centres_.data() + static_cast<std::size_t>(index) * n;
+		auto const radius = radii_[static_cast<std::size_t>(index)] * (1 + bound_slack);
+		auto to_box = 0.0;
+		auto contained = true;
+		for (std::size_t d = 0; d < n; ++d) {
+			auto const gap = centre[d] < lower[d] ? lower[d] - centre[d] : centre[d] > upper[d] ? centre[d] - upper[d] : 0.0;
+			to_box += gap * gap;
+			contained = contained and lower[d] <= centre[d] - radius and centre[d] + radius <= upper[d];
+		}
+		if (not may_reach(to_box, radius * radius)) {
+			return overlap::none;
+		}
+		return contained ? overlap::all : overlap::partial;
+	}
+
+	template class detail::basic_spatial_tree<kd_tree>;
+	template class detail::basic_spatial_tree<ball_tree>;
+} // namespace comp6771
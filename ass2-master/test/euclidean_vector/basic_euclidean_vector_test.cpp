@@ -0,0 +1,69 @@
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <concepts>
+#include <sstream>
+#include <vector>
+
+using float_vector = comp6771::basic_euclidean_vector<float>;
+using float_vector_double_sums = comp6771::basic_euclidean_vector<float, double>;
+using long_double_vector = comp6771::basic_euclidean_vector<long double>;
+
+TEST_CASE("Float vectors store floats and follow the double interface") {
+	auto a = float_vector{3, 4, 0, 0, 12};
+	static_assert(std::same_as<decltype(a[0]), float&>);
+	static_assert(std::same_as<decltype(comp6771::euclidean_norm(a)), float>);
+	CHECK(comp6771::euclidean_norm(a) == Approx(13));
+	CHECK(comp6771::dot(a, a) == Approx(169));
+
+	auto const b = float_vector(5, 1.0f);
+	float_vector const sum = a + b * 2.0f;
+	CHECK(sum == float_vector{5, 6, 2, 2, 14});
+	a -= b;
+	a /= 2.0f;
+	CHECK(a == float_vector{1, 1.5f, -0.5f, -0.5f, 5.5f});
+	CHECK(comp6771::dot(a - b, b) == Approx(2));
+	CHECK_THROWS_WITH(a += float_vector(2), "Dimensions of LHS(5) and RHS(2) do not match");
+	CHECK_THROWS_WITH(a /= 0.0f, "Invalid vector division by 0");
+	CHECK_THROWS_WITH(a.at(5), "Index 5 is not valid for this euclidean_vector object");
+}
+
+TEST_CASE("Float storage can accumulate in double") {
+	//A float sum of 4096^2 has no bits left for the 2^-24 terms that follow it.
+	auto values = std::vector<float>(1 << 12, 1.0f / 4096);
+	values.front() = 4096.0f;
+	auto const narrow = float_vector(std::vector<float>(values));
+	auto const wide = float_vector_double_sums(std::move(values));
+	static_assert(std::same_as<decltype(comp6771::dot(wide, wide)), double>);
+
+	auto const expected = 4096.0 * 4096.0 + 4095.0 / (4096.0 * 4096.0);
+	CHECK(comp6771::dot(wide, wide) == expected);
+	CHECK(static_cast<double>(comp6771::dot(narrow, narrow)) != expected);
+}
+
+TEST_CASE("Changing precision is explicit") {
+	static_assert(not std::convertible_to<float_vector, comp6771::euclidean_vector>);
+	static_assert(std::constructible_from<comp6771::euclidean_vector, float_vector>);
+	static_assert(not std::convertible_to<comp6771::euclidean_vector, float_vector_double_sums>);
+
+	auto const d = comp6771::euclidean_vector{0.1, 0.2, 0.3, 0.4, 0.5};
+	auto const f = float_vector(d);
+	CHECK(f[0] == 0.1f);
+	CHECK(comp6771::euclidean_vector(f) == d);
+	CHECK(float_vector_double_sums(f) == float_vector_double_sums{0.1f, 0.2f, 0.3f, 0.4f, 0.5f});
+}
+
+TEST_CASE("Long double vectors keep their extra precision") {
+	auto const v = long_double_vector{1.0L, 1e-17L, 0, 0, 0};
+	auto const sum = long_double_vector(v + v);
+	CHECK(sum[1] == 2e-17L);
+	CHECK(comp6771::euclidean_norm(v) == Approx(1.0));
+
+	auto os = std::ostringstream();
+	os << float_vector{1.5f, -2} << long_double_vector{0.25L};
+	CHECK(os.str() == "[1.5 -2][0.25]");
+
+	auto is = std::istringstream("[0.5 1.25 -3]");
+	auto parsed = float_vector();
+	is >> parsed;
+	CHECK(parsed == float_vector{0.5f, 1.25f, -3});
+}
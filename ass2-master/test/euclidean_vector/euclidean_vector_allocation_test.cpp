@@ -0,0 +1,167 @@
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Every heap allocation in this test binary goes through here, so a test can count what a single
+// expression costs.
+namespace {
+	std::size_t allocations = 0;
+} // namespace
+
+void* operator new(std::size_t size) {
+	++allocations;
+	if (auto* p = std::malloc(size == 0 ? 1 : size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+//std::pmr::new_delete_resource() allocates through the aligned overloads.
+void* operator new(std::size_t size, std::align_val_t align) {
+	++allocations;
+	auto const alignment = static_cast<std::size_t>(align);
+	if (auto* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+namespace {
+	template<typename F>
+	std::size_t count_allocations(F&& f) {
+		auto const before = allocations;
+		std::forward<F>(f)();
+		return allocations - before;
+	}
+} // namespace
+
+TEST_CASE("Compound assignment returns a reference and never allocates") {
+	auto a = comp6771::euclidean_vector{1, 2, 3};
+	auto const b = comp6771::euclidean_vector{1, 1, 1};
+
+	STATIC_REQUIRE(std::is_same_v<decltype(a += b), comp6771::euclidean_vector&>);
+	STATIC_REQUIRE(std::is_same_v<decltype(a -= b), comp6771::euclidean_vector&>);
+	STATIC_REQUIRE(std::is_same_v<decltype(a *= 2), comp6771::euclidean_vector&>);
+	STATIC_REQUIRE(std::is_same_v<decltype(a /= 2), comp6771::euclidean_vector&>);
+
+	auto const n = count_allocations([&] { ((a += b) -= b) *= 4; a /= 2; a += b - b * 2; });
+	CHECK(n == 0);
+	REQUIRE(a == comp6771::euclidean_vector{1, 3, 5});
+}
+
+TEST_CASE("Operators reuse the buffer of an expiring operand") {
+	auto const a = comp6771::euclidean_vector{1, 2, 3};
+	auto const b = comp6771::euclidean_vector{3, 2, 1};
+	auto t1 = comp6771::euclidean_vector{1, 1, 1};
+	auto t2 = comp6771::euclidean_vector{1, 1, 1};
+	auto t3 = comp6771::euclidean_vector{1, 1, 1};
+	auto t4 = comp6771::euclidean_vector{2, 2, 2};
+
+	auto r1 = comp6771::euclidean_vector(0);
+	auto r2 = comp6771::euclidean_vector(0);
+	auto r3 = comp6771::euclidean_vector(0);
+	auto r4 = comp6771::euclidean_vector(0);
+
+	auto const n = count_allocations([&] {
+		r1 = std::move(t1) + a;
+		r2 = b - std::move(t2);
+		r3 = 2.0 * (-std::move(t3)) / 4;
+		r4 = (a + b) - std::move(t4) * 3;
+	});
+	CHECK(n == 0);
+	REQUIRE(r1 == comp6771::euclidean_vector{2, 3, 4});
+	REQUIRE(r2 == comp6771::euclidean_vector{2, 1, 0});
+	REQUIRE(r3 == comp6771::euclidean_vector{-0.5, -0.5, -0.5});
+	REQUIRE(r4 == comp6771::euclidean_vector{-2, -2, -2});
+}
+
+TEST_CASE("A chain allocates once for its result") {
+	//Large enough to live on the heap whatever the inline capacity is configured to.
+	auto const a = comp6771::euclidean_vector(64, 1.0);
+	auto const b = comp6771::euclidean_vector(64, 4.0);
+	auto const c = comp6771::euclidean_vector(64, 1.0);
+
+	auto r = comp6771::euclidean_vector(0);
+	CHECK(count_allocations([&] { r = comp6771::euclidean_vector(a + b - 2.0 * c); }) == 1);
+	CHECK(count_allocations([&] { r = comp6771::euclidean_vector(a) + b - 2.0 * c; }) == 1);
+	CHECK(count_allocations([&] { r = a + b - 2.0 * c; }) == 0);
+	REQUIRE(r == comp6771::euclidean_vector(64, 3.0));
+}
+
+TEST_CASE("Small vectors never touch the heap") {
+	if (COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY < 3) {
+		WARN("inline capacity is below 3; skipped");
+		return;
+	}
+	auto const n = count_allocations([] {
+		auto a = comp6771::euclidean_vector{1, 2, 3};
+		auto b = a;
+		auto c = std::move(a);
+		b = c;
+		c = std::move(b);
+		auto d = comp6771::euclidean_vector(c + c * 2);
+		d = -std::move(d);
+		(void)comp6771::euclidean_norm(d);
+	});
+	REQUIRE(n == 0);
+}
+
+TEST_CASE("Crossing the inline capacity keeps copy, move and assignment semantics") {
+	auto small = comp6771::euclidean_vector{3, 4};
+	auto large = comp6771::euclidean_vector(64, 2.0);
+	REQUIRE(comp6771::euclidean_norm(small) == Approx(5));
+
+	SECTION("Copying") {
+		auto copy = small;
+		copy = large;
+		REQUIRE(copy == large);
+		copy = small;
+		REQUIRE(copy == small);
+		REQUIRE(comp6771::unit(copy) == comp6771::euclidean_vector{0.6, 0.8});
+	}
+
+	SECTION("Moving a small vector leaves it empty") {
+		auto moved = std::move(small);
+		CHECK(small.dimensions() == 0);
+		REQUIRE(moved == comp6771::euclidean_vector{3, 4});
+		REQUIRE(comp6771::unit(moved) == comp6771::euclidean_vector{0.6, 0.8});
+		small = std::move(large);
+		CHECK(large.dimensions() == 0);
+		REQUIRE(small == comp6771::euclidean_vector(64, 2.0));
+		large = std::move(moved);
+		REQUIRE(large == comp6771::euclidean_vector{3, 4});
+	}
+
+	SECTION("Moving a large vector steals its buffer") {
+		auto const n = count_allocations([&] { small = std::move(large); });
+		CHECK(n == 0);
+		REQUIRE(small == comp6771::euclidean_vector(64, 2.0));
+	}
+}
+
+TEST_CASE("Reusing an operand keeps the dimension checks and their messages") {
+	auto const a = comp6771::euclidean_vector{1, 2, 3};
+	REQUIRE_THROWS_WITH((comp6771::euclidean_vector{1, 2} + a), "Dimensions of LHS(2) and RHS(3) do not match");
+	REQUIRE_THROWS_WITH((a - comp6771::euclidean_vector{1, 2}), "Dimensions of LHS(3) and RHS(2) do not match");
+	REQUIRE_THROWS_WITH((comp6771::euclidean_vector{1, 2} / 0), "Invalid vector division by 0");
+}
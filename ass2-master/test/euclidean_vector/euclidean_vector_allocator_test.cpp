@@ -0,0 +1,133 @@
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+namespace {
+	//Counts what reaches an upstream resource, so tests can see which resource a vector used.
+	class counting_resource : public std::pmr::memory_resource {
+	public:
+		std::size_t allocations = 0;
+		std::size_t deallocations = 0;
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			++allocations;
+			return upstream_.allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+			++deallocations;
+			upstream_.deallocate(p, bytes, alignment);
+		}
+
+		bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+			return this == &other;
+		}
+
+		std::pmr::unsynchronized_pool_resource upstream_;
+	};
+
+	constexpr auto large = 64;
+} // namespace
+
+TEST_CASE("Every constructor allocates from the given resource") {
+	auto arena = counting_resource();
+	auto const values = std::vector<double>(large, 1.5);
+	{
+		auto const a = comp6771::euclidean_vector(large, &arena);
+		auto const b = comp6771::euclidean_vector(large, 2.0, &arena);
+		auto const c = comp6771::euclidean_vector(values.begin(), values.end(), &arena);
+		auto const d = comp6771::euclidean_vector(b, &arena);
+		auto const e = comp6771::euclidean_vector(b + c, &arena);
+		CHECK(arena.allocations == 5);
+		CHECK(a.get_allocator().resource() == &arena);
+		CHECK(e.get_allocator().resource() == &arena);
+		REQUIRE(e == comp6771::euclidean_vector(large, 3.5));
+	}
+	CHECK(arena.deallocations == 5);
+}
+
+TEST_CASE("Small vectors never reach the resource") {
+	auto arena = counting_resource();
+	auto const a = comp6771::euclidean_vector({1.0, 2.0}, &arena);
+	auto const b = comp6771::euclidean_vector(&arena);
+	CHECK(arena.allocations == 0);
+	CHECK(b.get_allocator().resource() == &arena);
+}
+
+TEST_CASE("Allocator propagation follows std::pmr") {
+	auto arena = counting_resource();
+	auto other = counting_resource();
+	auto a = comp6771::euclidean_vector(large, 1.0, &arena);
+	REQUIRE(arena.allocations == 1);
+
+	SECTION("Copy construction uses the default resource") {
+		auto const b = a;
+		CHECK(b.get_allocator().resource() == std::pmr::get_default_resource());
+		CHECK(arena.allocations == 1);
+	}
+
+	SECTION("Move construction keeps the source's resource and buffer") {
+		auto const b = std::move(a);
+		CHECK(b.get_allocator().resource() == &arena);
+		CHECK(arena.allocations == 1);
+		CHECK(a.dimensions() == 0);
+	}
+
+	SECTION("Copy assignment keeps the target's resource") {
+		auto b = comp6771::euclidean_vector(2, &other);
+		b = a;
+		CHECK(b.get_allocator().resource() == &other);
+		CHECK(other.allocations == 1);
+		REQUIRE(b == a);
+	}
+
+	SECTION("Move assignment within a resource steals the buffer") {
+		auto b = comp6771::euclidean_vector(2, &arena);
+		b = std::move(a);
+		CHECK(arena.allocations == 1);
+		CHECK(a.dimensions() == 0);
+		REQUIRE(b == comp6771::euclidean_vector(large, 1.0));
+	}
+
+	SECTION("Move assignment across resources copies and empties the source") {
+		auto b = comp6771::euclidean_vector(2, &other);
+		REQUIRE(comp6771::euclidean_norm(a) == Approx(8));
+		b = std::move(a);
+		CHECK(b.get_allocator().resource() == &other);
+		CHECK(other.allocations == 1);
+		CHECK(arena.deallocations == 1);
+		CHECK(a.dimensions() == 0);
+		REQUIRE(b == comp6771::euclidean_vector(large, 1.0));
+		REQUIRE(comp6771::unit(b) == comp6771::euclidean_vector(large, 0.125));
+	}
+}
+
+TEST_CASE("Arithmetic stays in the resource of the vector it lands in") {
+	auto arena = counting_resource();
+	auto const a = comp6771::euclidean_vector(large, 1.0);
+	auto const b = comp6771::euclidean_vector(large, 2.0);
+
+	auto r = comp6771::euclidean_vector(1, &arena);
+	r = a + b * 2;
+	CHECK(arena.allocations == 1);
+	CHECK(r.get_allocator().resource() == &arena);
+	r = -std::move(r) + a;
+	CHECK(arena.allocations == 1);
+	CHECK(r.get_allocator().resource() == &arena);
+	REQUIRE(r == comp6771::euclidean_vector(large, -4.0));
+}
+
+TEST_CASE("A monotonic arena releases every vector at once") {
+	auto buffer = std::pmr::monotonic_buffer_resource();
+	auto batch = std::pmr::vector<comp6771::euclidean_vector>(&buffer);
+	for (auto i = 0; i < 16; ++i) {
+		batch.emplace_back(large, static_cast<double>(i));
+	}
+	for (auto const& v : batch) {
+		CHECK(v.get_allocator().resource() == &buffer);
+	}
+	REQUIRE(batch[3] == comp6771::euclidean_vector(large, 3.0));
+}
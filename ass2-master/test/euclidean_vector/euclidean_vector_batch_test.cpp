@@ -0,0 +1,112 @@
+#include "comp6771/euclidean_vector_batch.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+	std::vector<comp6771::euclidean_vector> sample_rows() {
+		auto rows = std::vector<comp6771::euclidean_vector>();
+		for (auto r = 0; r < 5; ++r) {
+			auto v = comp6771::euclidean_vector(11);
+			for (auto d = 0; d < 11; ++d) {
+				v[d] = r * 0.5 - d * 0.25 + 1.0;
+			}
+			rows.push_back(v);
+		}
+		return rows;
+	}
+} // namespace
+
+TEST_CASE("A batch is zero-filled with aligned, padded rows") {
+	auto const layout = GENERATE(comp6771::batch_layout::row_major, comp6771::batch_layout::column_major);
+	auto const b = comp6771::euclidean_vector_batch(3, 5, layout);
+	CHECK(b.rows() == 3);
+	CHECK(b.dimensions() == 5);
+	CHECK(b.layout() == layout);
+	CHECK(b.leading_dimension() % 8 == 0);
+	CHECK(reinterpret_cast<std::uintptr_t>(b.data()) % comp6771::euclidean_vector_batch::alignment == 0);
+	for (auto r = 0; r < b.rows(); ++r) {
+		for (auto d = 0; d < b.dimensions(); ++d) {
+			CHECK(b[r][d] == 0.0);
+		}
+	}
+}
+
+TEST_CASE("Rows read back what was stored in either layout") {
+	auto const rows = sample_rows();
+	auto const layout = GENERATE(comp6771::batch_layout::row_major, comp6771::batch_layout::column_major);
+	auto const b = comp6771::euclidean_vector_batch(rows, layout);
+	REQUIRE(b.rows() == 5);
+	for (auto r = 0; r < b.rows(); ++r) {
+		CHECK(static_cast<comp6771::euclidean_vector>(b[r]) == rows[static_cast<std::size_t>(r)]);
+	}
+	CHECK(b[0].contiguous() == (layout == comp6771::batch_layout::row_major));
+}
+
+TEST_CASE("Batch reductions match the single-vector functions") {
+	auto const rows = sample_rows();
+	auto const q = rows[3];
+	auto const layout = GENERATE(comp6771::batch_layout::row_major, comp6771::batch_layout::column_major);
+	auto const b = comp6771::euclidean_vector_batch(rows, layout);
+
+	auto const dots = comp6771::dot(b, q);
+	auto const norms = comp6771::euclidean_norm(b);
+	auto const self = comp6771::dot(b, comp6771::euclidean_vector_batch(rows));
+	REQUIRE(dots.size() == rows.size());
+	for (std::size_t r = 0; r < rows.size(); ++r) {
+		CHECK(dots[r] == Approx(comp6771::dot(rows[r], q)));
+		CHECK(norms[r] == Approx(comp6771::euclidean_norm(rows[r])));
+		CHECK(self[r] == Approx(comp6771::dot(rows[r], rows[r])));
+	}
+
+	auto const u = comp6771::unit(b);
+	for (auto const n : comp6771::euclidean_norm(u)) {
+		CHECK(n == Approx(1.0));
+	}
+}
+
+TEST_CASE("Batch arithmetic is elementwise and mixes layouts") {
+	auto const rows = sample_rows();
+	auto a = comp6771::euclidean_vector_batch(rows);
+	auto const b = comp6771::euclidean_vector_batch(rows, comp6771::batch_layout::column_major);
+
+	a += b;
+	a *= 3;
+	a -= b;
+	a /= 5;
+	for (auto r = 0; r < a.rows(); ++r) {
+		CHECK(static_cast<comp6771::euclidean_vector>(a[r]) == rows[static_cast<std::size_t>(r)]);
+	}
+	CHECK(a == b);
+
+	auto const offset = comp6771::euclidean_vector(11, 2.0);
+	auto c = b;
+	c += offset;
+	c -= offset;
+	c -= offset;
+	CHECK(static_cast<comp6771::euclidean_vector>(c[4]) == rows[4] - offset);
+}
+
+TEST_CASE("Batch errors use the euclidean_vector messages") {
+	auto b = comp6771::euclidean_vector_batch(2, 3);
+	CHECK_THROWS_WITH(b.row(2), "Row 2 is not valid for this euclidean_vector_batch object");
+	CHECK_THROWS_WITH(b.row(0).at(3), "Index 3 is not valid for this euclidean_vector object");
+	CHECK_THROWS_WITH(b.set_row(0, comp6771::euclidean_vector(4)), "Dimensions of LHS(3) and RHS(4) do not match");
+	CHECK_THROWS_WITH(comp6771::dot(b, comp6771::euclidean_vector(2)), "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(b += comp6771::euclidean_vector_batch(3, 3), "Rows of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(b /= 0, "Invalid vector division by 0");
+	CHECK_THROWS_WITH(comp6771::unit(b), "euclidean_vector with zero euclidean normal does not have a unit vector");
+}
+
+TEST_CASE("A moved-from batch is empty") {
+	auto a = comp6771::euclidean_vector_batch(2, 3);
+	a[1][2] = 4;
+	auto b = std::move(a);
+	CHECK(a.rows() == 0);
+	CHECK(a.dimensions() == 0);
+	CHECK(b[1][2] == 4);
+	a = b;
+	CHECK(a == b);
+}
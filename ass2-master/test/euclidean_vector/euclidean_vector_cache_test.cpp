@@ -0,0 +1,69 @@
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Concurrent const readers share one cached norm and dot") {
+	auto v = comp6771::euclidean_vector(1000);
+	for (auto i = 0; i < v.dimensions(); ++i) {
+		v[i] = std::cos(i * 0.01);
+	}
+	auto const& shared = v;
+	auto const expected_dot = comp6771::dot(comp6771::euclidean_vector(shared), comp6771::euclidean_vector(shared));
+
+	auto norms = std::vector<double>(8);
+	auto dots = std::vector<double>(8);
+	{
+		auto threads = std::vector<std::thread>();
+		for (std::size_t t = 0; t < norms.size(); ++t) {
+			threads.emplace_back([&, t] {
+				for (auto i = 0; i < 1000; ++i) {
+					norms[t] = comp6771::euclidean_norm(shared);
+					dots[t] = comp6771::dot(shared, shared);
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+	for (std::size_t t = 0; t < norms.size(); ++t) {
+		CHECK(norms[t] == std::sqrt(expected_dot));
+		CHECK(dots[t] == expected_dot);
+	}
+}
+
+TEST_CASE("Writes invalidate the cache") {
+	auto v = comp6771::euclidean_vector{3.0, 4.0};
+	REQUIRE(comp6771::euclidean_norm(v) == Approx(5.0));
+	REQUIRE(comp6771::dot(v, v) == Approx(25.0));
+
+	v[0] = 0.0;
+	CHECK(comp6771::euclidean_norm(v) == Approx(4.0));
+	CHECK(comp6771::dot(v, v) == Approx(16.0));
+
+	v.at(1) = 1.0;
+	CHECK(comp6771::euclidean_norm(v) == Approx(1.0));
+
+	v *= 2;
+	CHECK(comp6771::dot(v, v) == Approx(4.0));
+}
+
+TEST_CASE("Copies and moves carry the cache along") {
+	auto v = comp6771::euclidean_vector{3.0, 4.0};
+	REQUIRE(comp6771::euclidean_norm(v) == Approx(5.0));
+
+	auto const copy = v;
+	CHECK(comp6771::unit(copy) == comp6771::euclidean_vector{0.6, 0.8});
+
+	auto moved = std::move(v);
+	CHECK(comp6771::unit(moved) == comp6771::euclidean_vector{0.6, 0.8});
+}
+
+TEST_CASE("A vector whose norm is NaN recomputes it rather than caching") {
+	auto const v = comp6771::euclidean_vector{std::nan(""), 1.0};
+	CHECK(std::isnan(comp6771::euclidean_norm(v)));
+	CHECK(std::isnan(comp6771::euclidean_norm(v)));
+}
@@ -0,0 +1,93 @@
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <array>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+TEST_CASE("A std::vector&& lends its buffer and gets it back") {
+	auto values = std::vector<double>(100, 1.5);
+	auto const* buffer = values.data();
+	auto v = comp6771::euclidean_vector(std::move(values));
+	CHECK(values.empty());
+	REQUIRE(v.dimensions() == 100);
+	CHECK(v[99] == 1.5);
+
+	v *= 2;
+	auto back = std::move(v).to_vector();
+	CHECK(back.data() == buffer);
+	CHECK(back == std::vector<double>(100, 3.0));
+	CHECK(v.dimensions() == 0);
+}
+
+TEST_CASE("An adopted buffer moves between vectors whatever their resources") {
+	auto arena = std::pmr::monotonic_buffer_resource();
+	auto values = std::vector<double>(50, 2.0);
+	auto const* buffer = values.data();
+
+	auto target = comp6771::euclidean_vector(&arena);
+	target = comp6771::euclidean_vector(std::move(values));
+	CHECK(target.get_allocator().resource() == &arena);
+	auto moved = comp6771::euclidean_vector(std::move(target));
+	auto const back = static_cast<std::vector<double>>(std::move(moved));
+	CHECK(back.data() == buffer);
+}
+
+TEST_CASE("An adopted buffer outlives the resource it was adopted on") {
+	//Can't allocate at all, so adopting must take nothing from it.
+	auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>(std::pmr::null_memory_resource());
+	auto values = std::vector<double>(50, 2.0);
+	auto const* buffer = values.data();
+
+	auto outer = comp6771::euclidean_vector(std::pmr::new_delete_resource());
+	{
+		auto inner = comp6771::euclidean_vector(std::move(values), arena.get());
+		outer = std::move(inner);
+	}
+	arena.reset();
+	CHECK(outer == comp6771::euclidean_vector(50, 2.0));
+	CHECK(std::move(outer).to_vector().data() == buffer);
+}
+
+TEST_CASE("Short vectors are copied inline rather than adopted") {
+	auto values = std::vector<double>{1, 2};
+	auto v = comp6771::euclidean_vector(std::move(values));
+	CHECK(values.empty());
+	CHECK(v == comp6771::euclidean_vector{1, 2});
+	CHECK(std::move(v).to_vector() == std::vector<double>{1, 2});
+}
+
+TEST_CASE("Copying conversions leave the vector alone") {
+	auto const v = comp6771::euclidean_vector{1, 2, 3, 4, 5, 6};
+	CHECK(v.to_vector() == std::vector<double>{1, 2, 3, 4, 5, 6});
+	CHECK(static_cast<std::vector<double>>(v) == std::vector<double>{1, 2, 3, 4, 5, 6});
+	CHECK(static_cast<std::list<double>>(v) == std::list<double>{1, 2, 3, 4, 5, 6});
+	CHECK(v.dimensions() == 6);
+}
+
+TEST_CASE("Any arithmetic range or iterator pair constructs a vector") {
+	auto const expected = comp6771::euclidean_vector{1, 2, 3, 4, 5};
+
+	auto const doubles = std::array<double, 5>{1, 2, 3, 4, 5};
+	CHECK(comp6771::euclidean_vector(doubles) == expected);
+	CHECK(comp6771::euclidean_vector(std::span<double const>(doubles)) == expected);
+	CHECK(comp6771::euclidean_vector(std::vector<float>{1, 2, 3, 4, 5}) == expected);
+
+	auto const ints = std::list<int>{1, 2, 3, 4, 5};
+	CHECK(comp6771::euclidean_vector(ints) == expected);
+	CHECK(comp6771::euclidean_vector(ints.begin(), ints.end()) == expected);
+	CHECK(comp6771::euclidean_vector(std::views::iota(1, 6)) == expected);
+
+	auto in = std::istringstream("1 2 3 4 5");
+	CHECK(comp6771::euclidean_vector(std::views::istream<double>(in)) == expected);
+
+	auto arena = std::pmr::monotonic_buffer_resource();
+	auto const v = comp6771::euclidean_vector(std::vector<double>(10, 1.0), &arena);
+	CHECK(v.get_allocator().resource() == &arena);
+	CHECK(comp6771::euclidean_vector(std::vector<double>()).dimensions() == 0);
+}
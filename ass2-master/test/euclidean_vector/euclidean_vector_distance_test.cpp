@@ -0,0 +1,105 @@
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_batch.hpp"
+#include "comp6771/euclidean_vector_view.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vector>
+
+TEST_CASE("Distances match their definitions") {
+	auto const x = comp6771::euclidean_vector{1.0, -2.0, 3.0, 0.5, 4.0};
+	auto const y = comp6771::euclidean_vector{-1.0, 2.0, 2.0, 0.5, 1.0};
+	auto const difference = x - y;
+
+	CHECK(comp6771::squared_distance(x, y) == Approx(comp6771::dot(difference, difference)));
+	CHECK(comp6771::euclidean_distance(x, y) == Approx(comp6771::euclidean_norm(difference)));
+	CHECK(comp6771::manhattan_distance(x, y) == Approx(2.0 + 4.0 + 1.0 + 0.0 + 3.0));
+	CHECK(comp6771::chebyshev_distance(x, y) == 4.0);
+	CHECK(comp6771::cosine_similarity(x, y)
+	      == Approx(comp6771::dot(x, y) / (comp6771::euclidean_norm(x) * comp6771::euclidean_norm(y))));
+
+	CHECK(comp6771::squared_distance(x, x) == 0.0);
+	CHECK(comp6771::cosine_similarity(x, x) == Approx(1.0));
+	CHECK(comp6771::cosine_similarity(x, -x) == Approx(-1.0));
+}
+
+TEST_CASE("Distances cover every kernel width and tail") {
+	auto const n = GENERATE(1, 2, 3, 7, 8, 9, 16, 17, 33, 1000);
+	auto x = comp6771::euclidean_vector(n);
+	auto y = comp6771::euclidean_vector(n);
+	for (auto i = 0; i < n; ++i) {
+		x[i] = std::sin(i * 0.7 + 1.0);
+		y[i] = std::cos(i * 0.3) + 0.5;
+	}
+	auto squared = 0.0;
+	auto manhattan = 0.0;
+	auto chebyshev = 0.0;
+	for (auto i = 0; i < n; ++i) {
+		auto const d = x[i] - y[i];
+		squared += d * d;
+		manhattan += std::abs(d);
+		chebyshev = std::max(chebyshev, std::abs(d));
+	}
+	CHECK(comp6771::squared_distance(x, y) == Approx(squared));
+	CHECK(comp6771::manhattan_distance(x, y) == Approx(manhattan));
+	CHECK(comp6771::chebyshev_distance(x, y) == chebyshev);
+
+	SECTION("cosine_similarity gives the same answer with and without cached norms") {
+		auto const fused = comp6771::cosine_similarity(x, y);
+		comp6771::euclidean_norm(x);
+		auto const half_cached = comp6771::cosine_similarity(x, y);
+		comp6771::euclidean_norm(y);
+		auto const cached = comp6771::cosine_similarity(x, y);
+		CHECK(half_cached == Approx(fused));
+		CHECK(cached == Approx(fused));
+	}
+
+	SECTION("views and mixed arguments agree with vectors") {
+		auto const vx = comp6771::const_euclidean_vector_view(x);
+		CHECK(comp6771::squared_distance(vx, y) == Approx(squared));
+		CHECK(comp6771::euclidean_distance(vx, y) == Approx(std::sqrt(squared)));
+		CHECK(comp6771::manhattan_distance(vx, y) == Approx(manhattan));
+		CHECK(comp6771::chebyshev_distance(vx, y) == chebyshev);
+		CHECK(comp6771::cosine_similarity(vx, y) == Approx(comp6771::cosine_similarity(x, y)));
+	}
+}
+
+TEST_CASE("Other precisions accumulate in their own type") {
+	auto const x = comp6771::basic_euclidean_vector<float>{1.0F, 2.0F, 3.0F};
+	auto const y = comp6771::basic_euclidean_vector<float>{4.0F, 6.0F, 3.0F};
+	CHECK(comp6771::squared_distance(x, y) == 25.0F);
+	CHECK(comp6771::euclidean_distance(x, y) == 5.0F);
+	CHECK(comp6771::manhattan_distance(x, y) == 7.0F);
+	CHECK(comp6771::chebyshev_distance(x, y) == 4.0F);
+
+	auto const lx = comp6771::basic_euclidean_vector<float, long double>{3.0F, 4.0F};
+	auto const ly = comp6771::basic_euclidean_vector<float, long double>{4.0F, 3.0F};
+	CHECK(comp6771::cosine_similarity(lx, ly) == Approx(24.0 / 25.0));
+}
+
+TEST_CASE("Distance errors") {
+	auto const x = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+	auto const y = comp6771::euclidean_vector{1.0, 2.0};
+	CHECK_THROWS_WITH(comp6771::squared_distance(x, y), "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(comp6771::euclidean_distance(x, y), "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(comp6771::cosine_similarity(x, y), "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(comp6771::manhattan_distance(x, y), "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(comp6771::chebyshev_distance(x, y), "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(comp6771::manhattan_distance(comp6771::const_euclidean_vector_view(x), y),
+	                  "Dimensions of LHS(3) and RHS(2) do not match");
+
+	auto const zero = comp6771::euclidean_vector(3);
+	CHECK_THROWS_WITH(comp6771::cosine_similarity(x, zero),
+	                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+	CHECK_THROWS_WITH(comp6771::cosine_similarity(comp6771::const_euclidean_vector_view(zero), x),
+	                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+}
+
+TEST_CASE("Cosine similarity ignores scale, however small") {
+	auto const x = comp6771::euclidean_vector{3e-5, 4e-5, 0};
+	auto const y = comp6771::euclidean_vector{4.0, 3.0, 0};
+	CHECK(comp6771::cosine_similarity(x, y) == Approx(24.0 / 25.0));
+	CHECK(comp6771::cosine_similarity(x, x) == Approx(1.0));
+	CHECK(comp6771::cosine_similarity(comp6771::const_euclidean_vector_view(x), y) == Approx(24.0 / 25.0));
+	auto const tiny = comp6771::basic_euclidean_vector<float>{3e-5f, 4e-5f, 0};
+	CHECK(comp6771::cosine_similarity(tiny, tiny) == Approx(1.0));
+}
@@ -0,0 +1,82 @@
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+
+TEST_CASE("Chained arithmetic is lazy until assigned to a euclidean_vector") {
+	auto const a = comp6771::euclidean_vector{1, 2, 3};
+	auto const b = comp6771::euclidean_vector{4, 5, 6};
+	auto const c = comp6771::euclidean_vector{1, 1, 1};
+
+	auto const expr = a + b - 2.0 * c;
+	STATIC_REQUIRE_FALSE(std::is_same_v<std::remove_cvref_t<decltype(expr)>, comp6771::euclidean_vector>);
+
+	auto const result = comp6771::euclidean_vector(expr);
+	REQUIRE(result == comp6771::euclidean_vector{3, 5, 7});
+	REQUIRE(comp6771::euclidean_vector(a * 2 / 4) == comp6771::euclidean_vector{0.5, 1, 1.5});
+	REQUIRE(comp6771::euclidean_vector(-(a - b)) == comp6771::euclidean_vector{3, 3, 3});
+}
+
+TEST_CASE("Expressions keep the dimension and division checks of the eager operators") {
+	auto const a = comp6771::euclidean_vector{1, 2, 3};
+	auto const b = comp6771::euclidean_vector{1, 2};
+
+	REQUIRE_THROWS_WITH(a + b, "Dimensions of LHS(3) and RHS(2) do not match");
+	REQUIRE_THROWS_WITH((a + a) - b, "Dimensions of LHS(3) and RHS(2) do not match");
+	REQUIRE_THROWS_WITH(b - (a * 2), "Dimensions of LHS(2) and RHS(3) do not match");
+	REQUIRE_THROWS_WITH((a + a) / 0, "Invalid vector division by 0");
+}
+
+TEST_CASE("Assigning an expression that refers to its target") {
+	auto a = comp6771::euclidean_vector{1, 2, 3};
+	auto const b = comp6771::euclidean_vector{1, 1, 1};
+
+	a = a + b * 3;
+	REQUIRE(a == comp6771::euclidean_vector{4, 5, 6});
+
+	auto c = comp6771::euclidean_vector(1);
+	c = a - b;
+	CHECK(c.dimensions() == 3);
+	REQUIRE(c == comp6771::euclidean_vector{3, 4, 5});
+}
+
+TEST_CASE("Assigning an expression resets the norm cache") {
+	auto a = comp6771::euclidean_vector{3, 4};
+	REQUIRE(comp6771::euclidean_norm(a) == Approx(5));
+	a = a * 2;
+	REQUIRE(comp6771::euclidean_norm(a) == Approx(10));
+}
+
+TEST_CASE("Expressions own temporary operands") {
+	auto const b = comp6771::euclidean_vector{1, 1};
+	auto const expr = comp6771::euclidean_vector{1, 2} + b;
+	REQUIRE(comp6771::euclidean_vector(expr) == comp6771::euclidean_vector{2, 3});
+}
+
+TEST_CASE("Const rvalue operands are copied into the expression") {
+	auto const make = []() -> comp6771::euclidean_vector const { return comp6771::euclidean_vector{1, 2, 3}; };
+	auto const b = comp6771::euclidean_vector{1, 1, 1};
+
+	auto const sum = make() + b;
+	REQUIRE(comp6771::euclidean_vector(sum) == comp6771::euclidean_vector{2, 3, 4});
+	REQUIRE(comp6771::euclidean_vector(b - make()) == comp6771::euclidean_vector{0, -1, -2});
+	REQUIRE(comp6771::euclidean_vector(make() * 2.0) == comp6771::euclidean_vector{2, 4, 6});
+	REQUIRE(comp6771::euclidean_vector(make() / 2.0) == comp6771::euclidean_vector{0.5, 1, 1.5});
+	REQUIRE(comp6771::dot(make() + b, b) == Approx(9.0));
+	CHECK_THROWS_WITH((make() + comp6771::euclidean_vector{1, 1}), "Dimensions of LHS(3) and RHS(2) do not match");
+}
+
+TEST_CASE("Expressions work with the free functions and operator<<") {
+	auto const a = comp6771::euclidean_vector{3, 0};
+	auto const b = comp6771::euclidean_vector{0, 4};
+
+	REQUIRE(comp6771::euclidean_norm(a + b) == Approx(5));
+	REQUIRE(comp6771::dot(a + b, a) == Approx(9));
+	REQUIRE((a + b) == (b + a));
+	REQUIRE((a + b) != (a - b));
+
+	auto oss = std::ostringstream{};
+	oss << (a + b);
+	CHECK(oss.str() == "[3 4]");
+}
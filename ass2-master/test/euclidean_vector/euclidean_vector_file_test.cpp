@@ -0,0 +1,181 @@
+#include "comp6771/euclidean_vector_file.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace {
+	std::vector<comp6771::euclidean_vector> sample_rows() {
+		auto rows = std::vector<comp6771::euclidean_vector>();
+		for (auto r = 0; r < 6; ++r) {
+			auto v = comp6771::euclidean_vector(13);
+			for (auto d = 0; d < 13; ++d) {
+				v[d] = r * 1.5 - d * 0.125;
+			}
+			rows.push_back(v);
+		}
+		return rows;
+	}
+
+	std::filesystem::path temp_file(char const* name) {
+		return std::filesystem::temp_directory_path() / name;
+	}
+} // namespace
+
+TEST_CASE("Records map back in place, aligned and unchanged") {
+	auto const rows = sample_rows();
+	auto const alignment = GENERATE(std::size_t{8}, std::size_t{64}, std::size_t{4096});
+	auto const path = temp_file("comp6771_file_test_roundtrip.vec");
+	comp6771::write_vector_file(path, rows, alignment);
+
+	auto const file = comp6771::mapped_vector_file(path);
+	REQUIRE(file.size() == 6);
+	REQUIRE(file.dimensions() == 13);
+	CHECK(file.stride() * sizeof(double) % alignment == 0);
+	CHECK(file.verify());
+	for (auto r = 0; r < file.size(); ++r) {
+		auto const record = file[r];
+		CHECK(reinterpret_cast<std::uintptr_t>(record.data()) % alignment == 0);
+		CHECK(file.load(r) == rows[static_cast<std::size_t>(r)]);
+	}
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Records are views that work without a copy") {
+	auto const rows = sample_rows();
+	auto const path = temp_file("comp6771_file_test_views.vec");
+	comp6771::write_vector_file(path, rows);
+
+	auto const file = comp6771::mapped_vector_file(path);
+	auto const record = file.record(2);
+	CHECK(record == rows[2]);
+	CHECK(record.dimensions() == 13);
+	CHECK(comp6771::dot(record, file[3]) == Approx(comp6771::dot(rows[2], rows[3])));
+	CHECK(comp6771::euclidean_norm(record) == Approx(comp6771::euclidean_norm(rows[2])));
+	CHECK(comp6771::euclidean_distance(file[0], rows[5]) == Approx(comp6771::euclidean_distance(rows[0], rows[5])));
+	auto printed = std::ostringstream();
+	auto expected = std::ostringstream();
+	printed << record;
+	expected << rows[2];
+	CHECK(printed.str() == expected.str());
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("A mapped file loads into a batch of either layout") {
+	auto const rows = sample_rows();
+	auto const path = temp_file("comp6771_file_test_batch.vec");
+	comp6771::write_vector_file(path, comp6771::euclidean_vector_batch(rows, comp6771::batch_layout::column_major));
+
+	auto file = comp6771::mapped_vector_file(path);
+	auto const layout = GENERATE(comp6771::batch_layout::row_major, comp6771::batch_layout::column_major);
+	CHECK(file.load_batch(layout) == comp6771::euclidean_vector_batch(rows));
+
+	auto moved = std::move(file);
+	CHECK(file.size() == 0);
+	CHECK(moved.load(5) == rows[5]);
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("An empty file set round-trips") {
+	auto const path = temp_file("comp6771_file_test_empty.vec");
+	comp6771::write_vector_file(path, std::span<comp6771::euclidean_vector const>());
+	auto const file = comp6771::mapped_vector_file(path);
+	CHECK(file.size() == 0);
+	CHECK(file.verify());
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Malformed and corrupted files are rejected") {
+	auto const rows = sample_rows();
+	auto const path = temp_file("comp6771_file_test_bad.vec");
+
+	CHECK_THROWS_WITH(comp6771::write_vector_file(path, rows, 12), "Alignment 12 is not valid for a vector file");
+	auto uneven = rows;
+	uneven.emplace_back(2);
+	CHECK_THROWS_WITH(comp6771::write_vector_file(path, uneven), "Dimensions of LHS(13) and RHS(2) do not match");
+	CHECK_THROWS_AS(comp6771::mapped_vector_file(temp_file("comp6771_file_test_missing.vec")), std::system_error);
+
+	comp6771::write_vector_file(path, rows);
+	{
+		auto f = std::fstream(path, std::ios::in | std::ios::out | std::ios::binary);
+		f.seekp(static_cast<std::streamoff>(std::filesystem::file_size(path) - 1));
+		f.put('\x7f');
+	}
+	auto const corrupted = comp6771::mapped_vector_file(path);
+	CHECK_FALSE(corrupted.verify());
+	CHECK_THROWS_WITH(corrupted.record(6), "Record 6 is not valid for this mapped_vector_file object");
+
+	std::filesystem::resize_file(path, 200);
+	CHECK_THROWS_AS(comp6771::mapped_vector_file(path), comp6771::euclidean_vector_error);
+	{
+		auto f = std::ofstream(path, std::ios::binary);
+		f << "not a vector file, but long enough to hold a header of sixty-four bytes.";
+	}
+	CHECK_THROWS_WITH(comp6771::mapped_vector_file(path), path.string() + " is not a vector file");
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Sign flips in pairs of magnitudes change the checksum") {
+	auto const a = std::vector<double>{1, 2, 3, 4};
+	auto const b = std::vector<double>{-1, 2, -3, 4};
+	CHECK(comp6771::vector_file_checksum(a) != comp6771::vector_file_checksum(b));
+
+	auto const rows = sample_rows();
+	auto const path = temp_file("comp6771_file_test_signs.vec");
+	comp6771::write_vector_file(path, rows);
+	auto const record_bytes = comp6771::mapped_vector_file(path).stride() * sizeof(double);
+	auto const payload_offset = comp6771::mapped_vector_file(path).header().payload_offset;
+	{
+		//Flips the sign bit, in the last byte of the little-endian double, of the first magnitude
+		//of rows 1 and 4.
+		auto f = std::fstream(path, std::ios::in | std::ios::out | std::ios::binary);
+		for (auto const row : {std::size_t{1}, std::size_t{4}}) {
+			auto const sign = static_cast<std::streamoff>(payload_offset + row * record_bytes + sizeof(double) - 1);
+			f.seekg(sign);
+			auto const byte = static_cast<char>(f.get() ^ 0x80);
+			f.seekp(sign);
+			f.put(byte);
+		}
+	}
+	auto const flipped = comp6771::mapped_vector_file(path);
+	CHECK(flipped[1][0] == -rows[1][0]);
+	CHECK(flipped[4][0] == -rows[4][0]);
+	CHECK_FALSE(flipped.verify());
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("Header sizes that don't fit are rejected") {
+	auto const rows = sample_rows();
+	auto const path = temp_file("comp6771_file_test_header.vec");
+	//Writes a fresh file, then overwrites one 64-bit header field.
+	auto const patch = [&](std::streamoff const offset, std::uint64_t const value) {
+		comp6771::write_vector_file(path, rows);
+		auto f = std::fstream(path, std::ios::in | std::ios::out | std::ios::binary);
+		f.seekp(offset);
+		f.write(reinterpret_cast<char const*>(&value), sizeof(value));
+	};
+	auto const count = std::streamoff{offsetof(comp6771::vector_file_header, count)};
+	auto const dimensions = std::streamoff{offsetof(comp6771::vector_file_header, dimensions)};
+	auto const malformed = path.string() + " has a malformed header";
+
+	patch(count, std::uint64_t{1} << 32);
+	CHECK_THROWS_WITH(comp6771::mapped_vector_file(path), malformed);
+	patch(count, std::numeric_limits<std::uint64_t>::max());
+	CHECK_THROWS_WITH(comp6771::mapped_vector_file(path), malformed);
+	patch(dimensions, std::uint64_t{1} << 31);
+	CHECK_THROWS_WITH(comp6771::mapped_vector_file(path), malformed);
+	patch(dimensions, std::numeric_limits<std::uint64_t>::max());
+	CHECK_THROWS_WITH(comp6771::mapped_vector_file(path), malformed);
+	patch(dimensions, 0);
+	CHECK_THROWS_WITH(comp6771::mapped_vector_file(path), malformed);
+	//Fits in an int, but the file is far too short for it.
+	patch(dimensions, std::numeric_limits<int>::max());
+	CHECK_THROWS_WITH(comp6771::mapped_vector_file(path), path.string() + " is truncated or has a malformed header");
+	std::filesystem::remove(path);
+}
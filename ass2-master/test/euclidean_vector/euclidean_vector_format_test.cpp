@@ -0,0 +1,115 @@
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <array>
+#include <charconv>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+	std::string format(comp6771::euclidean_vector const& v, comp6771::text_format const& f = {}) {
+		auto text = std::string(comp6771::max_chars(static_cast<std::size_t>(v.dimensions()), f), '\0');
+		auto const result = comp6771::to_chars(text.data(), text.data() + text.size(), v, f);
+		REQUIRE(result.ec == std::errc{});
+		text.resize(static_cast<std::size_t>(result.ptr - text.data()));
+		return text;
+	}
+
+	comp6771::euclidean_vector awkward() {
+		return {0.1, 1.0 / 3.0, -2.5e300, 5e-324, std::numeric_limits<double>::max(), 0.0, -7.0};
+	}
+} // namespace
+
+TEST_CASE("Shortest text reads back bit for bit in every layout") {
+	auto const v = awkward();
+	auto const layout = GENERATE(comp6771::text_layout::bracketed, comp6771::text_layout::whitespace,
+	                             comp6771::text_layout::csv);
+	auto const text = format(v, {layout});
+
+	auto back = comp6771::euclidean_vector();
+	auto const result = comp6771::from_chars(text.data(), text.data() + text.size(), back, layout);
+	REQUIRE(result.ec == std::errc{});
+	CHECK(result.ptr == text.data() + text.size());
+	REQUIRE(back.dimensions() == v.dimensions());
+	for (auto i = 0; i < v.dimensions(); ++i) {
+		CHECK(back[i] == v[i]);
+	}
+}
+
+TEST_CASE("Layouts and precision produce the expected text") {
+	auto const v = comp6771::euclidean_vector{1.5, -2, 0.1};
+	CHECK(format(v) == "[1.5 -2 0.1]");
+	CHECK(format(v, {comp6771::text_layout::whitespace}) == "1.5 -2 0.1");
+	CHECK(format(v, {comp6771::text_layout::csv}) == "1.5,-2,0.1");
+	CHECK(format(v, {comp6771::text_layout::csv, std::chars_format::fixed, 2}) == "1.50,-2.00,0.10");
+	CHECK(format(comp6771::euclidean_vector(0)) == "[]");
+	CHECK(format(comp6771::euclidean_vector(0), {comp6771::text_layout::csv}).empty());
+}
+
+TEST_CASE("Line layouts stop at the end of the line") {
+	auto const text = std::string("  1, +2 ,3e1\n4,5\n");
+	auto magnitudes = std::vector<double>();
+	auto const first = comp6771::from_chars(text.data(), text.data() + text.size(), magnitudes,
+	                                        comp6771::text_layout::csv);
+	REQUIRE(first.ec == std::errc{});
+	CHECK(*first.ptr == '\n');
+	auto const second = comp6771::from_chars(first.ptr + 1, text.data() + text.size(), magnitudes,
+	                                         comp6771::text_layout::csv);
+	REQUIRE(second.ec == std::errc{});
+	CHECK(magnitudes == std::vector<double>{1, 2, 30, 4, 5});
+
+	auto const blank = std::string("\n");
+	CHECK(comp6771::from_chars(blank.data(), blank.data() + 1, magnitudes, comp6771::text_layout::whitespace).ptr
+	      == blank.data());
+	CHECK(magnitudes.size() == 5);
+}
+
+TEST_CASE("Malformed text and short buffers are reported, not thrown") {
+	auto magnitudes = std::vector<double>{9};
+	for (auto const* bad : {"[1 2", "1 2]", "[1,2]", "[1 x]", "[1e999]"}) {
+		auto const text = std::string(bad);
+		auto const result = comp6771::from_chars(text.data(), text.data() + text.size(), magnitudes);
+		CHECK(result.ec != std::errc{});
+	}
+	auto const csv = std::string("1,,2");
+	auto const result = comp6771::from_chars(csv.data(), csv.data() + csv.size(), magnitudes,
+	                                         comp6771::text_layout::csv);
+	CHECK(result.ec == std::errc::invalid_argument);
+	CHECK(result.ptr == csv.data() + 2);
+	CHECK(magnitudes == std::vector<double>{9});
+
+	auto buffer = std::array<char, 6>{};
+	auto const v = comp6771::euclidean_vector{1, 2, 3};
+	CHECK(comp6771::to_chars(buffer.data(), buffer.data() + buffer.size(), v).ec == std::errc::value_too_large);
+}
+
+TEST_CASE("Stream operators keep the iostream output and read it back") {
+	auto const v = comp6771::euclidean_vector{1.0 / 3.0, 100, -0.5};
+	auto out = std::ostringstream();
+	out << v;
+	CHECK(out.str() == "[0.333333 100 -0.5]");
+
+	auto precise = std::ostringstream();
+	precise << std::setprecision(3) << std::fixed << v;
+	CHECK(precise.str() == "[0.333 100.000 -0.500]");
+
+	auto in = std::istringstream("  [1 2\n 3] [4] [oops]");
+	auto a = comp6771::euclidean_vector();
+	auto b = comp6771::euclidean_vector();
+	in >> a >> b;
+	CHECK(a == comp6771::euclidean_vector{1, 2, 3});
+	CHECK(b == comp6771::euclidean_vector{4});
+	in >> b;
+	CHECK(in.fail());
+	CHECK(b == comp6771::euclidean_vector{4});
+
+	auto const large = comp6771::euclidean_vector(5000, 0.25);
+	auto roundtrip = std::stringstream();
+	roundtrip << std::setprecision(17) << large;
+	auto back = comp6771::euclidean_vector();
+	roundtrip >> back;
+	CHECK(back == large);
+}
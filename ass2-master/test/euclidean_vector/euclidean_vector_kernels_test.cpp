@@ -0,0 +1,115 @@
+#include "comp6771/euclidean_vector_kernels.hpp"
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	std::vector<double> random_values(std::size_t n, unsigned seed) {
+		auto engine = std::mt19937_64(seed);
+		auto dist = std::uniform_real_distribution<double>(-100.0, 100.0);
+		auto v = std::vector<double>(n);
+		for (auto& x : v) {
+			x = dist(engine);
+		}
+		return v;
+	}
+} // namespace
+
+TEST_CASE("Every supported kernel set matches the scalar reference") {
+	using comp6771::kernels::isa;
+	auto const& reference = comp6771::kernels::table(isa::scalar);
+	auto const level = GENERATE(isa::sse2, isa::avx2, isa::avx512);
+	if (not comp6771::kernels::supported(level)) {
+		WARN(std::string(comp6771::kernels::name(level)) + " is not supported on this host; skipped");
+		return;
+	}
+	auto const& k = comp6771::kernels::table(level);
+	CHECK(k.level == level);
+
+	//Sizes straddle every unroll width and tail length.
+	auto const n = GENERATE(std::size_t{0}, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 64, 1000, 1023);
+	auto const x = random_values(n, 1);
+	auto const y = random_values(n, 2);
+
+	SECTION("dot, squared_norm and squared_distance") {
+		auto const scale = reference.dot(x.data(), x.data(), n) + reference.dot(y.data(), y.data(), n) + 1.0;
+		REQUIRE(std::abs(k.dot(x.data(), y.data(), n) - reference.dot(x.data(), y.data(), n)) < 1e-12 * scale);
+		REQUIRE(std::abs(k.squared_norm(x.data(), n) - reference.squared_norm(x.data(), n)) < 1e-12 * scale);
+		REQUIRE(std::abs(k.squared_distance(x.data(), y.data(), n) - reference.squared_distance(x.data(), y.data(), n))
+		        < 1e-12 * scale);
+	}
+
+	SECTION("manhattan, chebyshev and the fused dot") {
+		auto const scale = reference.dot(x.data(), x.data(), n) + reference.dot(y.data(), y.data(), n) + 1.0;
+		REQUIRE(std::abs(k.manhattan_distance(x.data(), y.data(), n) - reference.manhattan_distance(x.data(), y.data(), n))
+		        < 1e-12 * scale);
+		//A maximum has no rounding to differ in.
+		REQUIRE(k.chebyshev_distance(x.data(), y.data(), n) == reference.chebyshev_distance(x.data(), y.data(), n));
+		auto const fused = k.dot_and_squared_norms(x.data(), y.data(), n);
+		REQUIRE(std::abs(fused.xy - reference.dot(x.data(), y.data(), n)) < 1e-12 * scale);
+		REQUIRE(std::abs(fused.xx - reference.squared_norm(x.data(), n)) < 1e-12 * scale);
+		REQUIRE(std::abs(fused.yy - reference.squared_norm(y.data(), n)) < 1e-12 * scale);
+	}
+
+	SECTION("dot_tile") {
+		using comp6771::kernels::tile_columns;
+		using comp6771::kernels::tile_rows;
+		auto const a = random_values(n * tile_rows, 3);
+		auto const b = random_values(n * tile_columns, 4);
+		auto expected = random_values(tile_rows * tile_columns, 5);
+		auto actual = expected;
+		reference.dot_tile(a.data(), b.data(), n, expected.data());
+		k.dot_tile(a.data(), b.data(), n, actual.data());
+		for (std::size_t i = 0; i < expected.size(); ++i) {
+			//Products reach 10^4, so allow 10^-12 of that per step.
+			REQUIRE(std::abs(actual[i] - expected[i]) < 1e-8 * (static_cast<double>(n) + 1.0));
+		}
+	}
+
+	SECTION("elementwise kernels are exact") {
+		auto expected = x;
+		auto actual = x;
+		reference.add(expected.data(), y.data(), n);
+		k.add(actual.data(), y.data(), n);
+		REQUIRE(actual == expected);
+
+		reference.subtract(expected.data(), y.data(), n);
+		k.subtract(actual.data(), y.data(), n);
+		REQUIRE(actual == expected);
+
+		reference.multiply(expected.data(), -2.5, n);
+		k.multiply(actual.data(), -2.5, n);
+		REQUIRE(actual == expected);
+
+		reference.divide(expected.data(), 3.0, n);
+		k.divide(actual.data(), 3.0, n);
+		REQUIRE(actual == expected);
+	}
+}
+
+TEST_CASE("The active kernel set is the widest supported one") {
+	using comp6771::kernels::isa;
+	auto const level = comp6771::kernels::active().level;
+	CHECK(comp6771::kernels::supported(level));
+	for (auto const wider : {isa::sse2, isa::avx2, isa::avx512}) {
+		if (wider > level) {
+			CHECK_FALSE(comp6771::kernels::supported(wider));
+		}
+	}
+}
+
+TEST_CASE("euclidean_vector goes through the active kernels") {
+	auto const values = random_values(37, 3);
+	auto a = comp6771::euclidean_vector(values.begin(), values.end());
+	auto const b = a;
+	auto const& k = comp6771::kernels::active();
+	REQUIRE(comp6771::dot(a, b) == k.dot(values.data(), values.data(), values.size()));
+	REQUIRE(comp6771::euclidean_norm(a) == std::sqrt(k.squared_norm(values.data(), values.size())));
+	a *= 2;
+	a -= b;
+	REQUIRE(a == b);
+}
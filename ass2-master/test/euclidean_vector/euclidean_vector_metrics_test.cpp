@@ -0,0 +1,187 @@
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_metrics.hpp"
+#include "comp6771/sparse_euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//Built with COMP6771_EUCLIDEAN_VECTOR_METRICS=1 against euclidean_vector_counted.
+using comp6771::metrics::counter;
+
+TEST_CASE("Counting is compiled in") {
+	STATIC_REQUIRE(comp6771::metrics::enabled);
+}
+
+TEST_CASE("Allocations are counted") {
+	comp6771::metrics::reset_this_thread();
+
+	SECTION("inline vectors allocate nothing") {
+		auto const v = comp6771::euclidean_vector{1.0, 2.0};
+		CHECK(comp6771::metrics::this_thread()[counter::allocations] == 0);
+	}
+
+	SECTION("heap vectors allocate once") {
+		auto const v = comp6771::euclidean_vector(10, 1.0);
+		auto const counts = comp6771::metrics::this_thread();
+		CHECK(counts[counter::allocations] == 1);
+		CHECK(counts[counter::allocated_bytes] == 10 * sizeof(double));
+	}
+
+	SECTION("adopting a std::vector allocates nothing") {
+		auto const v = comp6771::euclidean_vector(std::vector<double>(10, 1.0));
+		CHECK(comp6771::metrics::this_thread()[counter::allocations] == 0);
+	}
+}
+
+TEST_CASE("Copies and moves are counted") {
+	auto v = comp6771::euclidean_vector(10, 1.0);
+	comp6771::metrics::reset_this_thread();
+
+	SECTION("a copy copies every magnitude") {
+		auto const copy = v;
+		auto const counts = comp6771::metrics::this_thread();
+		CHECK(counts[counter::copies] == 1);
+		CHECK(counts[counter::moves] == 0);
+		CHECK(counts[counter::allocations] == 1);
+		CHECK(counts[counter::copied_bytes] == 10 * sizeof(double));
+	}
+
+	SECTION("moving a heap vector copies nothing") {
+		auto const moved = std::move(v);
+		auto const counts = comp6771::metrics::this_thread();
+		CHECK(counts[counter::moves] == 1);
+		CHECK(counts[counter::copies] == 0);
+		CHECK(counts[counter::copied_bytes] == 0);
+	}
+
+	SECTION("moving an inline vector copies its magnitudes") {
+		auto small = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+		auto moved = comp6771::euclidean_vector{0.0};
+		moved = std::move(small);
+		auto const counts = comp6771::metrics::this_thread();
+		CHECK(counts[counter::moves] == 1);
+		CHECK(counts[counter::copied_bytes] == 3 * sizeof(double));
+	}
+
+	SECTION("conversions copy out") {
+		auto const magnitudes = static_cast<std::vector<double>>(v);
+		auto const as_float = comp6771::basic_euclidean_vector<float>(v);
+		auto const counts = comp6771::metrics::this_thread();
+		CHECK(counts[counter::copies] == 1);
+		CHECK(counts[counter::copied_bytes] == 20 * sizeof(double));
+	}
+}
+
+TEST_CASE("Cache use is counted") {
+	auto v = comp6771::euclidean_vector(10, 2.0);
+	comp6771::metrics::reset_this_thread();
+
+	SECTION("euclidean_norm") {
+		CHECK(comp6771::euclidean_norm(v) == Approx(std::sqrt(40.0)));
+		CHECK(comp6771::euclidean_norm(v) == Approx(std::sqrt(40.0)));
+		auto const counts = comp6771::metrics::this_thread();
+		CHECK(counts[counter::norm_cache_misses] == 1);
+		CHECK(counts[counter::norm_cache_hits] == 1);
+		CHECK(counts.norm_hit_rate() == 0.5);
+	}
+
+	SECTION("dot with itself") {
+		auto const other = v;
+		comp6771::dot(v, other);
+		comp6771::dot(v, v);
+		comp6771::dot(v, v);
+		comp6771::dot(v, v);
+		auto const counts = comp6771::metrics::this_thread();
+		CHECK(counts[counter::dot_cache_misses] == 1);
+		CHECK(counts[counter::dot_cache_hits] == 2);
+		CHECK(counts.dot_hit_rate() == Approx(2.0 / 3.0));
+	}
+
+	SECTION("only writes that discard a cached value invalidate") {
+		v[0] = 1.0;
+		CHECK(comp6771::metrics::this_thread()[counter::cache_invalidations] == 0);
+		comp6771::euclidean_norm(v);
+		v[0] = 2.0;
+		v[1] = 2.0;
+		CHECK(comp6771::metrics::this_thread()[counter::cache_invalidations] == 1);
+	}
+
+	SECTION("maintained norms survive writes") {
+		v.maintain_norm(true);
+		comp6771::euclidean_norm(v);
+		v.set(0, 3.0);
+		v *= 2.0;
+		comp6771::euclidean_norm(v);
+		auto const counts = comp6771::metrics::this_thread();
+		CHECK(counts[counter::cache_invalidations] == 0);
+		CHECK(counts[counter::norm_cache_hits] == 1);
+	}
+}
+
+TEST_CASE("Adding a sparse vector keeps a maintained norm") {
+	auto dense = comp6771::euclidean_vector(10, 2.0);
+	dense.maintain_norm(true);
+	comp6771::euclidean_norm(dense);
+	auto const sparse = comp6771::sparse_euclidean_vector(10, {{1, 3.0}, {7, -1.0}});
+	comp6771::metrics::reset_this_thread();
+
+	dense += sparse;
+	dense -= sparse;
+	CHECK(comp6771::euclidean_norm(dense) == Approx(std::sqrt(40.0)));
+	auto const counts = comp6771::metrics::this_thread();
+	CHECK(counts[counter::cache_invalidations] == 0);
+	CHECK(counts[counter::norm_cache_misses] == 0);
+	CHECK(counts[counter::norm_cache_hits] == 1);
+}
+
+TEST_CASE("Thrown errors are counted") {
+	auto const v = comp6771::euclidean_vector(3);
+	comp6771::metrics::reset_this_thread();
+	CHECK_THROWS_AS(v.at(3), comp6771::euclidean_vector_error);
+	CHECK_THROWS_AS(comp6771::dot(v, comp6771::euclidean_vector(2)), comp6771::euclidean_vector_error);
+	CHECK(comp6771::metrics::this_thread()[counter::errors] == 2);
+}
+
+TEST_CASE("Counters are per thread") {
+	comp6771::metrics::reset_this_thread();
+	auto const before = comp6771::metrics::all_threads();
+	auto worker = std::thread([] {
+		auto const v = comp6771::euclidean_vector(100, 1.0);
+		auto const copy = v;
+	});
+	worker.join();
+
+	CHECK(comp6771::metrics::this_thread()[counter::allocations] == 0);
+	auto const counted = comp6771::metrics::all_threads() - before;
+	CHECK(counted[counter::allocations] == 2);
+	CHECK(counted[counter::copies] == 1);
+}
+
+TEST_CASE("Resetting a thread doesn't take its counts out of all_threads") {
+	auto const v = comp6771::euclidean_vector(10, 1.0);
+	auto const before = comp6771::metrics::all_threads();
+	comp6771::metrics::reset_this_thread();
+	CHECK(comp6771::metrics::this_thread() == comp6771::metrics::snapshot{});
+	CHECK(comp6771::metrics::all_threads() == before);
+}
+
+TEST_CASE("Prometheus text format") {
+	auto counts = comp6771::metrics::snapshot{};
+	counts.values[static_cast<std::size_t>(counter::norm_cache_hits)] = 42;
+	auto os = std::ostringstream();
+	comp6771::metrics::write_prometheus(os, counts, "app");
+	auto const text = os.str();
+
+	CHECK(text.find("# HELP app_norm_cache_hits_total Norm reads answered by the cache.\n"
+	                "# TYPE app_norm_cache_hits_total counter\n"
+	                "app_norm_cache_hits_total 42\n") != std::string::npos);
+	CHECK(text.find("app_allocations_total 0\n") != std::string::npos);
+	//HELP, TYPE and a sample for each counter.
+	CHECK(std::count(text.begin(), text.end(), '\n') == 3 * comp6771::metrics::counter_count);
+	CHECK(comp6771::metrics::name(counter::errors) == "errors");
+}
@@ -0,0 +1,94 @@
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+	//A vector with the same magnitudes but nothing cached.
+	double fresh_norm(comp6771::euclidean_vector const& v) {
+		auto const magnitudes = static_cast<std::vector<double>>(v);
+		return comp6771::euclidean_norm(comp6771::euclidean_vector(magnitudes.begin(), magnitudes.end()));
+	}
+} // namespace
+
+TEST_CASE("set() is bounds-checked and works without tracking") {
+	auto v = comp6771::euclidean_vector{3.0, 4.0};
+	REQUIRE_FALSE(v.maintains_norm());
+	REQUIRE(comp6771::euclidean_norm(v) == Approx(5.0));
+	v.set(1, 0.0);
+	CHECK(v[1] == 0.0);
+	CHECK(comp6771::euclidean_norm(v) == Approx(3.0));
+	CHECK_THROWS_WITH(v.set(2, 1.0), "Index 2 is not valid for this euclidean_vector object");
+	CHECK_THROWS_WITH(v.set(-1, 1.0), "Index -1 is not valid for this euclidean_vector object");
+}
+
+TEST_CASE("Tracked vectors keep their cached norm and dot current") {
+	auto v = comp6771::euclidean_vector{3.0, 4.0, 12.0};
+	v.maintain_norm(true);
+	REQUIRE(comp6771::euclidean_norm(v) == Approx(13.0));
+	REQUIRE(comp6771::dot(v, v) == Approx(169.0));
+
+	v.set(2, 0.0);
+	CHECK(comp6771::euclidean_norm(v) == Approx(5.0));
+	CHECK(comp6771::dot(v, v) == Approx(25.0));
+
+	v *= -2;
+	CHECK(comp6771::euclidean_norm(v) == Approx(10.0));
+	CHECK(comp6771::dot(v, v) == Approx(100.0));
+
+	v /= 4;
+	CHECK(comp6771::euclidean_norm(v) == Approx(2.5));
+	//unit() reads the cached norm directly, so it sees the adjusted value.
+	CHECK(comp6771::unit(v) == comp6771::euclidean_vector{-0.6, -0.8, 0.0});
+
+	v[0] = 1.0;
+	CHECK(comp6771::euclidean_norm(v) == Approx(std::sqrt(1.0 + 4.0)));
+}
+
+TEST_CASE("Tracked updates stay close to a full recompute") {
+	auto v = comp6771::euclidean_vector(10000);
+	for (auto i = 0; i < v.dimensions(); ++i) {
+		v[i] = std::sin(i * 0.3);
+	}
+	v.maintain_norm(true);
+	(void)comp6771::euclidean_norm(v);
+	for (auto step = 0; step < 500; ++step) {
+		v.set((step * 37) % v.dimensions(), std::cos(step * 0.11) * 3.0);
+		REQUIRE(comp6771::euclidean_norm(v) == Approx(fresh_norm(v)).epsilon(1e-12));
+	}
+}
+
+TEST_CASE("The cache is refreshed every norm_refresh_interval updates") {
+	auto v = comp6771::euclidean_vector(100, 0.5);
+	v.maintain_norm(true);
+	(void)comp6771::euclidean_norm(v);
+	for (std::uint32_t i = 1; i < comp6771::euclidean_vector::norm_refresh_interval; ++i) {
+		v.set(static_cast<int>(i % 100), 0.5 + 1e-3 * i);
+	}
+	v.set(0, 0.25);
+	//That was the interval-th update, so this read is a full pass.
+	CHECK(comp6771::euclidean_norm(v) == fresh_norm(v));
+}
+
+TEST_CASE("Cancellation falls back to a recompute") {
+	auto v = comp6771::euclidean_vector{1e8, 1.0};
+	v.maintain_norm(true);
+	(void)comp6771::euclidean_norm(v);
+	v.set(0, 0.0);
+	CHECK(comp6771::euclidean_norm(v) == 1.0);
+}
+
+TEST_CASE("Copies inherit tracking, assignment keeps the target's") {
+	auto v = comp6771::euclidean_vector{1.0, 2.0};
+	v.maintain_norm(true);
+	auto const copy = v;
+	CHECK(copy.maintains_norm());
+	auto const moved = std::move(v);
+	CHECK(moved.maintains_norm());
+
+	auto w = comp6771::euclidean_vector{3.0};
+	w = copy;
+	CHECK_FALSE(w.maintains_norm());
+}
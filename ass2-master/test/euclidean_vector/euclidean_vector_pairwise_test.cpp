@@ -0,0 +1,120 @@
+#include "comp6771/euclidean_vector_pairwise.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include "test_vectors.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using comp6771::test::random_vectors;
+
+namespace {
+	struct parallel_settings {
+		~parallel_settings() {
+			comp6771::parallel::set_thread_count(1);
+		}
+	};
+
+	void check_results(comp6771::euclidean_vector_batch const& actual, std::vector<comp6771::euclidean_vector> const& x,
+	                   std::vector<comp6771::euclidean_vector> const& y, double (*expected)(comp6771::euclidean_vector const&,
+	                                                                                        comp6771::euclidean_vector const&)) {
+		REQUIRE(actual.rows() == static_cast<int>(x.size()));
+		REQUIRE(actual.dimensions() == static_cast<int>(y.size()));
+		REQUIRE(actual.layout() == comp6771::batch_layout::row_major);
+		for (std::size_t i = 0; i < x.size(); ++i) {
+			for (std::size_t j = 0; j < y.size(); ++j) {
+				REQUIRE(actual[static_cast<int>(i)][static_cast<int>(j)] == Approx(expected(x[i], y[j])).margin(1e-9));
+			}
+		}
+	}
+
+	double dot(comp6771::euclidean_vector const& a, comp6771::euclidean_vector const& b) {
+		return comp6771::dot(a, b);
+	}
+
+	double squared_distance(comp6771::euclidean_vector const& a, comp6771::euclidean_vector const& b) {
+		return comp6771::squared_distance(a, b);
+	}
+
+	double distance(comp6771::euclidean_vector const& a, comp6771::euclidean_vector const& b) {
+		return comp6771::euclidean_distance(a, b);
+	}
+} // namespace
+
+TEST_CASE("pairwise results match one call per pair") {
+	//Counts and dimensions straddle the tile, block and depth sizes.
+	auto const m = GENERATE(1, 3, 4, 5, 67);
+	auto const n = GENERATE(1, 7, 8, 9, 263);
+	auto const dimensions = GENERATE(1, 5, 300);
+	auto const x = random_vectors(m, dimensions, 1);
+	auto const y = random_vectors(n, dimensions, 2);
+
+	check_results(comp6771::pairwise_dot(x, y), x, y, dot);
+	check_results(comp6771::pairwise_squared_distance(x, y), x, y, squared_distance);
+	check_results(comp6771::pairwise_distance(x, y), x, y, distance);
+
+	auto const layout = GENERATE(comp6771::batch_layout::row_major, comp6771::batch_layout::column_major);
+	auto const bx = comp6771::euclidean_vector_batch(x, layout);
+	auto const by = comp6771::euclidean_vector_batch(y, layout);
+	check_results(comp6771::pairwise_dot(bx, by), x, y, dot);
+	check_results(comp6771::pairwise_squared_distance(bx, by), x, y, squared_distance);
+	check_results(comp6771::pairwise_distance(bx, by), x, y, distance);
+}
+
+TEST_CASE("pairwise distances of a set with itself are zero on the diagonal") {
+	auto const x = random_vectors(20, 16, 3);
+	auto const distances = comp6771::pairwise_distance(x, x);
+	for (auto i = 0; i < distances.rows(); ++i) {
+		CHECK(distances[i][i] == Approx(0.0).margin(1e-6));
+		CHECK(distances[i][(i + 1) % 20] > 0.0);
+	}
+}
+
+TEST_CASE("pairwise results do not depend on the thread count") {
+	auto const settings = parallel_settings{};
+	auto const x = random_vectors(150, 40, 4);
+	auto const y = random_vectors(600, 40, 5);
+	auto const serial = comp6771::pairwise_squared_distance(x, y);
+	comp6771::parallel::set_thread_count(4);
+	CHECK(comp6771::pairwise_squared_distance(x, y) == serial);
+}
+
+TEST_CASE("pairwise distances use whichever norm a vector has cached") {
+	auto const x = random_vectors(9, 12, 10);
+	auto const y = random_vectors(5, 12, 11);
+	auto const uncached = comp6771::pairwise_squared_distance(x, y);
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		if (i % 3 == 0) {
+			comp6771::euclidean_norm(x[i]);
+		} else if (i % 3 == 1) {
+			comp6771::dot(x[i], x[i]);
+		}
+	}
+	auto const cached = comp6771::pairwise_squared_distance(x, y);
+	for (auto i = 0; i < cached.rows(); ++i) {
+		for (auto j = 0; j < cached.dimensions(); ++j) {
+			CHECK(cached[i][j] == Approx(uncached[i][j]));
+		}
+	}
+}
+
+TEST_CASE("pairwise of an empty set is empty") {
+	auto const x = random_vectors(3, 4, 6);
+	auto const none = std::vector<comp6771::euclidean_vector>();
+	auto const result = comp6771::pairwise_dot(x, none);
+	CHECK(result.rows() == 3);
+	CHECK(result.dimensions() == 0);
+	CHECK(comp6771::pairwise_distance(none, x).rows() == 0);
+}
+
+TEST_CASE("pairwise errors") {
+	auto const x = random_vectors(3, 4, 7);
+	auto const y = random_vectors(3, 5, 8);
+	CHECK_THROWS_WITH(comp6771::pairwise_dot(x, y), "Dimensions of LHS(4) and RHS(5) do not match");
+	CHECK_THROWS_WITH(comp6771::pairwise_distance(comp6771::euclidean_vector_batch(x), comp6771::euclidean_vector_batch(y)),
+	                  "Dimensions of LHS(4) and RHS(5) do not match");
+
+	auto mixed = random_vectors(3, 4, 9);
+	mixed.push_back(comp6771::euclidean_vector(2));
+	CHECK_THROWS_WITH(comp6771::pairwise_squared_distance(x, mixed), "Dimensions of LHS(4) and RHS(2) do not match");
+}
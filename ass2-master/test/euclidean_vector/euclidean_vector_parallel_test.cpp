@@ -0,0 +1,138 @@
+#include "comp6771/euclidean_vector.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	//Restores the process-wide settings when a test case ends.
+	struct parallel_settings {
+		~parallel_settings() {
+			comp6771::parallel::set_thread_count(1);
+			comp6771::parallel::set_threshold(std::size_t{1} << 20);
+		}
+	};
+
+	//Several blocks plus a ragged tail, with values spread widely enough that summation order
+	//shows up in the low bits.
+	comp6771::euclidean_vector make_vector(double const seed) {
+		auto const n = static_cast<int>(5 * comp6771::parallel::block_size + 123);
+		auto v = comp6771::euclidean_vector(n);
+		for (auto i = 0; i < n; ++i) {
+			v[i] = std::sin(seed * i) * std::exp(std::fmod(i * 0.37, 9.0));
+		}
+		return v;
+	}
+} // namespace
+
+TEST_CASE("Parallel execution is off by default") {
+	CHECK(comp6771::parallel::thread_count() == 1);
+	CHECK(comp6771::parallel::threshold() == std::size_t{1} << 20);
+}
+
+TEST_CASE("Reductions are bit-identical for any thread count") {
+	auto const settings = parallel_settings();
+	comp6771::parallel::set_threshold(0);
+	auto const x = make_vector(0.1);
+	auto const y = make_vector(0.7);
+	auto const n = static_cast<std::size_t>(x.dimensions());
+	auto const xs = static_cast<std::vector<double>>(x);
+	auto const ys = static_cast<std::vector<double>>(y);
+
+	comp6771::parallel::set_thread_count(1);
+	auto const dot1 = comp6771::parallel::dot(xs.data(), ys.data(), n);
+	auto const norm1 = comp6771::parallel::squared_norm(xs.data(), n);
+
+	auto naive = 0.0;
+	for (std::size_t i = 0; i < n; ++i) {
+		naive += xs[i] * ys[i];
+	}
+	CHECK(dot1 == Approx(naive));
+
+	auto const threads = GENERATE(2U, 3U, 4U, 7U);
+	comp6771::parallel::set_thread_count(threads);
+	REQUIRE(comp6771::parallel::thread_count() == threads);
+	for (auto run = 0; run < 3; ++run) {
+		CHECK(comp6771::parallel::dot(xs.data(), ys.data(), n) == dot1);
+		CHECK(comp6771::parallel::squared_norm(xs.data(), n) == norm1);
+	}
+	CHECK(comp6771::dot(x, y) == dot1);
+	CHECK(comp6771::euclidean_norm(x) == std::sqrt(norm1));
+}
+
+TEST_CASE("Parallel elementwise operators match the serial ones") {
+	auto const settings = parallel_settings();
+	auto const x = make_vector(0.3);
+	auto const y = make_vector(1.1);
+
+	comp6771::parallel::set_thread_count(1);
+	auto serial = x;
+	serial += y;
+	serial *= 2.5;
+	serial -= x;
+	serial /= 3;
+
+	comp6771::parallel::set_threshold(0);
+	comp6771::parallel::set_thread_count(4);
+	auto parallel = x;
+	parallel += y;
+	parallel *= 2.5;
+	parallel -= x;
+	parallel /= 3;
+
+	CHECK(static_cast<std::vector<double>>(parallel) == static_cast<std::vector<double>>(serial));
+}
+
+TEST_CASE("Vectors below the threshold or a single block ignore the pool") {
+	auto const settings = parallel_settings();
+	comp6771::parallel::set_thread_count(4);
+	auto const a = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+	auto const b = comp6771::euclidean_vector{4.0, 5.0, 6.0};
+	CHECK(comp6771::dot(a, b) == Approx(32.0));
+	comp6771::parallel::set_threshold(0);
+	CHECK(comp6771::dot(a, b) == Approx(32.0));
+}
+
+TEST_CASE("A throwing job reaches the caller and leaves the pool usable") {
+	auto const settings = parallel_settings();
+	comp6771::parallel::set_thread_count(4);
+	auto const throw_at = GENERATE(std::size_t{0}, std::size_t{57}, std::size_t{199});
+	auto started = std::atomic<std::size_t>(0);
+	CHECK_THROWS_AS(comp6771::parallel::run(200, [&](std::size_t const i) {
+		started.fetch_add(1, std::memory_order_relaxed);
+		if (i == throw_at) {
+			throw std::runtime_error("job failed");
+		}
+	}), std::runtime_error);
+	CHECK(started.load() <= 200);
+
+	auto done = std::atomic<std::size_t>(0);
+	comp6771::parallel::run(100, [&](std::size_t) { done.fetch_add(1, std::memory_order_relaxed); });
+	CHECK(done.load() == 100);
+}
+
+TEST_CASE("Jobs may reach the pool again") {
+	auto const settings = parallel_settings();
+	comp6771::parallel::set_thread_count(4);
+	comp6771::parallel::set_threshold(0);
+	auto const x = make_vector(0.3);
+	auto const expected = comp6771::dot(x, x);
+
+	auto results = std::vector<double>(8);
+	comp6771::parallel::run(results.size(), [&](std::size_t const i) {
+		auto const copy = x;
+		results[i] = comp6771::dot(copy, copy);
+	});
+	for (auto const r : results) {
+		CHECK(r == expected);
+	}
+
+	auto inner = std::atomic<std::size_t>(0);
+	comp6771::parallel::run(4, [&](std::size_t) {
+		comp6771::parallel::run(5, [&](std::size_t) { inner.fetch_add(1, std::memory_order_relaxed); });
+	});
+	CHECK(inner.load() == 20);
+}
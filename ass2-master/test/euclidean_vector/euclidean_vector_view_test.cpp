@@ -0,0 +1,62 @@
+#include "comp6771/euclidean_vector_view.hpp"
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <vector>
+
+TEST_CASE("Views read external magnitudes without copying them") {
+	auto buffer = std::vector<double>{3, 4, 12};
+	auto const view = comp6771::const_euclidean_vector_view(buffer);
+	CHECK(view.data() == buffer.data());
+	CHECK(view.dimensions() == 3);
+	CHECK(view.at(2) == 12);
+	CHECK_THROWS_WITH(view.at(3), "Index 3 is not valid for this euclidean_vector object");
+
+	CHECK(comp6771::euclidean_norm(view) == Approx(13));
+	CHECK(comp6771::dot(view, view) == Approx(169));
+	buffer[2] = 0;
+	CHECK(comp6771::euclidean_norm(view) == Approx(5));
+
+	auto os = std::ostringstream();
+	os << view;
+	CHECK(os.str() == "[3 4 0]");
+}
+
+TEST_CASE("Views and owners mix in comparisons, dot and arithmetic") {
+	auto buffer = std::vector<double>{1, 2, 3};
+	auto const view = comp6771::euclidean_vector_view(buffer);
+	auto const owner = comp6771::euclidean_vector{1, 2, 3};
+
+	CHECK(view == owner);
+	CHECK(owner == view);
+	CHECK_FALSE(view != owner);
+	CHECK(comp6771::dot(owner, view) == Approx(14));
+
+	auto const sum = comp6771::euclidean_vector(view + owner * 2);
+	CHECK(sum == comp6771::euclidean_vector{3, 6, 9});
+	comp6771::euclidean_vector const diff = owner - view;
+	CHECK(diff == comp6771::euclidean_vector(3));
+	CHECK(static_cast<comp6771::euclidean_vector>(view) == owner);
+	CHECK(view + view == owner * 2);
+
+	auto moved = comp6771::euclidean_vector{10, 10, 10};
+	moved += view;
+	CHECK(moved == comp6771::euclidean_vector{11, 12, 13});
+	CHECK_THROWS_WITH(moved -= comp6771::const_euclidean_vector_view(), "Dimensions of LHS(3) and RHS(0) do not match");
+}
+
+TEST_CASE("Compound assignment writes through a view") {
+	auto buffer = std::vector<double>{1, 2, 3, 4, 5};
+	auto const view = comp6771::euclidean_vector_view(buffer);
+	auto const other = comp6771::euclidean_vector{1, 1, 1, 1, 1};
+
+	view += other;
+	view *= 2;
+	view -= comp6771::const_euclidean_vector_view(other);
+	view /= 3;
+	CHECK(view == comp6771::euclidean_vector{1, 5.0 / 3, 7.0 / 3, 3, 11.0 / 3});
+
+	view -= view - other;
+	CHECK(view == other);
+	CHECK_THROWS_WITH(view += comp6771::euclidean_vector(2), "Dimensions of LHS(5) and RHS(2) do not match");
+	CHECK_THROWS_WITH(view /= 0, "Invalid vector division by 0");
+}
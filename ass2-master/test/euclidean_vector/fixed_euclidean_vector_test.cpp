@@ -0,0 +1,68 @@
+#include "comp6771/fixed_euclidean_vector.hpp"
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <sstream>
+
+namespace {
+	template<typename A, typename B>
+	concept addable = requires(A a, B b) { a + b; };
+} // namespace
+
+TEST_CASE("fixed_euclidean_vector arithmetic is constexpr") {
+	constexpr auto a = comp6771::fixed_euclidean_vector{1.0, 2.0, 3.0};
+	constexpr auto b = comp6771::fixed_euclidean_vector{3.0, 2.0, 1.0};
+
+	STATIC_REQUIRE(a.dimensions() == 3);
+	STATIC_REQUIRE(a + b == comp6771::fixed_euclidean_vector{4.0, 4.0, 4.0});
+	STATIC_REQUIRE(a - b == comp6771::fixed_euclidean_vector{-2.0, 0.0, 2.0});
+	STATIC_REQUIRE(2.0 * a / 4.0 == comp6771::fixed_euclidean_vector{0.5, 1.0, 1.5});
+	STATIC_REQUIRE(-a == comp6771::fixed_euclidean_vector{-1.0, -2.0, -3.0});
+	STATIC_REQUIRE(a != b);
+	STATIC_REQUIRE(comp6771::dot(a, b) == 10.0);
+	STATIC_REQUIRE(comp6771::euclidean_norm(comp6771::fixed_euclidean_vector{3.0, 4.0}) == 5.0);
+	STATIC_REQUIRE(comp6771::unit(comp6771::fixed_euclidean_vector{0.0, 2.0}) == comp6771::fixed_euclidean_vector{0.0, 1.0});
+	STATIC_REQUIRE(a.at(2) == 3.0);
+}
+
+TEST_CASE("The constexpr square root agrees with std::sqrt") {
+	for (auto const x : {0.0, 1e-300, 0.25, 2.0, 3.0, 1e10, 12345.678}) {
+		REQUIRE(comp6771::euclidean_norm(comp6771::fixed_euclidean_vector{x}) == Approx(std::sqrt(x * x)));
+	}
+	constexpr auto root2 = comp6771::detail::constexpr_sqrt(2.0);
+	REQUIRE(root2 == Approx(std::sqrt(2.0)).epsilon(1e-15));
+}
+
+TEST_CASE("Mixing dimensions does not compile") {
+	STATIC_REQUIRE(addable<comp6771::fixed_euclidean_vector<3>, comp6771::fixed_euclidean_vector<3>>);
+	STATIC_REQUIRE_FALSE(addable<comp6771::fixed_euclidean_vector<3>, comp6771::fixed_euclidean_vector<2>>);
+	STATIC_REQUIRE_FALSE(std::is_constructible_v<comp6771::fixed_euclidean_vector<3>, double, double>);
+}
+
+TEST_CASE("fixed_euclidean_vector keeps the runtime checks it cannot move to compile time") {
+	auto a = comp6771::fixed_euclidean_vector{1.0, 2.0};
+	REQUIRE_THROWS_WITH(a.at(2), "Index 2 is not valid for this euclidean_vector object");
+	REQUIRE_THROWS_WITH(a / 0, "Invalid vector division by 0");
+	REQUIRE_THROWS_AS(comp6771::unit(comp6771::fixed_euclidean_vector<2>{}), comp6771::euclidean_vector_error);
+	a.at(0) = 5;
+	REQUIRE(a[0] == 5);
+}
+
+TEST_CASE("Converting between fixed and dynamic vectors") {
+	auto const dynamic = comp6771::euclidean_vector{1, 2, 3};
+	auto const fixed = comp6771::fixed_euclidean_vector<3>(dynamic);
+	REQUIRE(fixed == comp6771::fixed_euclidean_vector{1.0, 2.0, 3.0});
+	REQUIRE(static_cast<comp6771::euclidean_vector>(fixed) == dynamic);
+	REQUIRE_THROWS_WITH(comp6771::fixed_euclidean_vector<2>(dynamic), "Dimensions of LHS(2) and RHS(3) do not match");
+
+	auto const large = comp6771::euclidean_vector(32, 1.5);
+	auto const fixed_large = comp6771::fixed_euclidean_vector<32>(large);
+	REQUIRE(comp6771::dot(fixed_large, fixed_large) == Approx(comp6771::dot(large, large)));
+	REQUIRE(static_cast<comp6771::euclidean_vector>(fixed_large * 2) == large * 2);
+}
+
+TEST_CASE("fixed_euclidean_vector prints like euclidean_vector") {
+	auto oss = std::ostringstream{};
+	oss << comp6771::fixed_euclidean_vector{9.0, 9.0, 9.0} << comp6771::fixed_euclidean_vector<0>{};
+	CHECK(oss.str() == "[9 9 9][]");
+}
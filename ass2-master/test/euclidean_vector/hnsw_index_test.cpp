@@ -0,0 +1,168 @@
+#include "comp6771/hnsw_index.hpp"
+#include "comp6771/knn_index.hpp"
+#include "test_vectors.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using comp6771::test::random_vectors;
+
+namespace {
+	//Fraction of the exact top k that the approximate search found.
+	double recall(comp6771::hnsw_index const& index, comp6771::knn_index const& exact,
+	              std::vector<comp6771::euclidean_vector> const& queries, int const k) {
+		auto hits = 0;
+		for (auto const& query : queries) {
+			auto const expected = exact.search(query, k);
+			auto const actual = index.search(query, k);
+			for (auto const& e : expected) {
+				hits += std::any_of(actual.begin(), actual.end(), [&](auto const& a) { return a.index == e.index; });
+			}
+		}
+		return static_cast<double>(hits) / static_cast<double>(queries.size() * static_cast<std::size_t>(k));
+	}
+} // namespace
+
+TEST_CASE("HNSW search recalls the exact neighbours") {
+	auto const metric = GENERATE(comp6771::distance_metric::l2, comp6771::distance_metric::inner_product,
+	                             comp6771::distance_metric::cosine);
+	auto const vectors = random_vectors(2000, 16, 1, std::normal_distribution<double>());
+	auto const queries = random_vectors(50, 16, 2, std::normal_distribution<double>());
+	auto index = comp6771::hnsw_index(16, metric, {.m = 12, .ef_construction = 100, .ef_search = 100});
+	index.insert(vectors);
+	REQUIRE(index.size() == 2000);
+	auto const exact = comp6771::knn_index(vectors, metric);
+
+	CHECK(recall(index, exact, queries, 10) >= 0.9);
+	index.set_ef_search(400);
+	CHECK(recall(index, exact, queries, 10) >= 0.97);
+
+	auto const found = index.search(queries[0], 10);
+	auto const expected = exact.search(queries[0], 10);
+	REQUIRE(found.size() == 10);
+	CHECK(std::is_sorted(found.begin(), found.end(), [&](auto const& a, auto const& b) {
+		return metric == comp6771::distance_metric::l2 ? a.score < b.score : a.score > b.score;
+	}));
+	CHECK(found[0].score == Approx(expected[0].score));
+}
+
+TEST_CASE("HNSW indexes grow incrementally and search concurrently") {
+	auto const vectors = random_vectors(1500, 8, 3, std::normal_distribution<double>());
+	auto index = comp6771::hnsw_index(8);
+	CHECK(index.search(vectors[0], 5).empty());
+	for (auto i = 0; i < 500; ++i) {
+		CHECK(index.insert(vectors[static_cast<std::size_t>(i)]) == i);
+	}
+	CHECK(index[7] == vectors[7]);
+
+	//Readers search while the writer inserts the rest; every vector already in must find itself.
+	auto writer = std::thread([&] {
+		for (auto i = 500; i < 1500; ++i) {
+			index.insert(vectors[static_cast<std::size_t>(i)]);
+		}
+	});
+	auto readers = std::vector<std::thread>();
+	auto misses = std::vector<int>(4);
+	for (auto t = 0; t < 4; ++t) {
+		readers.emplace_back([&, t] {
+			for (auto i = t; i < 500; i += 4) {
+				misses[static_cast<std::size_t>(t)] += index.search(vectors[static_cast<std::size_t>(i)], 1).at(0).index != i;
+			}
+		});
+	}
+	writer.join();
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	CHECK(index.size() == 1500);
+	CHECK(misses == std::vector<int>(4));
+	CHECK_THROWS_WITH(index.insert(comp6771::euclidean_vector(3)), "Dimensions of LHS(8) and RHS(3) do not match");
+}
+
+TEST_CASE("A saved HNSW index loads back and searches identically") {
+	auto const vectors = random_vectors(800, 12, 4, std::normal_distribution<double>());
+	auto const queries = random_vectors(20, 12, 5, std::normal_distribution<double>());
+	auto index = comp6771::hnsw_index(12, comp6771::distance_metric::cosine, {.m = 8, .ef_construction = 64});
+	index.insert(vectors);
+	auto const path = std::filesystem::temp_directory_path() / "comp6771_hnsw_test.hnsw";
+	index.save(path);
+
+	auto loaded = comp6771::hnsw_index::load(path);
+	CHECK(loaded.size() == index.size());
+	CHECK(loaded.metric() == comp6771::distance_metric::cosine);
+	CHECK(loaded.parameters().m == 8);
+	for (auto const& query : queries) {
+		CHECK(loaded.search(query, 10) == index.search(query, 10));
+	}
+	//The level generator is restored too, so later inserts build the same graph.
+	auto const extra = random_vectors(50, 12, 6, std::normal_distribution<double>());
+	index.insert(extra);
+	loaded.insert(extra);
+	CHECK(loaded.search(queries[0], 10) == index.search(queries[0], 10));
+
+	std::filesystem::resize_file(path, 200);
+	CHECK_THROWS_WITH(comp6771::hnsw_index::load(path), path.string() + " is truncated or has a malformed header");
+	std::ofstream(path, std::ios::binary) << std::string(256, 'x');
+	CHECK_THROWS_WITH(comp6771::hnsw_index::load(path), path.string() + " is not an hnsw_index file");
+	std::filesystem::remove(path);
+	CHECK_THROWS_AS(comp6771::hnsw_index::load(path), std::system_error);
+}
+
+TEST_CASE("A rejected insert leaves the index as it was") {
+	auto const vectors = random_vectors(300, 8, 7, std::normal_distribution<double>());
+	auto const queries = random_vectors(10, 8, 8, std::normal_distribution<double>());
+	auto fresh = comp6771::hnsw_index(8, comp6771::distance_metric::cosine, {.m = 6, .ef_construction = 32});
+	auto rejected = comp6771::hnsw_index(8, comp6771::distance_metric::cosine, {.m = 6, .ef_construction = 32});
+	CHECK_THROWS_WITH(rejected.insert(comp6771::euclidean_vector(8)),
+	                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+	CHECK(rejected.size() == 0);
+
+	fresh.insert(vectors);
+	rejected.insert(vectors);
+	for (auto const& query : queries) {
+		CHECK(rejected.search(query, 10) == fresh.search(query, 10));
+	}
+	//Saved files hold every level and link, so they match only if the graphs do.
+	auto const directory = std::filesystem::temp_directory_path();
+	fresh.save(directory / "comp6771_hnsw_test_fresh.hnsw");
+	rejected.save(directory / "comp6771_hnsw_test_rejected.hnsw");
+	auto const contents = [](std::filesystem::path const& path) {
+		auto in = std::ifstream(path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(in), {});
+	};
+	CHECK(contents(directory / "comp6771_hnsw_test_rejected.hnsw") == contents(directory / "comp6771_hnsw_test_fresh.hnsw"));
+	std::filesystem::remove(directory / "comp6771_hnsw_test_fresh.hnsw");
+	std::filesystem::remove(directory / "comp6771_hnsw_test_rejected.hnsw");
+}
+
+TEST_CASE("Cosine HNSW accepts vectors with a tiny but nonzero norm") {
+	auto index = comp6771::hnsw_index(4, comp6771::distance_metric::cosine);
+	index.insert(random_vectors(20, 4, 10, std::normal_distribution<double>()));
+	auto const tiny = index.insert(comp6771::euclidean_vector{3e-5, 4e-5, 0, 0});
+	auto const found = index.search(comp6771::euclidean_vector{3e-7, 4e-7, 0, 0}, 1);
+	REQUIRE(found.size() == 1);
+	CHECK(found[0].index == tiny);
+}
+
+TEST_CASE("Moving an HNSW index between memory resources copies it") {
+	auto const vectors = random_vectors(100, 4, 9, std::normal_distribution<double>());
+	auto resource = std::pmr::monotonic_buffer_resource();
+	auto source = comp6771::hnsw_index(4, comp6771::distance_metric::l2, {}, &resource);
+	source.insert(vectors);
+	auto const expected = source.search(vectors[0], 5);
+
+	auto target = comp6771::hnsw_index(4);
+	STATIC_REQUIRE_FALSE(std::is_nothrow_move_assignable_v<comp6771::hnsw_index>);
+	target = std::move(source);
+	CHECK(target.size() == 100);
+	CHECK(target.search(vectors[0], 5) == expected);
+}
@@ -0,0 +1,165 @@
+#include "comp6771/kmeans.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+	struct parallel_settings {
+		~parallel_settings() {
+			comp6771::parallel::set_thread_count(1);
+		}
+	};
+
+	//`per_cluster` points around each of `centres` well separated centres, listed cluster by cluster.
+	std::vector<comp6771::euclidean_vector> blobs(int const centres, int const per_cluster, int const dimensions,
+	                                              unsigned const seed) {
+		auto engine = std::mt19937(seed);
+		auto noise = std::normal_distribution<double>(0.0, 0.1);
+		auto result = std::vector<comp6771::euclidean_vector>();
+		for (auto c = 0; c < centres; ++c) {
+			for (auto i = 0; i < per_cluster; ++i) {
+				auto v = comp6771::euclidean_vector(dimensions);
+				for (auto d = 0; d < dimensions; ++d) {
+					v[d] = (d == c % dimensions ? 10.0 * (c / dimensions + 1) : 0.0) + noise(engine);
+				}
+				result.push_back(std::move(v));
+			}
+		}
+		return result;
+	}
+
+	//Whether every blob landed in a cluster of its own.
+	bool recovers_blobs(comp6771::kmeans_result const& result, int const centres, int const per_cluster) {
+		auto labels = std::set<int>();
+		for (auto c = 0; c < centres; ++c) {
+			auto const label = result.assignments[static_cast<std::size_t>(c * per_cluster)];
+			for (auto i = 0; i < per_cluster; ++i) {
+				if (result.assignments[static_cast<std::size_t>(c * per_cluster + i)] != label) {
+					return false;
+				}
+			}
+			labels.insert(label);
+		}
+		return static_cast<int>(labels.size()) == centres;
+	}
+
+	double inertia(std::vector<comp6771::euclidean_vector> const& points, comp6771::kmeans_result const& result) {
+		auto total = 0.0;
+		for (std::size_t i = 0; i < points.size(); ++i) {
+			total += comp6771::squared_distance(points[i], result.centroids[static_cast<std::size_t>(result.assignments[i])]);
+		}
+		return total;
+	}
+} // namespace
+
+TEST_CASE("kmeans recovers well separated clusters") {
+	auto const points = blobs(6, 200, 4, 1);
+	auto parameters = comp6771::kmeans_parameters{};
+	parameters.algorithm = GENERATE(comp6771::kmeans_algorithm::lloyd, comp6771::kmeans_algorithm::hamerly,
+	                                comp6771::kmeans_algorithm::elkan, comp6771::kmeans_algorithm::mini_batch);
+	parameters.batch_size = 256;
+	auto const result = comp6771::kmeans(points, 6, parameters);
+
+	REQUIRE(result.centroids.size() == 6);
+	REQUIRE(result.assignments.size() == points.size());
+	CHECK(recovers_blobs(result, 6, 200));
+	CHECK(result.inertia == Approx(inertia(points, result)));
+	for (auto const& centroid : result.centroids) {
+		CHECK(centroid.dimensions() == 4);
+	}
+	if (parameters.algorithm != comp6771::kmeans_algorithm::mini_batch) {
+		CHECK(result.converged);
+	}
+}
+
+TEST_CASE("Pruned algorithms reproduce Lloyd's iterations") {
+	//Overlapping clusters, so points do change hands between iterations.
+	auto engine = std::mt19937(2);
+	auto uniform = std::uniform_real_distribution<double>(-1.0, 1.0);
+	auto points = std::vector<comp6771::euclidean_vector>();
+	for (auto i = 0; i < 3000; ++i) {
+		auto v = comp6771::euclidean_vector(3);
+		for (auto d = 0; d < 3; ++d) {
+			v[d] = uniform(engine);
+		}
+		points.push_back(std::move(v));
+	}
+	auto parameters = comp6771::kmeans_parameters{};
+	parameters.init = GENERATE(comp6771::kmeans_init::kmeans_plus_plus, comp6771::kmeans_init::random);
+	parameters.max_iterations = 30;
+	parameters.algorithm = comp6771::kmeans_algorithm::lloyd;
+	auto const lloyd = comp6771::kmeans(points, 12, parameters);
+
+	parameters.algorithm = GENERATE(comp6771::kmeans_algorithm::hamerly, comp6771::kmeans_algorithm::elkan);
+	auto const pruned = comp6771::kmeans(points, 12, parameters);
+	CHECK(pruned.iterations == lloyd.iterations);
+	CHECK(pruned.assignments == lloyd.assignments);
+	CHECK(pruned.inertia == Approx(lloyd.inertia));
+}
+
+TEST_CASE("kmeans is reproducible and independent of the thread count") {
+	auto const settings = parallel_settings{};
+	auto const points = blobs(5, 2000, 3, 3);
+	auto parameters = comp6771::kmeans_parameters{};
+	parameters.algorithm = GENERATE(comp6771::kmeans_algorithm::lloyd, comp6771::kmeans_algorithm::mini_batch);
+	auto const serial = comp6771::kmeans(points, 5, parameters);
+	CHECK(comp6771::kmeans(points, 5, parameters).assignments == serial.assignments);
+
+	comp6771::parallel::set_thread_count(4);
+	auto const threaded = comp6771::kmeans(points, 5, parameters);
+	CHECK(threaded.assignments == serial.assignments);
+	CHECK(threaded.inertia == serial.inertia);
+	for (std::size_t c = 0; c < serial.centroids.size(); ++c) {
+		CHECK(threaded.centroids[c] == serial.centroids[c]);
+	}
+}
+
+TEST_CASE("kmeans takes batches in either layout") {
+	auto const points = blobs(3, 100, 5, 4);
+	auto const layout = GENERATE(comp6771::batch_layout::row_major, comp6771::batch_layout::column_major);
+	auto const from_batch = comp6771::kmeans(comp6771::euclidean_vector_batch(points, layout), 3);
+	auto const from_vectors = comp6771::kmeans(points, 3);
+	CHECK(from_batch.assignments == from_vectors.assignments);
+	CHECK(recovers_blobs(from_batch, 3, 100));
+}
+
+TEST_CASE("kmeans edge cases") {
+	auto const points = blobs(2, 10, 2, 5);
+
+	SECTION("one cluster is the mean") {
+		auto const result = comp6771::kmeans(points, 1);
+		auto mean = comp6771::euclidean_vector(2);
+		for (auto const& p : points) {
+			mean += p;
+		}
+		mean /= static_cast<double>(points.size());
+		CHECK(result.centroids[0][0] == Approx(mean[0]));
+		CHECK(result.centroids[0][1] == Approx(mean[1]));
+	}
+
+	SECTION("as many clusters as points puts each point alone") {
+		auto const result = comp6771::kmeans(points, 20);
+		CHECK(result.inertia == Approx(0.0).margin(1e-12));
+		CHECK(std::set<int>(result.assignments.begin(), result.assignments.end()).size() == 20);
+	}
+
+	SECTION("duplicate points") {
+		auto const same = std::vector<comp6771::euclidean_vector>(8, comp6771::euclidean_vector{1.0, 2.0});
+		auto const result = comp6771::kmeans(same, 3);
+		CHECK(result.inertia == 0.0);
+	}
+
+	SECTION("errors") {
+		CHECK_THROWS_WITH(comp6771::kmeans(points, 0), "Cluster count 0 is not valid for 20 points");
+		CHECK_THROWS_WITH(comp6771::kmeans(points, 21), "Cluster count 21 is not valid for 20 points");
+		CHECK_THROWS_WITH(comp6771::kmeans(std::vector<comp6771::euclidean_vector>{}, 1),
+		                  "Cluster count 1 is not valid for 0 points");
+		auto mixed = points;
+		mixed.push_back(comp6771::euclidean_vector(3));
+		CHECK_THROWS_WITH(comp6771::kmeans(mixed, 2), "Dimensions of LHS(2) and RHS(3) do not match");
+	}
+}
@@ -0,0 +1,113 @@
+#include "comp6771/knn_index.hpp"
+#include "comp6771/euclidean_vector_parallel.hpp"
+#include "test_vectors.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using comp6771::test::random_vectors;
+
+namespace {
+	struct parallel_settings {
+		~parallel_settings() {
+			comp6771::parallel::set_thread_count(1);
+		}
+	};
+
+	//The definition, written with the public operators.
+	std::vector<comp6771::neighbour> reference(std::vector<comp6771::euclidean_vector> const& vectors,
+	                                           comp6771::euclidean_vector const& query,
+	                                           comp6771::distance_metric const metric, int const k) {
+		auto all = std::vector<comp6771::neighbour>();
+		for (auto i = 0; i < static_cast<int>(vectors.size()); ++i) {
+			auto const& v = vectors[static_cast<std::size_t>(i)];
+			switch (metric) {
+			case comp6771::distance_metric::l2:
+				all.push_back({i, comp6771::dot(v - query, v - query)});
+				break;
+			case comp6771::distance_metric::inner_product:
+				all.push_back({i, comp6771::dot(v, query)});
+				break;
+			case comp6771::distance_metric::cosine:
+				all.push_back({i, comp6771::dot(v, query) / std::sqrt(comp6771::dot(v, v) * comp6771::dot(query, query))});
+				break;
+			}
+		}
+		auto const sign = metric == comp6771::distance_metric::l2 ? 1.0 : -1.0;
+		std::stable_sort(all.begin(), all.end(), [&](auto const& a, auto const& b) { return sign * a.score < sign * b.score; });
+		all.resize(static_cast<std::size_t>(std::min(k, static_cast<int>(all.size()))));
+		return all;
+	}
+
+	void check_same(std::vector<comp6771::neighbour> const& actual, std::vector<comp6771::neighbour> const& expected) {
+		REQUIRE(actual.size() == expected.size());
+		for (std::size_t i = 0; i < actual.size(); ++i) {
+			CHECK(actual[i].index == expected[i].index);
+			CHECK(actual[i].score == Approx(expected[i].score).margin(1e-12));
+		}
+	}
+} // namespace
+
+TEST_CASE("Searches are exact for every metric") {
+	auto const metric = GENERATE(comp6771::distance_metric::l2, comp6771::distance_metric::inner_product,
+	                             comp6771::distance_metric::cosine);
+	auto const vectors = random_vectors(500, 13, 1);
+	auto const queries = random_vectors(4, 13, 2);
+	auto const index = comp6771::knn_index(vectors, metric);
+	CHECK(index.size() == 500);
+	CHECK(index.dimensions() == 13);
+	CHECK(index.metric() == metric);
+
+	for (auto const& query : queries) {
+		check_same(index.search(query, 10), reference(vectors, query, metric, 10));
+	}
+	auto const results = index.search_batch(comp6771::euclidean_vector_batch(queries, comp6771::batch_layout::column_major), 7);
+	REQUIRE(results.size() == queries.size());
+	for (std::size_t q = 0; q < queries.size(); ++q) {
+		check_same(results[q], reference(vectors, queries[q], metric, 7));
+	}
+}
+
+TEST_CASE("Threads change nothing about the results") {
+	auto const settings = parallel_settings();
+	auto const vectors = random_vectors(20'000, 8, 3);
+	//Duplicates tie on score, and must still come back in index order.
+	auto batch = comp6771::euclidean_vector_batch(vectors);
+	batch.set_row(19'999, vectors[5]);
+	batch.set_row(10'000, vectors[5]);
+	auto const index = comp6771::knn_index(batch);
+	auto const queries = comp6771::euclidean_vector_batch(random_vectors(16, 8, 4));
+
+	auto const serial = index.search(vectors[5], 25);
+	auto const serial_batch = index.search_batch(queries, 25);
+	CHECK(serial[0] == comp6771::neighbour{5, 0.0});
+	CHECK(serial[1] == comp6771::neighbour{10'000, 0.0});
+	CHECK(serial[2] == comp6771::neighbour{19'999, 0.0});
+
+	comp6771::parallel::set_thread_count(4);
+	CHECK(index.search(vectors[5], 25) == serial);
+	CHECK(index.search_batch(queries, 25) == serial_batch);
+}
+
+TEST_CASE("Searches check their arguments") {
+	auto const index = comp6771::knn_index(random_vectors(3, 4, 5), comp6771::distance_metric::cosine);
+	CHECK(index.search(comp6771::euclidean_vector{1, 0, 0, 0}, 10).size() == 3);
+	CHECK(index.search(comp6771::euclidean_vector{1, 0, 0, 0}, 0).empty());
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector(3), 1), "Dimensions of LHS(4) and RHS(3) do not match");
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector(4), 1),
+	                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+	CHECK_THROWS_WITH(comp6771::knn_index(comp6771::euclidean_vector_batch(2, 4), comp6771::distance_metric::cosine),
+	                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+}
+
+TEST_CASE("Cosine accepts vectors with a tiny but nonzero norm") {
+	auto rows = random_vectors(20, 4, 6);
+	rows[7] = comp6771::euclidean_vector{3e-5, 4e-5, 0, 0};
+	auto const index = comp6771::knn_index(rows, comp6771::distance_metric::cosine);
+	auto const found = index.search(comp6771::euclidean_vector{3e-7, 4e-7, 0, 0}, 1);
+	REQUIRE(found.size() == 1);
+	CHECK(found[0].index == 7);
+	CHECK(found[0].score == Approx(1.0));
+}
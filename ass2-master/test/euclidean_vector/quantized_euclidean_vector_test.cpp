@@ -0,0 +1,115 @@
+#include "comp6771/quantized_euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+	comp6771::euclidean_vector random_vector(std::mt19937& engine, int const dimensions) {
+		auto distribution = std::normal_distribution<double>(0.5, 2.0);
+		auto v = comp6771::euclidean_vector(dimensions);
+		for (auto i = 0; i < dimensions; ++i) {
+			v[i] = distribution(engine);
+		}
+		return v;
+	}
+
+	double exact_squared_distance(comp6771::euclidean_vector const& a, comp6771::euclidean_vector const& b) {
+		auto const d = comp6771::euclidean_vector(a - b);
+		return comp6771::dot(d, d);
+	}
+} // namespace
+
+TEST_CASE("Quantizing keeps every magnitude within max_error") {
+	auto const v = comp6771::euclidean_vector{-2, -0.5, 0, 1, 6};
+	auto const mode = GENERATE(comp6771::calibration::min_max, comp6771::calibration::symmetric);
+
+	auto const q = comp6771::quantized_euclidean_vector(v, mode);
+	auto const u = comp6771::uint8_quantized_euclidean_vector(v, mode);
+	CHECK(q.max_error() <= q.scale() / 2 + 1e-12);
+	CHECK(u.max_error() <= u.scale() / 2 + 1e-12);
+	for (auto i = 0; i < v.dimensions(); ++i) {
+		CHECK(std::abs(q[i] - v[i]) <= q.max_error());
+		CHECK(std::abs(u.at(i) - v[i]) <= u.max_error());
+	}
+	CHECK(comp6771::euclidean_vector(q) == comp6771::euclidean_vector{q[0], q[1], q[2], q[3], q[4]});
+	CHECK_THROWS_WITH(q.at(5), "Index 5 is not valid for this euclidean_vector object");
+}
+
+TEST_CASE("Calibration modes pick the documented ranges") {
+	auto const v = comp6771::euclidean_vector{-1, 0, 0, 3};
+	auto const min_max = comp6771::quantized_euclidean_vector(v);
+	CHECK(min_max.scale() == Approx(4.0 / 255));
+	CHECK(min_max.codes().front() == -128);
+	CHECK(min_max.codes().back() == 127);
+
+	auto const symmetric = comp6771::quantized_euclidean_vector(v, comp6771::calibration::symmetric);
+	CHECK(symmetric.offset() == 0);
+	CHECK(symmetric.codes()[1] == 0);
+	CHECK(symmetric[1] == 0);
+	CHECK(symmetric.codes().back() == 127);
+
+	auto const zeros = comp6771::uint8_quantized_euclidean_vector(comp6771::euclidean_vector(6));
+	CHECK(zeros.max_error() == 0);
+	CHECK(comp6771::dot(zeros, zeros) == 0);
+
+	auto const clamped = comp6771::quantized_euclidean_vector(v, 0.01, 0.0);
+	CHECK(clamped[3] == Approx(1.27));
+	CHECK(clamped.max_error() == Approx(3 - 1.27));
+	CHECK_THROWS_WITH(comp6771::quantized_euclidean_vector(v, -1.0, 0.0),
+	                  "Quantization scale must be finite and non-negative, and offset finite");
+	CHECK_THROWS_WITH(comp6771::quantized_euclidean_vector(comp6771::euclidean_vector{1, NAN}),
+	                  "euclidean_vector with non-finite magnitudes can not be quantized");
+}
+
+TEST_CASE("Integer dot and distance stay within the reported bounds") {
+	auto engine = std::mt19937(6771);
+	//Long enough for the vector kernels' blocks and a scalar tail.
+	auto const dimensions = GENERATE(1, 15, 100, 70'001);
+	auto const a = random_vector(engine, dimensions);
+	auto const b = random_vector(engine, dimensions);
+
+	auto const qa = comp6771::quantized_euclidean_vector(a);
+	auto const qb = comp6771::quantized_euclidean_vector(b, comp6771::calibration::symmetric);
+	auto const dot = comp6771::dot(qa, qb);
+	CHECK(std::abs(dot - comp6771::dot(a, b)) <= comp6771::dot_error_bound(qa, qb) * (1 + 1e-9));
+	CHECK(dot == Approx(comp6771::dot(comp6771::euclidean_vector(qa), comp6771::euclidean_vector(qb))));
+
+	auto const distance = comp6771::squared_distance(qa, qb);
+	CHECK(std::abs(distance - exact_squared_distance(a, b))
+	      <= comp6771::squared_distance_error_bound(qa, qb, distance) * (1 + 1e-9));
+
+	auto const ua = comp6771::uint8_quantized_euclidean_vector(a);
+	auto const ub = comp6771::uint8_quantized_euclidean_vector(b);
+	CHECK(std::abs(comp6771::dot(ua, ub) - comp6771::dot(a, b)) <= comp6771::dot_error_bound(ua, ub) * (1 + 1e-9));
+	CHECK_THROWS_WITH(comp6771::dot(qa, comp6771::quantized_euclidean_vector(comp6771::euclidean_vector(dimensions + 1))),
+	                  "Dimensions of LHS(" + std::to_string(dimensions) + ") and RHS(" +
+	                  std::to_string(dimensions + 1) + ") do not match");
+}
+
+TEST_CASE("A batch quantizes row by row or over one shared range") {
+	auto engine = std::mt19937(1);
+	auto rows = std::vector<comp6771::euclidean_vector>();
+	for (auto r = 0; r < 5; ++r) {
+		rows.push_back(random_vector(engine, 33) * (r + 1.0));
+	}
+	auto const layout = GENERATE(comp6771::batch_layout::row_major, comp6771::batch_layout::column_major);
+	auto const batch = comp6771::euclidean_vector_batch(rows, layout);
+
+	auto const separate = comp6771::quantize(batch);
+	REQUIRE(separate.size() == 5);
+	CHECK(separate[0].scale() < separate[4].scale());
+	CHECK(separate[2].codes()[7] == comp6771::quantized_euclidean_vector(rows[2]).codes()[7]);
+
+	auto const shared = comp6771::quantize<std::uint8_t>(batch, comp6771::calibration::min_max,
+	                                                     comp6771::calibration_scope::per_batch);
+	CHECK(shared[0].scale() == shared[4].scale());
+	CHECK(shared[0].offset() == shared[4].offset());
+	//Rows sharing a range take the all-integer distance kernel.
+	auto const distance = comp6771::squared_distance(shared[1], shared[3]);
+	CHECK(distance == Approx(exact_squared_distance(comp6771::euclidean_vector(shared[1]),
+	                                                comp6771::euclidean_vector(shared[3]))));
+	CHECK(std::abs(distance - exact_squared_distance(rows[1], rows[3]))
+	      <= comp6771::squared_distance_error_bound(shared[1], shared[3], distance) * (1 + 1e-9));
+}
@@ -0,0 +1,94 @@
+#include "comp6771/sparse_euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+TEST_CASE("Sparse vectors store only their nonzeros, in index order") {
+	auto const v = comp6771::sparse_euclidean_vector(1'000'000, {{900'000, 2.0}, {3, 1.0}, {50, 0.0}, {3, 4.0}});
+	CHECK(v.dimensions() == 1'000'000);
+	CHECK(v.nonzeros() == 2);
+	CHECK(std::vector<int>(v.indices().begin(), v.indices().end()) == std::vector<int>{3, 900'000});
+	CHECK(std::vector<double>(v.values().begin(), v.values().end()) == std::vector<double>{4.0, 2.0});
+	CHECK(v[3] == 4.0);
+	CHECK(v[4] == 0.0);
+	CHECK(v.at(900'000) == 2.0);
+	CHECK_THROWS_WITH(v.at(1'000'000), "Index 1000000 is not valid for this euclidean_vector object");
+	CHECK_THROWS_WITH((comp6771::sparse_euclidean_vector(3, {{3, 1.0}})),
+	                  "Index 3 is not valid for this euclidean_vector object");
+}
+
+TEST_CASE("set() inserts, overwrites and erases") {
+	auto v = comp6771::sparse_euclidean_vector(10);
+	v.set(7, 1.0);
+	v.set(2, 3.0);
+	v.set(7, 5.0);
+	CHECK(v.nonzeros() == 2);
+	CHECK(v[7] == 5.0);
+	v.set(2, 0.0);
+	CHECK(v.nonzeros() == 1);
+	CHECK(v.indices()[0] == 7);
+}
+
+TEST_CASE("Sparse and dense conversions round-trip") {
+	auto const dense = comp6771::euclidean_vector{0.0, 1.5, 0.0, -2.0};
+	auto const sparse = comp6771::sparse_euclidean_vector(dense);
+	CHECK(sparse.nonzeros() == 2);
+	CHECK(static_cast<comp6771::euclidean_vector>(sparse) == dense);
+
+	auto os = std::ostringstream();
+	os << sparse;
+	CHECK(os.str() == "[0 1.5 0 -2]");
+}
+
+TEST_CASE("Sparse arithmetic matches dense arithmetic") {
+	auto const a = comp6771::sparse_euclidean_vector(6, {{0, 1.0}, {2, 2.0}, {5, -3.0}});
+	auto const b = comp6771::sparse_euclidean_vector(6, {{1, 4.0}, {2, -2.0}, {5, 1.0}});
+	auto const da = static_cast<comp6771::euclidean_vector>(a);
+	auto const db = static_cast<comp6771::euclidean_vector>(b);
+
+	auto const sum = a + b;
+	CHECK(sum.nonzeros() == 3); //index 2 cancels exactly
+	CHECK(static_cast<comp6771::euclidean_vector>(sum) == comp6771::euclidean_vector(da + db));
+	CHECK(static_cast<comp6771::euclidean_vector>(a - b) == comp6771::euclidean_vector(da - db));
+	CHECK(static_cast<comp6771::euclidean_vector>(2.5 * a) == comp6771::euclidean_vector(2.5 * da));
+	CHECK(static_cast<comp6771::euclidean_vector>(a / 2) == comp6771::euclidean_vector(da / 2));
+	CHECK(static_cast<comp6771::euclidean_vector>(-a) == comp6771::euclidean_vector(-da));
+	CHECK((a * 0).nonzeros() == 0);
+	CHECK(a + b - b == a);
+	CHECK_FALSE(a == b);
+
+	CHECK(comp6771::dot(a, b) == Approx(comp6771::dot(da, db)));
+	CHECK(comp6771::dot(a, db) == Approx(comp6771::dot(da, db)));
+	CHECK(comp6771::dot(da, b) == Approx(comp6771::dot(da, db)));
+	CHECK(comp6771::euclidean_norm(a) == Approx(std::sqrt(14.0)));
+	CHECK(comp6771::euclidean_norm(comp6771::unit(a)) == Approx(1.0));
+}
+
+TEST_CASE("Mixed sparse-dense arithmetic gives dense results") {
+	auto const s = comp6771::sparse_euclidean_vector(3, {{1, 2.0}});
+	auto const d = comp6771::euclidean_vector{1.0, 1.0, 1.0};
+	CHECK(d + s == comp6771::euclidean_vector{1.0, 3.0, 1.0});
+	CHECK(s + d == comp6771::euclidean_vector{1.0, 3.0, 1.0});
+	CHECK(d - s == comp6771::euclidean_vector{1.0, -1.0, 1.0});
+	CHECK(s - d == comp6771::euclidean_vector{-1.0, 1.0, -1.0});
+
+	auto acc = comp6771::euclidean_vector{3.0, 4.0, 0.0};
+	acc.maintain_norm(true);
+	REQUIRE(comp6771::euclidean_norm(acc) == Approx(5.0));
+	acc -= s;
+	CHECK(comp6771::euclidean_norm(acc) == Approx(std::sqrt(13.0)));
+}
+
+TEST_CASE("Sparse errors use the euclidean_vector messages") {
+	auto a = comp6771::sparse_euclidean_vector(3);
+	auto const b = comp6771::sparse_euclidean_vector(4);
+	CHECK_THROWS_WITH(a += b, "Dimensions of LHS(3) and RHS(4) do not match");
+	CHECK_THROWS_WITH(comp6771::dot(a, b), "Dimensions of LHS(3) and RHS(4) do not match");
+	CHECK_THROWS_WITH(comp6771::dot(a, comp6771::euclidean_vector(2)), "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(comp6771::euclidean_vector(2) + a, "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(a /= 0, "Invalid vector division by 0");
+	CHECK_THROWS_WITH(comp6771::unit(a), "euclidean_vector with zero euclidean normal does not have a unit vector");
+	CHECK_THROWS_WITH(comp6771::unit(comp6771::sparse_euclidean_vector(0)),
+	                  "euclidean_vector with no dimensions does not have a unit vector");
+}
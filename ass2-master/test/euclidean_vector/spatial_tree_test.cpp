@@ -0,0 +1,118 @@
+#include "comp6771/spatial_tree.hpp"
+#include "comp6771/knn_index.hpp"
+#include "test_vectors.hpp"
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using comp6771::test::random_vectors;
+
+TEMPLATE_TEST_CASE("knn and nearest match an exact knn_index", "", comp6771::kd_tree, comp6771::ball_tree) {
+	auto const dimensions = GENERATE(2, 3, 8, 16);
+	auto const leaf_size = GENERATE(1, 16);
+	//Either on a small integer grid, so many distances tie and the tie order gets exercised, or not.
+	auto const points = GENERATE(as<bool>{}, false, true)
+	                  ? random_vectors(2000, dimensions, 1, std::uniform_int_distribution<int>(-3, 3))
+	                  : random_vectors(2000, dimensions, 1);
+	auto const tree = TestType(points, leaf_size);
+	auto const exact = comp6771::knn_index(points);
+	REQUIRE(tree.size() == 2000);
+	REQUIRE(tree.dimensions() == dimensions);
+
+	for (auto const& query : random_vectors(20, dimensions, 2)) {
+		CHECK(tree.knn(query, 10) == exact.search(query, 10));
+		CHECK(tree.nearest(query) == exact.search(query, 1).front());
+	}
+	CHECK(tree.knn(points[7], 1).front() == comp6771::neighbour{7, 0.0});
+}
+
+TEMPLATE_TEST_CASE("knn clamps k", "", comp6771::kd_tree, comp6771::ball_tree) {
+	auto const points = random_vectors(5, 3, 3);
+	auto const tree = TestType(points);
+	auto const query = comp6771::euclidean_vector(3);
+	CHECK(tree.knn(query, 0).empty());
+	CHECK(tree.knn(query, -1).empty());
+	CHECK(tree.knn(query, 100) == comp6771::knn_index(points).search(query, 5));
+}
+
+TEMPLATE_TEST_CASE("radius returns every point within the radius", "", comp6771::kd_tree, comp6771::ball_tree) {
+	auto const dimensions = GENERATE(2, 5, 12);
+	auto const points = random_vectors(1500, dimensions, 4);
+	auto const tree = TestType(points);
+	auto const exact = comp6771::knn_index(points);
+	auto const radius = GENERATE(0.0, 0.3, 0.8);
+
+	for (auto const& query : random_vectors(10, dimensions, 5)) {
+		auto expected = exact.search(query, exact.size());
+		std::erase_if(expected, [&](auto const& n) { return n.score > radius * radius; });
+		CHECK(tree.radius(query, radius) == expected);
+	}
+	CHECK(tree.radius(points[3], 0.0) == std::vector<comp6771::neighbour>{{3, 0.0}});
+	CHECK(tree.radius(points[3], -1.0).empty());
+}
+
+TEMPLATE_TEST_CASE("box returns the points inside, in index order", "", comp6771::kd_tree, comp6771::ball_tree) {
+	auto const dimensions = GENERATE(2, 4, 10);
+	auto const points = random_vectors(1500, dimensions, 6);
+	auto const tree = TestType(points);
+
+	auto engine = std::mt19937(7);
+	auto distribution = std::uniform_real_distribution<double>(-1.2, 1.2);
+	for (auto trial = 0; trial < 20; ++trial) {
+		auto lower = comp6771::euclidean_vector(dimensions);
+		auto upper = comp6771::euclidean_vector(dimensions);
+		for (auto d = 0; d < dimensions; ++d) {
+			auto const a = distribution(engine);
+			auto const b = distribution(engine);
+			lower[d] = std::min(a, b);
+			upper[d] = std::max(a, b);
+		}
+		auto expected = std::vector<int>();
+		for (auto i = 0; i < static_cast<int>(points.size()); ++i) {
+			auto inside = true;
+			for (auto d = 0; d < dimensions; ++d) {
+				auto const x = points[static_cast<std::size_t>(i)][d];
+				inside = inside and lower[d] <= x and x <= upper[d];
+			}
+			if (inside) {
+				expected.push_back(i);
+			}
+		}
+		CHECK(tree.box(lower, upper) == expected);
+	}
+
+	auto everything = comp6771::euclidean_vector(dimensions, 2.0);
+	auto const all = tree.box(-everything, everything);
+	CHECK(all.size() == points.size());
+	CHECK(std::is_sorted(all.begin(), all.end()));
+}
+
+TEMPLATE_TEST_CASE("trees build from a batch in either layout", "", comp6771::kd_tree, comp6771::ball_tree) {
+	auto const points = random_vectors(300, 3, 8);
+	auto const layout = GENERATE(comp6771::batch_layout::row_major, comp6771::batch_layout::column_major);
+	auto const tree = TestType(comp6771::euclidean_vector_batch(points, layout));
+	auto const exact = comp6771::knn_index(points);
+	for (auto const& query : random_vectors(5, 3, 9)) {
+		CHECK(tree.knn(query, 5) == exact.search(query, 5));
+	}
+}
+
+TEMPLATE_TEST_CASE("spatial tree errors", "", comp6771::kd_tree, comp6771::ball_tree) {
+	auto const tree = TestType(random_vectors(10, 3, 10));
+	auto const wrong = comp6771::euclidean_vector(2);
+	auto const right = comp6771::euclidean_vector(3);
+	CHECK_THROWS_WITH(tree.knn(wrong, 1), "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(tree.radius(wrong, 1.0), "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(tree.box(right, wrong), "Dimensions of LHS(3) and RHS(2) do not match");
+
+	auto mixed = random_vectors(3, 3, 11);
+	mixed.push_back(wrong);
+	CHECK_THROWS_WITH(TestType(mixed), "Dimensions of LHS(3) and RHS(2) do not match");
+
+	auto const empty = TestType(std::vector<comp6771::euclidean_vector>{});
+	CHECK(empty.size() == 0);
+	CHECK(empty.knn(comp6771::euclidean_vector(0), 3).empty());
+	CHECK_THROWS_AS(empty.nearest(comp6771::euclidean_vector(0)), comp6771::euclidean_vector_error);
+}
@@ -0,0 +1,28 @@
+#ifndef COMP6771_TEST_VECTORS_HPP
+#define COMP6771_TEST_VECTORS_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace comp6771::test {
+	//`count` vectors of `dimensions` magnitudes drawn from `distribution`, the same ones for the
+	//same seed. Uniform over [-1, 1) unless the test needs something else.
+	template<typename Distribution = std::uniform_real_distribution<double>>
+	std::vector<euclidean_vector> random_vectors(int const count, int const dimensions, unsigned const seed,
+	                                             Distribution distribution = Distribution(-1.0, 1.0)) {
+		auto engine = std::mt19937(seed);
+		auto result = std::vector<euclidean_vector>();
+		for (auto i = 0; i < count; ++i) {
+			auto v = euclidean_vector(dimensions);
+			for (auto d = 0; d < dimensions; ++d) {
+				v[d] = static_cast<double>(distribution(engine));
+			}
+			result.push_back(std::move(v));
+		}
+		return result;
+	}
+} // namespace comp6771::test
+
+#endif // COMP6771_TEST_VECTORS_HPP